@@ -0,0 +1,343 @@
+#include "iota_streams/channels.h"
+#include <stdio.h>
+#include <time.h>
+
+// Benchmarks of the channels API as seen from C. Each operation is timed call by call and reported
+// as throughput along with p50/p99 latency. Runs over the offline bucket transport, or over the node
+// at `URL` when built with `SYNC_CLIENT`.
+//
+// Environment variables:
+// - `URL`: node to use when built with `SYNC_CLIENT`
+// - `ITERATIONS`: number of timed calls per case (default 100)
+// - `SYNC_MESSAGES`: comma separated message counts for `sub_sync_state` (default 10,100)
+
+static size_t const payload_sizes[] = { 32, 1024, 16384 };
+static size_t const subscriber_counts[] = { 1, 10, 50 };
+
+static size_t iterations = 100;
+static transport_t *tsp = NULL;
+
+static double now_us()
+{
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static int cmp_double(void const *a, void const *b)
+{
+  double x = *(double const *)a;
+  double y = *(double const *)b;
+  return (x > y) - (x < y);
+}
+
+// Report `count` latency samples in microseconds, each one covering `ops` operations.
+static void report(char const *name, char const *params, double *samples, size_t count, size_t ops)
+{
+  double total = 0;
+  size_t i;
+  if(!count) return;
+  for(i = 0; i < count; ++i)
+    total += samples[i];
+  qsort(samples, count, sizeof(double), cmp_double);
+  printf("%-24s %-20s %8zu  %12.1f ops/s  p50 %10.1f us  p99 %10.1f us\n",
+    name, params, count,
+    total > 0 ? (double)(count * ops) * 1e6 / total : 0.0,
+    samples[count / 2],
+    samples[(count * 99) / 100 < count ? (count * 99) / 100 : count - 1]);
+}
+
+// Seeds are unique per run and per user, so that channels do not collide on a shared node.
+static void gen_seed(char *seed, size_t n, char const *role, size_t index)
+{
+  static unsigned long run = 0;
+  if(!run) run = (unsigned long)time(NULL);
+  snprintf(seed, n, "bench %lu %s %zu", run, role, index);
+}
+
+typedef struct Channel {
+  author_t *auth;
+  address_t const *ann_link;
+  subscriber_t **subs;
+  size_t subs_count;
+} channel_t;
+
+static void channel_drop(channel_t *ch)
+{
+  size_t i;
+  for(i = 0; i < ch->subs_count; ++i)
+    sub_drop(ch->subs[i]);
+  free(ch->subs);
+  drop_address(ch->ann_link);
+  auth_drop(ch->auth);
+  memset(ch, 0, sizeof(*ch));
+}
+
+// Announce a new channel and subscribe `subs_count` subscribers to it.
+static err_t channel_new(channel_t *ch, size_t subs_count)
+{
+  static size_t channels = 0;
+  char seed[64];
+  err_t e = ERR_OK;
+  size_t i;
+
+  memset(ch, 0, sizeof(*ch));
+  gen_seed(seed, sizeof(seed), "author", channels++);
+  e = auth_new(&ch->auth, seed, 0, tsp);
+  if(e) return e;
+  e = auth_send_announce(&ch->ann_link, ch->auth);
+  if(e) return e;
+
+  ch->subs = calloc(subs_count ? subs_count : 1, sizeof(subscriber_t *));
+  if(!ch->subs) return ERR_OPERATION_FAILED;
+  for(i = 0; i < subs_count; ++i)
+  {
+    address_t const *sub_link = NULL;
+    gen_seed(seed, sizeof(seed), "subscriber", channels * 1000 + i);
+    e = sub_new(&ch->subs[i], seed, tsp);
+    if(e) return e;
+    ch->subs_count = i + 1;
+    e = sub_receive_announce(ch->subs[i], ch->ann_link);
+    if(!e) e = sub_send_subscribe(&sub_link, ch->subs[i], ch->ann_link);
+    if(!e) e = auth_receive_subscribe(ch->auth, sub_link);
+    drop_address(sub_link);
+    if(e) return e;
+  }
+  return e;
+}
+
+static err_t bench_keyload(double *samples)
+{
+  err_t e = ERR_OK;
+  size_t s, i;
+  char params[32];
+
+  for(s = 0; s < sizeof(subscriber_counts) / sizeof(subscriber_counts[0]); ++s)
+  {
+    channel_t ch;
+    e = channel_new(&ch, subscriber_counts[s]);
+    for(i = 0; !e && i < iterations; ++i)
+    {
+      message_links_t links = { NULL, NULL };
+      double start = now_us();
+      e = auth_send_keyload_for_everyone(&links, ch.auth, ch.ann_link);
+      samples[i] = now_us() - start;
+      drop_links(links);
+    }
+    channel_drop(&ch);
+    if(e) return e;
+    snprintf(params, sizeof(params), "subscribers=%zu", subscriber_counts[s]);
+    report("auth_send_keyload", params, samples, iterations, 1);
+  }
+  return e;
+}
+
+static err_t bench_packets(double *samples, uint8_t *payload, uint8_t is_signed)
+{
+  err_t e = ERR_OK;
+  size_t p, i;
+  char params[32];
+
+  for(p = 0; p < sizeof(payload_sizes) / sizeof(payload_sizes[0]); ++p)
+  {
+    channel_t ch;
+    message_links_t prev = { NULL, NULL };
+    e = channel_new(&ch, 1);
+    if(!e) e = auth_send_keyload_for_everyone(&prev, ch.auth, ch.ann_link);
+    for(i = 0; !e && i < iterations; ++i)
+    {
+      message_links_t links = { NULL, NULL };
+      double start = now_us();
+      e = is_signed
+        ? auth_send_signed_packet(&links, ch.auth, prev, payload, payload_sizes[p], payload, payload_sizes[p])
+        : auth_send_tagged_packet(&links, ch.auth, prev, payload, payload_sizes[p], payload, payload_sizes[p]);
+      samples[i] = now_us() - start;
+      drop_links(prev);
+      prev = links;
+    }
+    drop_links(prev);
+    channel_drop(&ch);
+    if(e) return e;
+    snprintf(params, sizeof(params), "payload=%zu", payload_sizes[p]);
+    report(is_signed ? "auth_send_signed_packet" : "auth_send_tagged_packet", params, samples, iterations, 1);
+  }
+  return e;
+}
+
+// Time `sub_sync_state` of a subscriber catching up with `messages` packets, the author having sent
+// a keyload for everyone first. Results are allocated in `arena` unless it is null.
+static err_t bench_sync(double *samples, uint8_t *payload, size_t messages, streams_arena_t *arena)
+{
+  err_t e = ERR_OK;
+  size_t runs = iterations / messages ? iterations / messages : 1;
+  size_t r, i;
+  char params[32];
+
+  for(r = 0; !e && r < runs; ++r)
+  {
+    channel_t ch;
+    message_links_t prev = { NULL, NULL };
+    unwrapped_messages_t const *umsgs = NULL;
+    e = channel_new(&ch, 1);
+    if(!e) e = auth_send_keyload_for_everyone(&prev, ch.auth, ch.ann_link);
+    for(i = 0; !e && i < messages; ++i)
+    {
+      message_links_t links = { NULL, NULL };
+      e = auth_send_tagged_packet(&links, ch.auth, prev, payload, payload_sizes[0], payload, payload_sizes[0]);
+      drop_links(prev);
+      prev = links;
+    }
+    if(!e)
+    {
+      double start = now_us();
+      e = arena ? sub_sync_state_in(&umsgs, ch.subs[0], arena) : sub_sync_state(&umsgs, ch.subs[0]);
+      samples[r] = now_us() - start;
+      if(!e && get_payloads_count(umsgs) < messages) e = ERR_OPERATION_FAILED;
+    }
+    if(arena) arena_reset(arena);
+    else drop_unwrapped_messages(umsgs);
+    drop_links(prev);
+    channel_drop(&ch);
+  }
+  if(e) return e;
+  snprintf(params, sizeof(params), "messages=%zu", messages);
+  report(arena ? "sub_sync_state_in" : "sub_sync_state", params, samples, runs, messages);
+  return e;
+}
+
+static err_t bench_export_import(double *export_samples, double *import_samples)
+{
+  err_t e = ERR_OK;
+  size_t s, i;
+  char params[32];
+
+  for(s = 0; s < sizeof(subscriber_counts) / sizeof(subscriber_counts[0]); ++s)
+  {
+    channel_t ch;
+    message_links_t links = { NULL, NULL };
+    e = channel_new(&ch, subscriber_counts[s]);
+    if(!e) e = auth_send_keyload_for_everyone(&links, ch.auth, ch.ann_link);
+    drop_links(links);
+    for(i = 0; !e && i < iterations; ++i)
+    {
+      buffer_t bytes = { NULL, 0, 0 };
+      author_t *imported = NULL;
+      double start = now_us();
+      e = auth_export(&bytes, ch.auth, "bench password");
+      export_samples[i] = now_us() - start;
+      if(e) break;
+      start = now_us();
+      e = auth_import(&imported, bytes, "bench password", tsp);
+      import_samples[i] = now_us() - start;
+      // auth_import consumes bytes
+      if(!e) bytes.ptr = NULL;
+      auth_drop(imported);
+      drop_buffer(bytes);
+    }
+    channel_drop(&ch);
+    if(e) return e;
+    snprintf(params, sizeof(params), "subscribers=%zu", subscriber_counts[s]);
+    report("auth_export", params, export_samples, iterations, 1);
+    report("auth_import", params, import_samples, iterations, 1);
+  }
+  return e;
+}
+
+int main()
+{
+  err_t e = ERR_OK;
+  double *samples = NULL;
+  double *samples2 = NULL;
+  uint8_t *payload = NULL;
+  char const *env = NULL;
+  size_t max_payload = payload_sizes[sizeof(payload_sizes) / sizeof(payload_sizes[0]) - 1];
+
+  env = getenv("ITERATIONS");
+  if(env && atoi(env) > 0) iterations = (size_t)atoi(env);
+
+#ifdef IOTA_STREAMS_CHANNELS_CLIENT
+  char const *env_url = getenv("URL");
+  char const *url = env_url ? env_url : "https://chrysalis-nodes.iota.org";
+  printf("Using node: %s\n\n", url);
+  tsp = transport_client_new_from_url(url);
+#else
+  printf("Using bucket transport (offline)\n\n");
+  tsp = transport_new();
+#endif
+
+  samples = calloc(iterations, sizeof(double));
+  samples2 = calloc(iterations, sizeof(double));
+  payload = malloc(max_payload);
+  if(!tsp || !samples || !samples2 || !payload)
+  {
+    e = ERR_OPERATION_FAILED;
+    goto cleanup;
+  }
+  memset(payload, 0x5a, max_payload);
+
+  printf("%-24s %-20s %8s  %18s  %16s  %16s\n", "operation", "parameters", "samples", "throughput", "latency", "latency");
+
+  e = bench_packets(samples, payload, 1);
+  if(e) goto cleanup;
+  e = bench_packets(samples, payload, 0);
+  if(e) goto cleanup;
+  e = bench_keyload(samples);
+  if(e) goto cleanup;
+
+  {
+    char counts[64] = "10,100";
+    char *count = NULL;
+    streams_arena_t *arena = arena_new();
+    env = getenv("SYNC_MESSAGES");
+    if(env) snprintf(counts, sizeof(counts), "%s", env);
+    for(count = strtok(counts, ","); !e && count; count = strtok(NULL, ","))
+      if(atoi(count) > 0)
+      {
+        e = bench_sync(samples, payload, (size_t)atoi(count), NULL);
+        if(!e) e = bench_sync(samples, payload, (size_t)atoi(count), arena);
+      }
+    arena_drop(arena);
+    if(e) goto cleanup;
+  }
+
+  e = bench_export_import(samples, samples2);
+
+#ifdef IOTA_STREAMS_CHANNELS_CLIENT
+  // Sends return once queued, messages not submitted yet are read back from the cache
+  if(!e) e = transport_enable_cache(tsp, 4096, NULL);
+  if(!e) e = transport_enable_send_queue(tsp, 256, 16);
+  if(!e)
+  {
+    send_queue_stats_t stats;
+    printf("\nWith send queue (depth 256, up to 16 sends in flight)\n");
+    e = bench_packets(samples, payload, 0);
+    if(!e) e = transport_get_send_queue_stats(&stats, NULL, tsp);
+    if(!e) printf("Queued %zu, in flight %zu, concurrency %zu\n", stats.queued, stats.in_flight, stats.concurrency);
+    if(!e) e = transport_flush_sends(NULL, tsp);
+  }
+#endif
+
+#ifdef IOTA_STREAMS_CHANNELS_METRICS
+  if(!e)
+  {
+    metrics_t m;
+    e = streams_metrics_snapshot(&m);
+    if(e) goto cleanup;
+    printf("\nPhase totals: wrap %llu calls %.1f ms, sign %llu calls %.1f ms, verify %llu calls %.1f ms\n",
+      (unsigned long long)m.wrap.calls, m.wrap.total_ns / 1e6,
+      (unsigned long long)m.sign.calls, m.sign.total_ns / 1e6,
+      (unsigned long long)m.verify.calls, m.verify.total_ns / 1e6);
+    printf("Cache hits %llu, misses %llu, bytes in %llu, out %llu\n",
+      (unsigned long long)m.cache_hits, (unsigned long long)m.cache_misses,
+      (unsigned long long)m.bytes_in, (unsigned long long)m.bytes_out);
+  }
+#endif
+
+cleanup:
+  if(e) printf("Benchmark failed: error %d\n", (int)e);
+  free(payload);
+  free(samples2);
+  free(samples);
+  transport_drop(tsp);
+  return (e == ERR_OK ? 0 : 1);
+}
@@ -17,6 +17,22 @@ typedef struct Address address_t;
 extern void drop_address(address_t const *);
 extern address_t *address_from_string(char const *addr_str);
 
+// Binary form of an address: application instance followed by message id
+#define IOTA_STREAMS_ADDRESS_SIZE 52
+// Hex encoded Tangle index of an address, including the terminating null
+#define IOTA_STREAMS_ADDRESS_INDEX_SIZE 65
+extern err_t address_to_bytes(uint8_t bytes[IOTA_STREAMS_ADDRESS_SIZE], address_t const *address);
+extern err_t address_from_bytes(address_t const **address, uint8_t const bytes[IOTA_STREAMS_ADDRESS_SIZE]);
+// Hash and order of the binary form, usable as keys of C containers; the hash is stable across processes
+extern uint64_t address_hash(address_t const *address);
+extern int address_cmp(address_t const *a, address_t const *b);
+
+typedef struct Addresses addresses_t;
+extern void drop_addresses(addresses_t const *);
+extern size_t get_addresses_count(addresses_t const *addresses);
+// The address is owned by addresses and valid until they are dropped
+extern address_t const *get_indexed_address(addresses_t const *addresses, size_t index);
+
 typedef struct ChannelAddress channel_address_t;
 typedef struct MsgId msgid_t;
 typedef struct PublicKey public_key_t;
@@ -30,12 +46,23 @@ extern void drop_next_msg_ids(next_msg_ids_t const *);
 typedef struct UserState user_state_t;
 extern void drop_user_state(user_state_t const *);
 
+typedef struct StateJournal state_journal_t;
+extern void drop_state_journal(state_journal_t *);
+
 typedef struct UnwrappedMessage unwrapped_message_t;
 extern void drop_unwrapped_message(unwrapped_message_t const *);
 
 typedef struct UnwrappedMessages unwrapped_messages_t;
 extern void drop_unwrapped_messages(unwrapped_messages_t const *);
 
+// Storage for results of the fetch and sync calls ending in `_in`. Such results are released all
+// at once by arena_reset, which keeps the storage for later calls; they must not be dropped
+// individually and are only valid until the next reset.
+typedef struct Arena streams_arena_t;
+extern streams_arena_t *arena_new();
+extern void arena_reset(streams_arena_t *arena);
+extern void arena_drop(streams_arena_t *arena);
+
 typedef struct MessageLinks {
   address_t const *msg_link;
   address_t const *seq_link;
@@ -51,6 +78,12 @@ typedef struct Buffer {
 
 extern void drop_buffer(buffer_t);
 
+// Streamed export and import: state is handed over in chunks rather than as one buffer. Writers
+// return 0 once a chunk is taken; readers store the number of bytes written, at most `cap`, and 0
+// once the state has been read, returning 0 on success.
+typedef int (*stream_write_cb)(void *ctx, uint8_t const *chunk, size_t len);
+typedef int (*stream_read_cb)(void *ctx, uint8_t *buf, size_t cap, size_t *read);
+
 typedef struct PacketPayloads {
   buffer_t public_payload;
   buffer_t masked_payload;
@@ -61,11 +94,68 @@ extern void drop_payloads(packet_payloads_t);
 ////////////
 /// Transport
 ////////////
+// With the `std` feature a transport may be shared by users living on different threads:
+// node client users share its connections, bucket users only contend on links of the same shard.
+// Configure the transport before sharing it, users copy its options when created.
 typedef struct Transport transport_t;
 extern transport_t *transport_new();
 extern void transport_drop(transport_t *);
 #ifdef IOTA_STREAMS_CHANNELS_CLIENT
 extern transport_t *transport_client_new_from_url(char const *url);
+// Requests are spread over the nodes, favouring fast and healthy ones; failed reads are retried on
+// the other nodes. Returns NULL if any of the urls is invalid.
+extern transport_t *transport_client_new_from_urls(char const *const *urls, size_t urls_count);
+
+typedef struct NodeStats {
+  uint64_t latency_us;
+  uint64_t requests;
+  uint64_t failures;
+  uint32_t consecutive_failures;
+} node_stats_t;
+
+extern size_t transport_node_count(transport_t const *transport);
+extern err_t transport_get_node_stats(node_stats_t *stats, transport_t const *transport, size_t index);
+// Applies to users created from the transport afterwards
+extern err_t transport_set_fetch_concurrency(transport_t *transport, size_t max_concurrent_fetches);
+// Background requests of the transport and of all the users created from it run on their own pool
+// of the given number of threads, 0 goes back to the pool shared by the process (4 per CPU). Each
+// request in flight occupies a thread, so this bounds the sends and fetches in flight.
+extern err_t transport_set_executor_threads(transport_t const *transport, size_t threads);
+// Keep the messages of up to max_links links in a cache shared with users created afterwards, 0 disables
+// it. This is a link-count limit: a link may hold several messages and the byte size is not bounded.
+// backing_file may be NULL; otherwise it is loaded now and saved on flush and drop.
+extern err_t transport_enable_cache(transport_t *transport, size_t max_links, char const *backing_file);
+extern err_t transport_cache_flush(transport_t const *transport);
+
+// Sends of users created afterwards return once queued, blocking while depth messages are queued
+// or in flight. Up to max_concurrent_sends are submitted at once, fewer while the node slows down.
+// Reads through the transport serve queued messages until they are submitted; reads through other
+// transports, and other processes, only see them once submitted.
+// Failures are reported by transport_flush_sends, which waits for the queue to drain.
+extern err_t transport_enable_send_queue(transport_t *transport, size_t depth, size_t max_concurrent_sends);
+// Fails if any send failed since the last flush. failed may be NULL, otherwise it receives the
+// links of the failed messages, to be dropped with drop_addresses. Failed messages are not resent.
+extern err_t transport_flush_sends(addresses_t const **failed, transport_t const *transport);
+
+typedef struct SendQueueStats {
+  size_t queued;
+  size_t in_flight;
+  size_t concurrency;
+  size_t depth;
+  size_t failed;
+} send_queue_stats_t;
+
+// Sends block once queued + in_flight reaches depth. failed_links may be NULL, otherwise it receives
+// the links of the sends failed since the last flush, to be dropped with drop_addresses.
+extern err_t transport_get_send_queue_stats(send_queue_stats_t *stats, addresses_t const **failed_links, transport_t const *transport);
+#endif
+
+#ifdef IOTA_STREAMS_CHANNELS_MQTT
+// Next messages are retrieved once announced through node events, and every fallback_interval_ms
+// regardless. Applies to users created from the transport afterwards.
+extern err_t transport_enable_events(transport_t *transport, uint64_t fallback_interval_ms);
+// Blocks until a next message of a user is announced or the timeout has passed
+extern err_t transport_wait_for_arrival(uint8_t *arrived, transport_t const *transport, uint64_t timeout_ms);
 #endif
 
 #ifdef IOTA_STREAMS_CHANNELS_CLIENT
@@ -102,6 +192,50 @@ typedef struct TransportDetails {
 extern err_t transport_get_link_details(transport_details_t *details, transport_t *transport, address_t const *link);
 #endif
 
+#ifdef IOTA_STREAMS_CHANNELS_CLIENT
+// Requests run in the background on an executor shared by the transport and its users
+typedef struct Request request_t;
+
+typedef enum RequestState {
+  REQUEST_PENDING,
+  REQUEST_READY,
+  REQUEST_FAILED,
+} request_state_t;
+
+extern request_state_t streams_poll(request_t *req);
+extern request_state_t streams_wait(request_t *req);
+extern void drop_request(request_t *req);
+
+extern err_t transport_fetch_msg_async(request_t **req, transport_t *transport, address_t const *link);
+#endif
+
+#ifdef IOTA_STREAMS_CHANNELS_METRICS
+typedef struct PhaseMetrics {
+  uint64_t calls;
+  uint64_t total_ns;
+  uint64_t max_ns;
+} phase_metrics_t;
+
+// Phases may nest: wrap includes sign, unwrap includes verify of signatures checked inline
+typedef struct Metrics {
+  phase_metrics_t wrap;
+  phase_metrics_t sign;
+  phase_metrics_t send;
+  phase_metrics_t index_lookup;
+  phase_metrics_t fetch;
+  phase_metrics_t unwrap;
+  phase_metrics_t verify;
+  uint64_t cache_hits;
+  uint64_t cache_misses;
+  uint64_t bytes_in;
+  uint64_t bytes_out;
+} metrics_t;
+
+// Figures are process wide, since the last reset
+extern err_t streams_metrics_snapshot(metrics_t *metrics);
+extern void streams_metrics_reset();
+#endif
+
 ////////////
 /// Author
 ////////////
@@ -109,10 +243,18 @@ typedef struct Author author_t;
 
 extern err_t auth_new(author_t **auth, char const *seed, uint8_t implementation, transport_t *transport);
 extern err_t auth_recover(author_t **auth, char const *seed, address_t const *announcement, uint8_t implementation, transport_t *transport);
+// Restores the state exported by auth_export with the seed as password and replays only later messages
+extern err_t auth_recover_from_checkpoint(author_t **auth, char const *seed, buffer_t checkpoint, transport_t *transport);
 extern void auth_drop(author_t *);
 
 extern err_t auth_import(author_t **auth, buffer_t buffer, char const *password, transport_t *transport);
 extern err_t auth_export(buffer_t *buf, author_t const *user, char const *password);
+extern err_t auth_export_to_writer(author_t const *user, char const *password, stream_write_cb write, void *ctx);
+extern err_t auth_import_from_reader(author_t **auth, stream_read_cb read, void *ctx, char const *password, transport_t *transport);
+// Appends later state changes to the journal file on each auth_journal_sync, compacting it as it grows
+extern err_t auth_journal_create(state_journal_t **journal, author_t const *user, char const *path, char const *password);
+extern err_t auth_journal_open(author_t **auth, state_journal_t **journal, char const *path, char const *password, transport_t *transport);
+extern err_t auth_journal_sync(state_journal_t *journal, author_t const *user);
 
 extern err_t auth_channel_address(channel_address_t const **addr, author_t const *user);
 extern err_t auth_is_multi_branching(uint8_t *flag, author_t const *user);
@@ -130,21 +272,57 @@ extern err_t auth_receive_subscribe(author_t *author, address_t const *address);
 // Tagged Packets
 extern err_t auth_send_tagged_packet(message_links_t *links, author_t *author, message_links_t link_to, uint8_t const *public_payload_ptr, size_t public_payload_size, uint8_t const *masked_payload_ptr, size_t masked_payload_size);
 extern err_t auth_receive_tagged_packet(packet_payloads_t *payloads, author_t *author, address_t const *address);
+// Zero-copy variant: payloads are decrypted into the given buffers, fails if either does not fit
+extern err_t auth_receive_tagged_packet_into(size_t *public_len, size_t *masked_len, author_t *author, address_t const *address, uint8_t *public_buf, size_t public_cap, uint8_t *masked_buf, size_t masked_cap);
+// Chain of Tagged Packets: `links` must have room for `payloads_count` entries
+extern err_t auth_send_tagged_packets_batch(message_links_t *links, author_t *author, message_links_t link_to, packet_payloads_t const *payloads, size_t payloads_count);
 // Signed Packets
 extern err_t auth_send_signed_packet(message_links_t *links, author_t *author, message_links_t link_to, uint8_t const *public_payload_ptr, size_t public_payload_size, uint8_t const *masked_payload_ptr, size_t masked_payload_size);
 extern err_t auth_receive_signed_packet(packet_payloads_t *payloads, author_t *author, address_t const *address) ;
+// Zero-copy variant: payloads are decrypted into the given buffers, fails if either does not fit
+extern err_t auth_receive_signed_packet_into(size_t *public_len, size_t *masked_len, author_t *author, address_t const *address, uint8_t *public_buf, size_t public_cap, uint8_t *masked_buf, size_t masked_cap);
+// Chain of Signed Packets: `links` must have room for `payloads_count` entries
+extern err_t auth_send_signed_packets_batch(message_links_t *links, author_t *author, message_links_t link_to, packet_payloads_t const *payloads, size_t payloads_count);
+#ifdef IOTA_STREAMS_CHANNELS_CLIENT
+// Non-blocking Packets: links are returned right away, `req` tracks their publication
+extern err_t auth_send_tagged_packet_async(message_links_t *links, request_t **req, author_t *author, message_links_t link_to, uint8_t const *public_payload_ptr, size_t public_payload_size, uint8_t const *masked_payload_ptr, size_t masked_payload_size);
+extern err_t auth_send_signed_packet_async(message_links_t *links, request_t **req, author_t *author, message_links_t link_to, uint8_t const *public_payload_ptr, size_t public_payload_size, uint8_t const *masked_payload_ptr, size_t masked_payload_size);
+#endif
 // Sequence Message (for multi branch use)
 extern err_t auth_receive_sequence(address_t const **seq, author_t *author, address_t const *address);
 // MsgId generation
 extern err_t auth_gen_next_msg_ids(next_msg_ids_t const **ids, author_t *author);
+extern err_t auth_gen_next_msg_ids_in(next_msg_ids_t const **ids, author_t *author, streams_arena_t *arena);
 // Generic Processing
 extern err_t auth_receive_msg(unwrapped_message_t const **msg, author_t *author, address_t const *address);
+#ifdef IOTA_STREAMS_CHANNELS_CLIENT
+extern err_t auth_receive_msg_from_request(unwrapped_message_t const **umsg, author_t *author, request_t *req);
+#endif
 // Fetching/Syncing
 extern err_t auth_fetch_next_msgs(unwrapped_messages_t const **umsgs, author_t *author);
+extern err_t auth_fetch_next_msgs_in(unwrapped_messages_t const **umsgs, author_t *author, streams_arena_t *arena);
 extern err_t auth_fetch_prev_msg(unwrapped_message_t const **umsg, author_t *author, address_t const *address);
 extern err_t auth_fetch_prev_msgs(unwrapped_messages_t const **umsgs, author_t *author, address_t const *address, size_t num_msgs);
+// At most `num_msgs` messages preceding `address`, those reached within `timeout_ms`
+extern err_t auth_fetch_prev_msgs_window(unwrapped_messages_t const **umsgs, author_t *author, address_t const *address, size_t num_msgs, uint64_t timeout_ms);
 extern err_t auth_sync_state(unwrapped_messages_t const **umsgs, author_t *author);
+extern err_t auth_sync_state_in(unwrapped_messages_t const **umsgs, author_t *author, streams_arena_t *arena);
+// Incremental syncing: batches of at most `batch_size` messages, empty once caught up
+typedef struct AuthSync auth_sync_t;
+extern err_t auth_sync_begin(auth_sync_t **sync, author_t *author);
+extern err_t auth_sync_next(unwrapped_messages_t const **umsgs, auth_sync_t *sync, size_t batch_size);
+extern err_t auth_sync_next_in(unwrapped_messages_t const **umsgs, auth_sync_t *sync, size_t batch_size, streams_arena_t *arena);
+extern void auth_sync_end(auth_sync_t *sync);
 extern err_t auth_fetch_state(user_state_t const **state, author_t *author);
+extern err_t auth_fetch_state_in(user_state_t const **state, author_t *author, streams_arena_t *arena);
+// Link of the latest message of a single publisher, NULL if the publisher is unknown
+extern err_t auth_fetch_link_of(address_t const **link, author_t *author, public_key_t const *pub_key);
+// Link store policy: 0 keeps all message states, 1 keeps the states linked by publisher cursors
+// plus the `window` most recent ones and restores evicted states from the transport on demand
+extern err_t auth_set_link_store_policy(author_t *author, uint8_t policy, size_t window);
+// Keyload key exchange: 0 derives the keys shared with recipients from a new ephemeral key per
+// keyload, 1 from the author's static key, cached per recipient but exposing past keyloads if leaked
+extern err_t auth_set_keyload_key_exchange(author_t *author, uint8_t key_exchange);
 // Store Psk
 extern err_t auth_store_psk(psk_id_t const **pskid, author_t *author, char const *psk);
 
@@ -155,8 +333,16 @@ extern err_t auth_store_psk(psk_id_t const **pskid, author_t *author, char const
 typedef struct Subscriber subscriber_t;
 extern err_t sub_new(subscriber_t **sub, char const *seed, transport_t *transport);
 extern err_t sub_recover(subscriber_t **sub, char const *seed, address_t const *announcement, transport_t *transport);
+// Restores the state exported by sub_export with the seed as password and replays only later messages
+extern err_t sub_recover_from_checkpoint(subscriber_t **sub, char const *seed, buffer_t checkpoint, transport_t *transport);
 extern err_t sub_import(subscriber_t **sub, buffer_t buffer, char const *password, transport_t *transport);
 extern err_t sub_export(buffer_t *buf, subscriber_t const *subscriber, char const *password);
+extern err_t sub_export_to_writer(subscriber_t const *user, char const *password, stream_write_cb write, void *ctx);
+extern err_t sub_import_from_reader(subscriber_t **sub, stream_read_cb read, void *ctx, char const *password, transport_t *transport);
+// Appends later state changes to the journal file on each sub_journal_sync, compacting it as it grows
+extern err_t sub_journal_create(state_journal_t **journal, subscriber_t const *user, char const *path, char const *password);
+extern err_t sub_journal_open(subscriber_t **sub, state_journal_t **journal, char const *path, char const *password, transport_t *transport);
+extern err_t sub_journal_sync(state_journal_t *journal, subscriber_t const *user);
 extern void sub_drop(subscriber_t *);
 
 extern err_t sub_channel_address(channel_address_t const **addr, subscriber_t const *subscriber);
@@ -177,24 +363,80 @@ extern err_t sub_receive_keyload_from_ids(message_links_t *links, subscriber_t *
 // Tagged Packets
 extern err_t sub_send_tagged_packet(message_links_t *links, subscriber_t *subscriber, message_links_t link_to, uint8_t const *public_payload_ptr, size_t public_payload_size, uint8_t const *masked_payload_ptr, size_t masked_payload_size);
 extern err_t sub_receive_tagged_packet(packet_payloads_t *payloads, subscriber_t *subscriber, address_t const *address);
+// Zero-copy variant: payloads are decrypted into the given buffers, fails if either does not fit
+extern err_t sub_receive_tagged_packet_into(size_t *public_len, size_t *masked_len, subscriber_t *subscriber, address_t const *address, uint8_t *public_buf, size_t public_cap, uint8_t *masked_buf, size_t masked_cap);
+// Chain of Tagged Packets: `links` must have room for `payloads_count` entries
+extern err_t sub_send_tagged_packets_batch(message_links_t *links, subscriber_t *subscriber, message_links_t link_to, packet_payloads_t const *payloads, size_t payloads_count);
 // Signed Packets
 extern err_t sub_send_signed_packet(message_links_t *links, subscriber_t *subscriber, message_links_t link_to, uint8_t const *public_payload_ptr, size_t public_payload_size, uint8_t const *masked_payload_ptr, size_t masked_payload_size);
 extern err_t sub_receive_signed_packet(packet_payloads_t *payloads, subscriber_t *subscriber, address_t const *address);
+// Zero-copy variant: payloads are decrypted into the given buffers, fails if either does not fit
+extern err_t sub_receive_signed_packet_into(size_t *public_len, size_t *masked_len, subscriber_t *subscriber, address_t const *address, uint8_t *public_buf, size_t public_cap, uint8_t *masked_buf, size_t masked_cap);
+// Chain of Signed Packets: `links` must have room for `payloads_count` entries
+extern err_t sub_send_signed_packets_batch(message_links_t *links, subscriber_t *subscriber, message_links_t link_to, packet_payloads_t const *payloads, size_t payloads_count);
+#ifdef IOTA_STREAMS_CHANNELS_CLIENT
+// Non-blocking Packets: links are returned right away, `req` tracks their publication
+extern err_t sub_send_tagged_packet_async(message_links_t *links, request_t **req, subscriber_t *subscriber, message_links_t link_to, uint8_t const *public_payload_ptr, size_t public_payload_size, uint8_t const *masked_payload_ptr, size_t masked_payload_size);
+extern err_t sub_send_signed_packet_async(message_links_t *links, request_t **req, subscriber_t *subscriber, message_links_t link_to, uint8_t const *public_payload_ptr, size_t public_payload_size, uint8_t const *masked_payload_ptr, size_t masked_payload_size);
+#endif
 // Sequence Message (for multi branch use)
 extern err_t sub_receive_sequence(address_t const **address, subscriber_t *subscriber, address_t const *seq_address);
 // MsgId Generation
 extern err_t sub_gen_next_msg_ids(next_msg_ids_t const **ids, subscriber_t *subscriber);
+extern err_t sub_gen_next_msg_ids_in(next_msg_ids_t const **ids, subscriber_t *subscriber, streams_arena_t *arena);
 // Generic Message Processing
 extern err_t sub_receive_msg(unwrapped_message_t const *umsg, subscriber_t *subscriber, address_t const *address);
+#ifdef IOTA_STREAMS_CHANNELS_CLIENT
+extern err_t sub_receive_msg_from_request(unwrapped_message_t const **umsg, subscriber_t *subscriber, request_t *req);
+// Batch processing: packets are unwrapped on up to `workers` threads
+extern err_t sub_process_batch(unwrapped_messages_t const **umsgs, subscriber_t *subscriber, request_t *const *reqs, size_t reqs_count, size_t workers);
+#endif
 // Fetching/Syncing
 extern err_t sub_fetch_next_msgs(unwrapped_messages_t const **messages, subscriber_t *subscriber);
+extern err_t sub_fetch_next_msgs_in(unwrapped_messages_t const **messages, subscriber_t *subscriber, streams_arena_t *arena);
 extern err_t sub_fetch_prev_msg(unwrapped_message_t const **umsg, subscriber_t *subscriber, address_t const *address);
 extern err_t sub_fetch_prev_msgs(unwrapped_messages_t const **umsgs, subscriber_t *subscriber, address_t const *address, size_t num_msgs);
+// At most `num_msgs` messages preceding `address`, those reached within `timeout_ms`
+extern err_t sub_fetch_prev_msgs_window(unwrapped_messages_t const **umsgs, subscriber_t *subscriber, address_t const *address, size_t num_msgs, uint64_t timeout_ms);
 extern err_t sub_sync_state(unwrapped_messages_t const **messages, subscriber_t *subscriber);
+extern err_t sub_sync_state_in(unwrapped_messages_t const **messages, subscriber_t *subscriber, streams_arena_t *arena);
+// Incremental syncing: batches of at most `batch_size` messages, empty once caught up
+typedef struct SubSync sub_sync_t;
+extern err_t sub_sync_begin(sub_sync_t **sync, subscriber_t *subscriber);
+extern err_t sub_sync_next(unwrapped_messages_t const **umsgs, sub_sync_t *sync, size_t batch_size);
+extern err_t sub_sync_next_in(unwrapped_messages_t const **umsgs, sub_sync_t *sync, size_t batch_size, streams_arena_t *arena);
+extern void sub_sync_end(sub_sync_t *sync);
 extern err_t sub_fetch_state(user_state_t const **state, subscriber_t *subscriber);
+extern err_t sub_fetch_state_in(user_state_t const **state, subscriber_t *subscriber, streams_arena_t *arena);
+// Link of the latest message of a single publisher, NULL if the publisher is unknown
+extern err_t sub_fetch_link_of(address_t const **link, subscriber_t *subscriber, public_key_t const *pub_key);
+// Link store policy, see auth_set_link_store_policy
+extern err_t sub_set_link_store_policy(subscriber_t *subscriber, uint8_t policy, size_t window);
 // Store Psk
 extern err_t sub_store_psk(psk_id_t const **pskid, subscriber_t *subscriber, char const *psk);
 
+/////////////
+/// Channel manager
+/////////////
+// Polls the next messages of many users in one batch over a shared transport. Registered users are
+// not owned by the manager and must outlive their registration.
+typedef struct ChannelManager channel_manager_t;
+typedef void (*channel_message_cb)(void *ctx, size_t channel, unwrapped_message_t const *message);
+
+extern channel_manager_t *manager_new(transport_t const *transport);
+extern void manager_drop(channel_manager_t *manager);
+
+extern err_t manager_add_author(size_t *channel, channel_manager_t *manager, author_t *author);
+extern err_t manager_add_subscriber(size_t *channel, channel_manager_t *manager, subscriber_t *subscriber);
+extern err_t manager_remove(channel_manager_t *manager, size_t channel);
+
+// Queues the messages unwrapped in one round of next messages of all users
+extern err_t manager_poll(size_t *count, channel_manager_t *manager);
+// Oldest queued message, null once the queue is empty
+extern err_t manager_next_message(unwrapped_message_t const **message, size_t *channel, channel_manager_t *manager);
+// Hands every queued message to the callback, messages are only valid during the call
+extern size_t manager_dispatch(channel_manager_t *manager, channel_message_cb callback, void *ctx);
+
 /////////////
 /// Utility
 /////////////
@@ -213,6 +455,7 @@ extern size_t get_payloads_count(unwrapped_messages_t const *messages);
 extern packet_payloads_t get_indexed_payload(unwrapped_messages_t const *messages, size_t index);
 
 extern char const *get_address_index_str(address_t const *address);
+extern err_t get_address_index_into(char index[IOTA_STREAMS_ADDRESS_INDEX_SIZE], address_t const *address);
 
 extern address_t const *get_link_from_state(user_state_t const *state, public_key_t const *pub_key);
 
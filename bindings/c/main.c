@@ -17,6 +17,39 @@ void rand_seed(char *seed, size_t n)
   *seed = '\0';
 }
 
+// In-memory target of streamed exports and source of streamed imports
+typedef struct MemStream {
+  uint8_t *data;
+  size_t len;
+  size_t cap;
+  size_t pos;
+} mem_stream_t;
+
+int mem_write(void *ctx, uint8_t const *chunk, size_t len)
+{
+  mem_stream_t *m = (mem_stream_t *)ctx;
+  if(m->len + len > m->cap)
+  {
+    size_t cap = 2 * (m->len + len);
+    uint8_t *data = realloc(m->data, cap);
+    if(!data) return 1;
+    m->data = data;
+    m->cap = cap;
+  }
+  memcpy(m->data + m->len, chunk, len);
+  m->len += len;
+  return 0;
+}
+
+int mem_read(void *ctx, uint8_t *buf, size_t cap, size_t *read)
+{
+  mem_stream_t *m = (mem_stream_t *)ctx;
+  *read = m->len - m->pos < cap ? m->len - m->pos : cap;
+  memcpy(buf, m->data + m->pos, *read);
+  m->pos += *read;
+  return 0;
+}
+
 int main()
 {
   err_t e = ERR_OK;
@@ -142,9 +175,27 @@ int main()
         goto cleanup0;
       }
 
+      printf("Converting announcement link to bytes... \n");
+      {
+        uint8_t bytes[IOTA_STREAMS_ADDRESS_SIZE];
+        address_t const *ann_link_bin = NULL;
+        e = address_to_bytes(bytes, ann_link);
+        if(!e) e = address_from_bytes(&ann_link_bin, bytes);
+        if(!e && (address_cmp(ann_link, ann_link_bin) || address_hash(ann_link) != address_hash(ann_link_bin)))
+          e = ERR_OPERATION_FAILED;
+        drop_address(ann_link_bin);
+        if(e) goto cleanup0;
+      }
+
       printf("Converting announcement link to tangle index... \n");
       link_index = get_address_index_str(ann_link_copy);
       printf("  '%s'\n", link_index);
+      {
+        char index[IOTA_STREAMS_ADDRESS_INDEX_SIZE];
+        e = get_address_index_into(index, ann_link);
+        if(!e && (!link_index || strcmp(index, link_index))) e = ERR_OPERATION_FAILED;
+        if(e) goto cleanup0;
+      }
 
 cleanup0:
       drop_str(link_index);
@@ -505,6 +556,13 @@ cleanup7:
     printf("  %s\n", !e ? "done" : "failed");
     if(e) goto cleanup;
 
+    printf("Author fetching window of previous messages... ");
+    drop_unwrapped_messages(message_returns);
+    message_returns = NULL;
+    e = auth_fetch_prev_msgs_window(&message_returns, auth, recovered_state_link, 2, 10000);
+    printf("  %s\n", !e ? "done" : "failed");
+    if(e) goto cleanup8;
+
 cleanup8:
     drop_address(original_state_link);
     drop_address(recovered_state_link);
@@ -532,6 +590,22 @@ cleanup8:
     //auth_import consumes bytes, need to clear to avoid double-free
     bytes.ptr = NULL;
 
+    {
+      mem_stream_t m = { NULL, 0, 0, 0 };
+      author_t *auth_streamed = NULL;
+      printf("Exporting author state in chunks... ");
+      e = auth_export_to_writer(auth, "my_password", mem_write, &m);
+      printf("  %s\n", !e ? "done" : "failed");
+      if(!e)
+      {
+        printf("Importing author state in chunks... ");
+        e = auth_import_from_reader(&auth_streamed, mem_read, &m, "my_password", tsp);
+        printf("  %s\n", !e ? "done" : "failed");
+      }
+      auth_drop(auth_streamed);
+      free(m.data);
+    }
+
  cleanup9:
     auth_drop(auth_new);
     drop_buffer(bytes);
@@ -0,0 +1,88 @@
+use super::*;
+
+/// Results of one kind held by an arena. Slots are boxed so that results handed out stay in place
+/// as more are added, and are kept across resets along with the capacity of their contents.
+struct Slots<T> {
+    slots: Vec<Box<T>>,
+    used: usize,
+}
+
+impl<T: Default> Slots<T> {
+    fn new() -> Self {
+        Self {
+            slots: Vec::new(),
+            used: 0,
+        }
+    }
+
+    /// Next free slot, empty.
+    fn alloc(&mut self) -> &mut T {
+        if self.used == self.slots.len() {
+            self.slots.push(Box::new(T::default()));
+        }
+        self.used += 1;
+        &mut self.slots[self.used - 1]
+    }
+
+    fn reset(&mut self, clear: fn(&mut T)) {
+        for slot in &mut self.slots[..self.used] {
+            clear(slot);
+        }
+        self.used = 0;
+    }
+}
+
+/// Storage for the results of fetch and sync calls. Results allocated in an arena are released all
+/// at once by `arena_reset`, which keeps the storage for the following calls, so that a sync loop
+/// resetting its arena each round stops growing it once its rounds reach their usual size.
+pub struct Arena {
+    messages: Slots<UnwrappedMessages>,
+    next_msg_ids: Slots<NextMsgIds>,
+    states: Slots<UserState>,
+}
+
+impl Arena {
+    fn new() -> Self {
+        Self {
+            messages: Slots::new(),
+            next_msg_ids: Slots::new(),
+            states: Slots::new(),
+        }
+    }
+
+    pub(crate) fn messages(&mut self) -> &mut UnwrappedMessages {
+        self.messages.alloc()
+    }
+
+    pub(crate) fn next_msg_ids(&mut self) -> &mut NextMsgIds {
+        self.next_msg_ids.alloc()
+    }
+
+    pub(crate) fn user_state(&mut self) -> &mut UserState {
+        self.states.alloc()
+    }
+
+    fn reset(&mut self) {
+        self.messages.reset(Vec::clear);
+        self.next_msg_ids.reset(Vec::clear);
+        self.states.reset(HashMap::clear);
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn arena_new() -> *mut Arena {
+    safe_into_mut_ptr(Arena::new())
+}
+
+/// Release all results allocated in the arena, keeping its storage.
+#[no_mangle]
+pub unsafe extern "C" fn arena_reset(arena: *mut Arena) {
+    if let Some(arena) = arena.as_mut() {
+        arena.reset()
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn arena_drop(arena: *mut Arena) {
+    safe_drop_mut_ptr(arena)
+}
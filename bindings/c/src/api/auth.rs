@@ -53,6 +53,32 @@ pub unsafe extern "C" fn auth_recover(
     })
 }
 
+/// Recover an Author from a checkpoint exported with the seed as password, fetching only the messages
+/// published after the checkpoint
+#[no_mangle]
+pub unsafe extern "C" fn auth_recover_from_checkpoint(
+    c_author: *mut *mut Author,
+    c_seed: *const c_char,
+    checkpoint: Buffer,
+    transport: *mut TransportWrap,
+) -> Err {
+    if c_seed == null() {
+        return Err::NullArgument;
+    }
+
+    CStr::from_ptr(c_seed).to_str().map_or(Err::BadArgument, |seed| {
+        transport.as_ref().map_or(Err::NullArgument, |tsp| {
+            c_author.as_mut().map_or(Err::NullArgument, |author| {
+                let bytes_vec: Vec<_> = checkpoint.into();
+                Author::recover_from_checkpoint(seed, &bytes_vec, tsp.clone()).map_or(Err::OperationFailed, |user| {
+                    *author = safe_into_mut_ptr(user);
+                    Err::Ok
+                })
+            })
+        })
+    })
+}
+
 /// Import an Author instance from an encrypted binary array
 #[no_mangle]
 pub unsafe extern "C" fn auth_import(
@@ -96,6 +122,124 @@ pub unsafe extern "C" fn auth_export(buf: *mut Buffer, c_author: *mut Author, c_
     })
 }
 
+/// Export an Author instance encrypted, handing the state over to `write` in chunks
+#[no_mangle]
+pub unsafe extern "C" fn auth_export_to_writer(
+    c_author: *const Author,
+    c_password: *const c_char,
+    write: Option<StreamWriteCallback>,
+    ctx: *mut c_void,
+) -> Err {
+    if c_password == null() {
+        return Err::NullArgument;
+    }
+
+    CStr::from_ptr(c_password).to_str().map_or(Err::BadArgument, |password| {
+        c_author.as_ref().map_or(Err::NullArgument, |user| {
+            write.map_or(Err::NullArgument, |write| {
+                user.export_to(password, STREAM_CHUNK_SIZE, stream_sink(write, ctx))
+                    .map_or(Err::OperationFailed, |_| Err::Ok)
+            })
+        })
+    })
+}
+
+/// Import an Author instance from an encrypted state pulled from `read` in chunks
+#[no_mangle]
+pub unsafe extern "C" fn auth_import_from_reader(
+    c_author: *mut *mut Author,
+    read: Option<StreamReadCallback>,
+    ctx: *mut c_void,
+    c_password: *const c_char,
+    transport: *mut TransportWrap,
+) -> Err {
+    if c_password == null() {
+        return Err::NullArgument;
+    }
+
+    CStr::from_ptr(c_password).to_str().map_or(Err::BadArgument, |password| {
+        transport.as_ref().map_or(Err::NullArgument, |tsp| {
+            c_author.as_mut().map_or(Err::NullArgument, |author| {
+                read.map_or(Err::NullArgument, |read| {
+                    Author::import_from(password, STREAM_CHUNK_SIZE, stream_source(read, ctx), tsp.clone())
+                        .map_or(Err::OperationFailed, |user| {
+                            *author = safe_into_mut_ptr(user);
+                            Err::Ok
+                        })
+                })
+            })
+        })
+    })
+}
+
+/// Write the state of an Author instance into a new encrypted journal file
+#[no_mangle]
+pub unsafe extern "C" fn auth_journal_create(
+    c_journal: *mut *mut StateJournal,
+    c_author: *const Author,
+    c_path: *const c_char,
+    c_password: *const c_char,
+) -> Err {
+    if c_path == null() || c_password == null() {
+        return Err::NullArgument;
+    }
+
+    let (path, password) = match (CStr::from_ptr(c_path).to_str(), CStr::from_ptr(c_password).to_str()) {
+        (Ok(path), Ok(password)) => (path, password),
+        _ => return Err::BadArgument,
+    };
+
+    c_author.as_ref().map_or(Err::NullArgument, |user| {
+        c_journal.as_mut().map_or(Err::NullArgument, |journal| {
+            user.create_journal(path, password).map_or(Err::OperationFailed, |j| {
+                *journal = safe_into_mut_ptr(j);
+                Err::Ok
+            })
+        })
+    })
+}
+
+/// Recover an Author instance from an encrypted journal file
+#[no_mangle]
+pub unsafe extern "C" fn auth_journal_open(
+    c_author: *mut *mut Author,
+    c_journal: *mut *mut StateJournal,
+    c_path: *const c_char,
+    c_password: *const c_char,
+    transport: *mut TransportWrap,
+) -> Err {
+    if c_path == null() || c_password == null() {
+        return Err::NullArgument;
+    }
+
+    let (path, password) = match (CStr::from_ptr(c_path).to_str(), CStr::from_ptr(c_password).to_str()) {
+        (Ok(path), Ok(password)) => (path, password),
+        _ => return Err::BadArgument,
+    };
+
+    transport.as_ref().map_or(Err::NullArgument, |tsp| {
+        c_author.as_mut().map_or(Err::NullArgument, |author| {
+            c_journal.as_mut().map_or(Err::NullArgument, |journal| {
+                Author::open_journal(path, password, tsp.clone()).map_or(Err::OperationFailed, |(user, j)| {
+                    *author = safe_into_mut_ptr(user);
+                    *journal = safe_into_mut_ptr(j);
+                    Err::Ok
+                })
+            })
+        })
+    })
+}
+
+/// Append the changes of Author state since the last sync to its journal
+#[no_mangle]
+pub unsafe extern "C" fn auth_journal_sync(journal: *mut StateJournal, c_author: *const Author) -> Err {
+    c_author.as_ref().map_or(Err::NullArgument, |user| {
+        journal.as_mut().map_or(Err::NullArgument, |journal| {
+            user.sync_journal(journal).map_or(Err::OperationFailed, |_| Err::Ok)
+        })
+    })
+}
+
 #[no_mangle]
 pub extern "C" fn auth_drop(user: *mut Author) {
     safe_drop_mut_ptr(user)
@@ -303,6 +447,172 @@ pub unsafe extern "C" fn auth_send_signed_packet(
     })
 }
 
+/// Send a chain of Tagged packets, the first one attached to `link_to` and each following one to the
+/// previous packet. `r` must point to an array of `payloads_count` message links, filled in chain order.
+#[no_mangle]
+pub unsafe extern "C" fn auth_send_tagged_packets_batch(
+    r: *mut MessageLinks,
+    user: *mut Author,
+    link_to: MessageLinks,
+    payloads: *const PacketPayloads,
+    payloads_count: size_t,
+) -> Err {
+    if r == null_mut() || payloads == null() {
+        return Err::NullArgument;
+    }
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        link_to
+            .into_seq_link(user.is_multi_branching())
+            .map_or(Err::NullArgument, |link_to| {
+                let payloads = borrow_payloads(payloads, payloads_count);
+                let e = user
+                    .send_tagged_packets(link_to, &payloads)
+                    .map_or(Err::OperationFailed, |links| {
+                        write_links(r, links);
+                        Err::Ok
+                    });
+                forget_payloads(payloads);
+                e
+            })
+    })
+}
+
+/// Send a chain of Signed packets, the first one attached to `link_to` and each following one to the
+/// previous packet. `r` must point to an array of `payloads_count` message links, filled in chain order.
+#[no_mangle]
+pub unsafe extern "C" fn auth_send_signed_packets_batch(
+    r: *mut MessageLinks,
+    user: *mut Author,
+    link_to: MessageLinks,
+    payloads: *const PacketPayloads,
+    payloads_count: size_t,
+) -> Err {
+    if r == null_mut() || payloads == null() {
+        return Err::NullArgument;
+    }
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        link_to
+            .into_seq_link(user.is_multi_branching())
+            .map_or(Err::NullArgument, |link_to| {
+                let payloads = borrow_payloads(payloads, payloads_count);
+                let e = user
+                    .send_signed_packets(link_to, &payloads)
+                    .map_or(Err::OperationFailed, |links| {
+                        write_links(r, links);
+                        Err::Ok
+                    });
+                forget_payloads(payloads);
+                e
+            })
+    })
+}
+
+/// Wrap a Tagged packet and publish it in the background. Links of the packet are available right
+/// away; `req` receives the handle of the pending publication, to be polled with `streams_poll`.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn auth_send_tagged_packet_async(
+    r: *mut MessageLinks,
+    req: *mut *mut Request,
+    user: *mut Author,
+    link_to: MessageLinks,
+    public_payload_ptr: *const uint8_t,
+    public_payload_size: size_t,
+    masked_payload_ptr: *const uint8_t,
+    masked_payload_size: size_t,
+) -> Err {
+    if r == null_mut() {
+        return Err::NullArgument;
+    }
+    req.as_mut().map_or(Err::NullArgument, |req| {
+        user.as_mut().map_or(Err::NullArgument, |user| {
+            link_to
+                .into_seq_link(user.is_multi_branching())
+                .map_or(Err::NullArgument, |link_to| {
+                    let payloads = borrow_payload_pair(
+                        public_payload_ptr,
+                        public_payload_size,
+                        masked_payload_ptr,
+                        masked_payload_size,
+                    );
+                    let e = user
+                        .wrap_tagged_packets(link_to, &payloads)
+                        .map_or(Err::OperationFailed, |(msgs, links)| {
+                            write_links(r, links);
+                            *req = spawn_send(user.get_transport(), msgs);
+                            Err::Ok
+                        });
+                    forget_payloads(payloads);
+                    e
+                })
+        })
+    })
+}
+
+/// Wrap a Signed packet and publish it in the background. Links of the packet are available right
+/// away; `req` receives the handle of the pending publication, to be polled with `streams_poll`.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn auth_send_signed_packet_async(
+    r: *mut MessageLinks,
+    req: *mut *mut Request,
+    user: *mut Author,
+    link_to: MessageLinks,
+    public_payload_ptr: *const uint8_t,
+    public_payload_size: size_t,
+    masked_payload_ptr: *const uint8_t,
+    masked_payload_size: size_t,
+) -> Err {
+    if r == null_mut() {
+        return Err::NullArgument;
+    }
+    req.as_mut().map_or(Err::NullArgument, |req| {
+        user.as_mut().map_or(Err::NullArgument, |user| {
+            link_to
+                .into_seq_link(user.is_multi_branching())
+                .map_or(Err::NullArgument, |link_to| {
+                    let payloads = borrow_payload_pair(
+                        public_payload_ptr,
+                        public_payload_size,
+                        masked_payload_ptr,
+                        masked_payload_size,
+                    );
+                    let e = user
+                        .wrap_signed_packets(link_to, &payloads)
+                        .map_or(Err::OperationFailed, |(msgs, links)| {
+                            write_links(r, links);
+                            *req = spawn_send(user.get_transport(), msgs);
+                            Err::Ok
+                        });
+                    forget_payloads(payloads);
+                    e
+                })
+        })
+    })
+}
+
+/// Process the message retrieved by a completed `transport_fetch_msg_async` request
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn auth_receive_msg_from_request(
+    r: *mut *const UnwrappedMessage,
+    user: *mut Author,
+    req: *mut Request,
+) -> Err {
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        user.as_mut().map_or(Err::NullArgument, |user| {
+            req.as_mut().map_or(Err::NullArgument, |req| {
+                req.take_message().map_or(Err::OperationFailed, |msg| {
+                    user.handle_msg(msg).map_or(Err::OperationFailed, |u| {
+                        *r = safe_into_ptr(u);
+                        Err::Ok
+                    })
+                })
+            })
+        })
+    })
+}
+
 /// Process a Signed packet message
 #[no_mangle]
 pub unsafe extern "C" fn auth_receive_signed_packet(
@@ -323,6 +633,76 @@ pub unsafe extern "C" fn auth_receive_signed_packet(
     })
 }
 
+/// Process a Tagged packet message, decrypting payloads into caller-provided buffers.
+/// Fails without touching `public_len`/`masked_len` if a payload does not fit its buffer.
+#[no_mangle]
+pub unsafe extern "C" fn auth_receive_tagged_packet_into(
+    public_len: *mut size_t,
+    masked_len: *mut size_t,
+    user: *mut Author,
+    link: *const Address,
+    public_buf: *mut uint8_t,
+    public_cap: size_t,
+    masked_buf: *mut uint8_t,
+    masked_cap: size_t,
+) -> Err {
+    public_len.as_mut().map_or(Err::NullArgument, |public_len| {
+        masked_len.as_mut().map_or(Err::NullArgument, |masked_len| {
+            user.as_mut().map_or(Err::NullArgument, |user| {
+                link.as_ref().map_or(Err::NullArgument, |link| {
+                    borrow_out_buffer(public_buf, public_cap).map_or(Err::NullArgument, |public_buf| {
+                        borrow_out_buffer(masked_buf, masked_cap).map_or(Err::NullArgument, |masked_buf| {
+                            user.receive_tagged_packet_into(link, public_buf, masked_buf).map_or(
+                                Err::OperationFailed,
+                                |(public_size, masked_size)| {
+                                    *public_len = public_size;
+                                    *masked_len = masked_size;
+                                    Err::Ok
+                                },
+                            )
+                        })
+                    })
+                })
+            })
+        })
+    })
+}
+
+/// Process a Signed packet message, decrypting payloads into caller-provided buffers.
+/// Fails without touching `public_len`/`masked_len` if a payload does not fit its buffer.
+#[no_mangle]
+pub unsafe extern "C" fn auth_receive_signed_packet_into(
+    public_len: *mut size_t,
+    masked_len: *mut size_t,
+    user: *mut Author,
+    link: *const Address,
+    public_buf: *mut uint8_t,
+    public_cap: size_t,
+    masked_buf: *mut uint8_t,
+    masked_cap: size_t,
+) -> Err {
+    public_len.as_mut().map_or(Err::NullArgument, |public_len| {
+        masked_len.as_mut().map_or(Err::NullArgument, |masked_len| {
+            user.as_mut().map_or(Err::NullArgument, |user| {
+                link.as_ref().map_or(Err::NullArgument, |link| {
+                    borrow_out_buffer(public_buf, public_cap).map_or(Err::NullArgument, |public_buf| {
+                        borrow_out_buffer(masked_buf, masked_cap).map_or(Err::NullArgument, |masked_buf| {
+                            user.receive_signed_packet_into(link, public_buf, masked_buf).map_or(
+                                Err::OperationFailed,
+                                |(_pk, public_size, masked_size)| {
+                                    *public_len = public_size;
+                                    *masked_len = masked_size;
+                                    Err::Ok
+                                },
+                            )
+                        })
+                    })
+                })
+            })
+        })
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn auth_receive_sequence(r: *mut *const Address, user: *mut Author, link: *const Address) -> Err {
     r.as_mut().map_or(Err::NullArgument, |r| {
@@ -348,6 +728,25 @@ pub unsafe extern "C" fn auth_gen_next_msg_ids(ids: *mut *const NextMsgIds, user
     })
 }
 
+/// Same as `auth_gen_next_msg_ids`, with the ids allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn auth_gen_next_msg_ids_in(
+    ids: *mut *const NextMsgIds,
+    user: *mut Author,
+    arena: *mut Arena,
+) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        ids.as_mut().map_or(Err::NullArgument, |ids| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                let next_msg_ids = arena.next_msg_ids();
+                next_msg_ids.extend(user.gen_next_msg_ids(user.is_multi_branching()));
+                *ids = next_msg_ids;
+                Err::Ok
+            })
+        })
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn auth_receive_msg(
     r: *mut *const UnwrappedMessage,
@@ -377,6 +776,25 @@ pub unsafe extern "C" fn auth_fetch_next_msgs(umsgs: *mut *const UnwrappedMessag
     })
 }
 
+/// Same as `auth_fetch_next_msgs`, with the messages allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn auth_fetch_next_msgs_in(
+    umsgs: *mut *const UnwrappedMessages,
+    user: *mut Author,
+    arena: *mut Arena,
+) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        umsgs.as_mut().map_or(Err::NullArgument, |umsgs| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                let ms = arena.messages();
+                ms.extend(user.fetch_next_msgs());
+                *umsgs = ms;
+                Err::Ok
+            })
+        })
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn auth_fetch_prev_msg(m: *mut *const UnwrappedMessage, user: *mut Author, address: *const Address) -> Err {
     m.as_mut().map_or(Err::NullArgument, |m| {
@@ -405,6 +823,30 @@ pub unsafe extern "C" fn auth_fetch_prev_msgs(umsgs: *mut *const UnwrappedMessag
     })
 }
 
+/// Fetch at most `num_msgs` messages preceding `address`, oldest first, walking back no longer
+/// than `timeout_ms`. The messages reached by then are returned.
+#[no_mangle]
+pub unsafe extern "C" fn auth_fetch_prev_msgs_window(
+    umsgs: *mut *const UnwrappedMessages,
+    user: *mut Author,
+    address: *const Address,
+    num_msgs: size_t,
+    timeout_ms: u64,
+) -> Err {
+    umsgs.as_mut().map_or(Err::NullArgument, |umsgs| {
+        user.as_mut().map_or(Err::NullArgument, |user| {
+            address.as_ref().map_or(Err::NullArgument, |addr| {
+                let timeout = core::time::Duration::from_millis(timeout_ms);
+                user.fetch_prev_msgs_window(addr, num_msgs, timeout)
+                    .map_or(Err::OperationFailed, |msgs| {
+                        *umsgs = safe_into_ptr(msgs);
+                        Err::Ok
+                    })
+            })
+        })
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn auth_sync_state(umsgs: *mut *const UnwrappedMessages, user: *mut Author) -> Err {
     user.as_mut().map_or(Err::NullArgument, |user| {
@@ -423,18 +865,161 @@ pub unsafe extern "C" fn auth_sync_state(umsgs: *mut *const UnwrappedMessages, u
     })
 }
 
+/// Same as `auth_sync_state`, with the messages allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn auth_sync_state_in(
+    umsgs: *mut *const UnwrappedMessages,
+    user: *mut Author,
+    arena: *mut Arena,
+) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        umsgs.as_mut().map_or(Err::NullArgument, |umsgs| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                let ms = arena.messages();
+                loop {
+                    let m = user.fetch_next_msgs();
+                    if m.is_empty() {
+                        break;
+                    }
+                    ms.extend(m);
+                }
+                *umsgs = ms;
+                Err::Ok
+            })
+        })
+    })
+}
+
+pub type AuthSync = SyncIterator<Author>;
+
+/// Start synchronising the user state incrementally. The user must outlive the returned iterator.
+#[no_mangle]
+pub unsafe extern "C" fn auth_sync_begin(r: *mut *mut AuthSync, user: *mut Author) -> Err {
+    if user == null_mut() {
+        return Err::NullArgument;
+    }
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        *r = safe_into_mut_ptr(AuthSync::new(user));
+        Err::Ok
+    })
+}
+
+/// Fetch and unwrap the next batch of at most `batch_size` messages. An empty batch means the user
+/// state has caught up.
+#[no_mangle]
+pub unsafe extern "C" fn auth_sync_next(
+    r: *mut *const UnwrappedMessages,
+    sync: *mut AuthSync,
+    batch_size: size_t,
+) -> Err {
+    if batch_size == 0 {
+        return Err::BadArgument;
+    }
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        sync.as_mut().map_or(Err::NullArgument, |sync| {
+            sync.next_batch(batch_size, |user| user.fetch_next_msgs())
+                .map_or(Err::NullArgument, |ms| {
+                    *r = safe_into_ptr(ms);
+                    Err::Ok
+                })
+        })
+    })
+}
+
+/// Same as `auth_sync_next`, with the batch allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn auth_sync_next_in(
+    r: *mut *const UnwrappedMessages,
+    sync: *mut AuthSync,
+    batch_size: size_t,
+    arena: *mut Arena,
+) -> Err {
+    if batch_size == 0 {
+        return Err::BadArgument;
+    }
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        sync.as_mut().map_or(Err::NullArgument, |sync| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                sync.next_batch(batch_size, |user| user.fetch_next_msgs())
+                    .map_or(Err::NullArgument, |m| {
+                        let ms = arena.messages();
+                        ms.extend(m);
+                        *r = ms;
+                        Err::Ok
+                    })
+            })
+        })
+    })
+}
+
+#[no_mangle]
+pub extern "C" fn auth_sync_end(sync: *mut AuthSync) {
+    safe_drop_mut_ptr(sync)
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn auth_fetch_state(state: *mut *const UserState, user: *mut Author) -> Err {
     user.as_mut().map_or(Err::NullArgument, |user| {
         state.as_mut().map_or(Err::NullArgument, |state| {
-            user.fetch_state().map_or(Err::OperationFailed, |st| {
-                *state = safe_into_ptr(st);
+            user.fetch_key_state().map_or(Err::OperationFailed, |st| {
+                *state = safe_into_ptr(user_state_from(st));
                 Err::Ok
             })
         })
     })
 }
 
+/// Same as `auth_fetch_state`, with the state allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn auth_fetch_state_in(
+    state: *mut *const UserState,
+    user: *mut Author,
+    arena: *mut Arena,
+) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        state.as_mut().map_or(Err::NullArgument, |state| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                user.fetch_key_state().map_or(Err::OperationFailed, |st| {
+                    let user_state = arena.user_state();
+                    user_state.extend(st.into_iter().map(|(pk, cursor)| (pk.into(), cursor)));
+                    *state = user_state;
+                    Err::Ok
+                })
+            })
+        })
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn auth_fetch_link_of(link: *mut *const Address, user: *mut Author, pub_key: *const PublicKey) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        link.as_mut().map_or(Err::NullArgument, |link| {
+            pub_key.as_ref().map_or(Err::NullArgument, |pub_key| {
+                user.fetch_state_of(pub_key).map_or(Err::OperationFailed, |cursor| {
+                    *link = cursor.map_or(null(), |cursor| safe_into_ptr(cursor.link));
+                    Err::Ok
+                })
+            })
+        })
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn auth_set_link_store_policy(user: *mut Author, policy: uint8_t, window: size_t) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        user.set_link_store_policy(get_link_store_policy(policy, window));
+        Err::Ok
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn auth_set_keyload_key_exchange(user: *mut Author, key_exchange: uint8_t) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        user.set_keyload_key_exchange(get_keyload_key_exchange(key_exchange));
+        Err::Ok
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn auth_store_psk(c_pskid: *mut *const PskId, c_user: *mut Author, c_psk_seed: *const c_char) -> Err {
     if c_psk_seed == null() {
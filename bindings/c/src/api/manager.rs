@@ -0,0 +1,214 @@
+use super::*;
+
+use core::ffi::c_void;
+use iota_streams::core::{
+    err,
+    Errors::MessageLinkNotFoundInTangle,
+    Result,
+};
+
+/// User registered with a channel manager. The manager does not own it.
+enum Channel {
+    Author(*mut Author),
+    Subscriber(*mut Subscriber),
+}
+
+impl Channel {
+    unsafe fn next_msg_links(&self) -> Vec<Address> {
+        match self {
+            Channel::Author(user) => user.as_ref().map_or(Vec::new(), |user| user.next_msg_links()),
+            Channel::Subscriber(user) => user.as_ref().map_or(Vec::new(), |user| user.next_msg_links()),
+        }
+    }
+
+    unsafe fn handle_next_msgs(&mut self, msgs: Vec<Result<Message>>) -> Vec<UnwrappedMessage> {
+        match self {
+            Channel::Author(user) => user.as_mut().map_or(Vec::new(), |user| user.handle_next_msgs(msgs)),
+            Channel::Subscriber(user) => user.as_mut().map_or(Vec::new(), |user| user.handle_next_msgs(msgs)),
+        }
+    }
+}
+
+/// Host of many channel users sharing one transport. Each poll retrieves the next messages of all
+/// users in a single batch, each link once however many users are waiting for it, and queues the
+/// messages unwrapped by the users along with the id of their channel.
+pub struct ChannelManager {
+    transport: TransportWrap,
+    channels: Vec<Option<Channel>>,
+    queue: VecDeque<(usize, UnwrappedMessage)>,
+}
+
+impl ChannelManager {
+    fn new(transport: TransportWrap) -> Self {
+        Self {
+            transport,
+            channels: Vec::new(),
+            queue: VecDeque::new(),
+        }
+    }
+
+    fn add(&mut self, channel: Channel) -> usize {
+        // Ids of removed channels are reused
+        match self.channels.iter().position(Option::is_none) {
+            Some(id) => {
+                self.channels[id] = Some(channel);
+                id
+            }
+            None => {
+                self.channels.push(Some(channel));
+                self.channels.len() - 1
+            }
+        }
+    }
+
+    /// Retrieve and unwrap one round of next messages of every channel, returns the number of
+    /// messages queued.
+    unsafe fn poll(&mut self) -> usize {
+        let mut links = Vec::new();
+        let mut index = HashMap::new();
+        let wanted: Vec<Vec<usize>> = self
+            .channels
+            .iter()
+            .map(|channel| {
+                channel.as_ref().map_or(Vec::new(), |channel| {
+                    channel
+                        .next_msg_links()
+                        .into_iter()
+                        .map(|link| match index.get(&link) {
+                            Some(i) => *i,
+                            None => {
+                                index.insert(link.clone(), links.len());
+                                links.push(link);
+                                links.len() - 1
+                            }
+                        })
+                        .collect()
+                })
+            })
+            .collect();
+        let fetched = self.transport.recv_message_batch(&links);
+
+        let queued = self.queue.len();
+        for (id, (channel, wanted)) in self.channels.iter_mut().zip(wanted).enumerate() {
+            if let Some(channel) = channel {
+                let msgs = wanted
+                    .into_iter()
+                    .map(|i| match &fetched[i] {
+                        Ok(msg) => Ok(msg.clone()),
+                        Err(_) => err!(MessageLinkNotFoundInTangle(links[i].to_string())),
+                    })
+                    .collect();
+                self.queue
+                    .extend(channel.handle_next_msgs(msgs).into_iter().map(|msg| (id, msg)));
+            }
+        }
+        self.queue.len() - queued
+    }
+}
+
+/// Create a channel manager retrieving messages through a clone of the transport.
+#[no_mangle]
+pub unsafe extern "C" fn manager_new(transport: *const TransportWrap) -> *mut ChannelManager {
+    transport
+        .as_ref()
+        .map_or(null_mut(), |tsp| safe_into_mut_ptr(ChannelManager::new(tsp.clone())))
+}
+
+#[no_mangle]
+pub extern "C" fn manager_drop(manager: *mut ChannelManager) {
+    safe_drop_mut_ptr(manager)
+}
+
+/// Register an author with the manager. The author must outlive its registration.
+#[no_mangle]
+pub unsafe extern "C" fn manager_add_author(id: *mut size_t, manager: *mut ChannelManager, user: *mut Author) -> Err {
+    if user == null_mut() {
+        return Err::NullArgument;
+    }
+    manager.as_mut().map_or(Err::NullArgument, |manager| {
+        id.as_mut().map_or(Err::NullArgument, |id| {
+            *id = manager.add(Channel::Author(user));
+            Err::Ok
+        })
+    })
+}
+
+/// Register a subscriber with the manager. The subscriber must outlive its registration.
+#[no_mangle]
+pub unsafe extern "C" fn manager_add_subscriber(
+    id: *mut size_t,
+    manager: *mut ChannelManager,
+    user: *mut Subscriber,
+) -> Err {
+    if user == null_mut() {
+        return Err::NullArgument;
+    }
+    manager.as_mut().map_or(Err::NullArgument, |manager| {
+        id.as_mut().map_or(Err::NullArgument, |id| {
+            *id = manager.add(Channel::Subscriber(user));
+            Err::Ok
+        })
+    })
+}
+
+/// Unregister the user of channel `id`. Its messages already queued are still delivered.
+#[no_mangle]
+pub unsafe extern "C" fn manager_remove(manager: *mut ChannelManager, id: size_t) -> Err {
+    manager.as_mut().map_or(Err::NullArgument, |manager| {
+        manager
+            .channels
+            .get_mut(id)
+            .and_then(Option::take)
+            .map_or(Err::BadArgument, |_| Err::Ok)
+    })
+}
+
+/// Retrieve one round of next messages of all registered users and queue the unwrapped ones.
+#[no_mangle]
+pub unsafe extern "C" fn manager_poll(count: *mut size_t, manager: *mut ChannelManager) -> Err {
+    manager.as_mut().map_or(Err::NullArgument, |manager| {
+        count.as_mut().map_or(Err::NullArgument, |count| {
+            *count = manager.poll();
+            Err::Ok
+        })
+    })
+}
+
+/// Take the oldest queued message along with the id of its channel, null if the queue is empty.
+#[no_mangle]
+pub unsafe extern "C" fn manager_next_message(
+    msg: *mut *const UnwrappedMessage,
+    id: *mut size_t,
+    manager: *mut ChannelManager,
+) -> Err {
+    manager.as_mut().map_or(Err::NullArgument, |manager| {
+        msg.as_mut().map_or(Err::NullArgument, |msg| {
+            id.as_mut().map_or(Err::NullArgument, |id| {
+                *msg = manager.queue.pop_front().map_or(null(), |(channel, m)| {
+                    *id = channel;
+                    safe_into_ptr(m)
+                });
+                Err::Ok
+            })
+        })
+    })
+}
+
+/// Hand every queued message to `callback` along with `ctx` and the id of its channel, returns the
+/// number of messages delivered. Messages are only valid during the callback.
+#[no_mangle]
+pub unsafe extern "C" fn manager_dispatch(
+    manager: *mut ChannelManager,
+    callback: Option<extern "C" fn(*mut c_void, size_t, *const UnwrappedMessage)>,
+    ctx: *mut c_void,
+) -> size_t {
+    manager.as_mut().map_or(0, |manager| {
+        callback.map_or(0, |callback| {
+            let delivered = manager.queue.len();
+            for (id, msg) in manager.queue.drain(..) {
+                callback(ctx, id, &msg);
+            }
+            delivered
+        })
+    })
+}
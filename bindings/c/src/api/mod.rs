@@ -6,13 +6,17 @@ use iota_streams::{
         },
         cty::{
             c_char,
+            c_int,
             size_t,
+            uint64_t,
             uint8_t,
         },
         message::Cursor,
         transport::tangle::{
             get_hash,
             MsgId,
+            ADDRESS_SIZE,
+            INDEX_HEX_SIZE,
         },
     },
     app_channels::api::{
@@ -21,14 +25,23 @@ use iota_streams::{
         tangle::*,
     },
     core::{
+        err,
         prelude::*,
         psk::PskId,
+        Errors::{
+            StreamSinkFailure,
+            StreamSourceFailure,
+        },
     },
+    core_edsig::signature::ed25519::PublicKeyWrap,
 };
 
-use core::ptr::{
-    null,
-    null_mut,
+use core::{
+    ffi::c_void,
+    ptr::{
+        null,
+        null_mut,
+    },
 };
 
 pub fn get_channel_type(channel_type: uint8_t) -> ChannelType {
@@ -40,6 +53,20 @@ pub fn get_channel_type(channel_type: uint8_t) -> ChannelType {
     }
 }
 
+pub fn get_link_store_policy(policy: uint8_t, window: size_t) -> LinkStorePolicy {
+    match policy {
+        1 => LinkStorePolicy::Bounded(window),
+        _ => LinkStorePolicy::KeepAll,
+    }
+}
+
+pub fn get_keyload_key_exchange(key_exchange: uint8_t) -> KeyloadKeyExchange {
+    match key_exchange {
+        1 => KeyloadKeyExchange::Static,
+        _ => KeyloadKeyExchange::Ephemeral,
+    }
+}
+
 pub(crate) fn safe_into_ptr<T>(value: T) -> *const T {
     Box::into_raw(Box::new(value))
 }
@@ -85,6 +112,27 @@ pub unsafe extern "C" fn drop_address(addr: *const Address) {
     safe_drop_ptr(addr)
 }
 
+pub type Addresses = Vec<Address>;
+
+#[no_mangle]
+pub extern "C" fn drop_addresses(addrs: *const Addresses) {
+    safe_drop_ptr(addrs)
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn get_addresses_count(addrs: *const Addresses) -> size_t {
+    addrs.as_ref().map_or(0, |addrs| addrs.len())
+}
+
+/// Address at `index`, owned by `addrs` and valid until they are dropped.
+#[no_mangle]
+pub unsafe extern "C" fn get_indexed_address(addrs: *const Addresses, index: size_t) -> *const Address {
+    addrs
+        .as_ref()
+        .and_then(|addrs| addrs.get(index))
+        .map_or(null(), |addr| addr as *const Address)
+}
+
 pub type PskIds = Vec<PskId>;
 pub type KePks = Vec<PublicKey>;
 
@@ -107,23 +155,30 @@ pub extern "C" fn drop_next_msg_ids(m: *const NextMsgIds) {
     safe_drop_ptr(m)
 }
 
-pub type UserState = Vec<(String, Cursor<Address>)>;
+/// Latest state of each publisher indexed by its public key
+pub type UserState = HashMap<PublicKeyWrap, Cursor<Address>>;
+
+pub(crate) fn user_state_from(state: Vec<(PublicKey, Cursor<Address>)>) -> UserState {
+    state.into_iter().map(|(pk, cursor)| (pk.into(), cursor)).collect()
+}
+
 #[no_mangle]
 pub extern "C" fn drop_user_state(s: *const UserState) {
     safe_drop_ptr(s)
 }
 
+#[no_mangle]
+pub extern "C" fn drop_state_journal(journal: *mut StateJournal) {
+    safe_drop_mut_ptr(journal)
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn get_link_from_state(state: *const UserState, pub_key: *const PublicKey) -> *const Address {
     state.as_ref().map_or(null(), |state_ref| {
         pub_key.as_ref().map_or(null(), |pub_key| {
-            let pk_str = hex::encode(pub_key.as_bytes());
-            for (pk, cursor) in state_ref {
-                if pk == &pk_str {
-                    return safe_into_ptr(cursor.link.clone());
-                }
-            }
-            null()
+            state_ref
+                .get(<&PublicKeyWrap>::from(pub_key))
+                .map_or(null(), |cursor| safe_into_ptr(cursor.link.clone()))
         })
     })
 }
@@ -139,12 +194,66 @@ pub extern "C" fn drop_unwrapped_messages(ms: *const UnwrappedMessages) {
     safe_drop_ptr(ms)
 }
 
+/// Incremental synchronisation of a user state, handing out unwrapped messages in bounded batches.
+/// Only as many rounds of next messages are fetched as needed to fill a batch.
+pub struct SyncIterator<U> {
+    user: *mut U,
+    pending: Vec<UnwrappedMessage>,
+    done: bool,
+}
+
+impl<U> SyncIterator<U> {
+    pub(crate) fn new(user: *mut U) -> Self {
+        Self {
+            user,
+            pending: Vec::new(),
+            done: false,
+        }
+    }
+
+    /// Next batch of at most `batch_size` messages, empty once the user state has caught up.
+    pub(crate) unsafe fn next_batch<F>(
+        &mut self,
+        batch_size: usize,
+        mut fetch_next_msgs: F,
+    ) -> Option<UnwrappedMessages>
+    where
+        F: FnMut(&mut U) -> Vec<UnwrappedMessage>,
+    {
+        let user = self.user.as_mut()?;
+        while self.pending.len() < batch_size && !self.done {
+            let msgs = fetch_next_msgs(user);
+            self.done = msgs.is_empty();
+            self.pending.extend(msgs);
+        }
+        let n = core::cmp::min(batch_size, self.pending.len());
+        Some(self.pending.drain(..n).collect())
+    }
+}
+
+#[cfg(feature = "sync-client")]
+use iota_streams::app::transport::{
+    tangle::client::Client,
+    CachedTransport,
+};
+
 #[cfg(feature = "sync-client")]
-pub type TransportWrap = iota_streams::app::transport::tangle::client::Client;
+pub type TransportWrap = CachedTransport<Address, Message, Client>;
 
-#[cfg(not(feature = "sync-client"))]
+#[cfg(all(not(feature = "sync-client"), feature = "std"))]
+pub type TransportWrap = ShardedBucketTransport;
+
+#[cfg(all(not(feature = "sync-client"), not(feature = "std")))]
 pub type TransportWrap = Rc<core::cell::RefCell<BucketTransport>>;
 
+// Users created on different threads share the same `transport_t`, node client clones share
+// their connections and message cache, and the bucket is sharded behind read-write locks.
+#[cfg(feature = "std")]
+const _: fn() = || {
+    fn assert_thread_safe<T: Send + Sync>() {}
+    assert_thread_safe::<TransportWrap>();
+};
+
 #[no_mangle]
 pub extern "C" fn transport_new() -> *mut TransportWrap {
     safe_into_mut_ptr(TransportWrap::default())
@@ -152,6 +261,11 @@ pub extern "C" fn transport_new() -> *mut TransportWrap {
 
 #[no_mangle]
 pub extern "C" fn transport_drop(tsp: *mut TransportWrap) {
+    #[cfg(feature = "sync-client")]
+    if let Some(tsp) = unsafe { tsp.as_ref() } {
+        let _ = tsp.transport().flush_sends();
+        let _ = tsp.flush();
+    }
     safe_drop_mut_ptr(tsp)
 }
 
@@ -159,7 +273,316 @@ pub extern "C" fn transport_drop(tsp: *mut TransportWrap) {
 #[no_mangle]
 pub unsafe extern "C" fn transport_client_new_from_url(c_url: *const c_char) -> *mut TransportWrap {
     let url = CStr::from_ptr(c_url).to_str().unwrap();
-    safe_into_mut_ptr(TransportWrap::new_from_url(url))
+    safe_into_mut_ptr(TransportWrap::new(Client::new_from_url(url), 0))
+}
+
+/// Create a transport routing requests over a pool of nodes, null if a node client cannot be built.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_client_new_from_urls(
+    c_urls: *const *const c_char,
+    urls_count: size_t,
+) -> *mut TransportWrap {
+    if c_urls.is_null() {
+        return null_mut();
+    }
+    let mut urls = Vec::with_capacity(urls_count);
+    for &c_url in core::slice::from_raw_parts(c_urls, urls_count) {
+        if c_url.is_null() {
+            return null_mut();
+        }
+        match CStr::from_ptr(c_url).to_str() {
+            Ok(url) => urls.push(url),
+            Err(_) => return null_mut(),
+        }
+    }
+    Client::new_from_urls(&urls).map_or(null_mut(), |client| safe_into_mut_ptr(TransportWrap::new(client, 0)))
+}
+
+/// Run the background node requests of the transport and of the users created from it on a pool of
+/// `threads` threads of their own, zero goes back to the pool shared by the process. Each request
+/// in flight occupies a thread, so this bounds the sends and fetches in flight.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_set_executor_threads(tsp: *const TransportWrap, threads: size_t) -> Err {
+    tsp.as_ref().map_or(Err::NullArgument, |tsp| {
+        tsp.transport().set_executor_threads(threads);
+        Err::Ok
+    })
+}
+
+/// Keep the messages of up to `max_links` links in a cache shared by the transport and the users
+/// created from it afterwards, zero disables the cache. The limit counts links, not bytes. Messages saved in `backing_file` are
+/// loaded into the cache, which is saved back on `transport_cache_flush` and `transport_drop`.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_enable_cache(
+    tsp: *mut TransportWrap,
+    max_links: size_t,
+    backing_file: *const c_char,
+) -> Err {
+    tsp.as_mut().map_or(Err::NullArgument, |tsp| {
+        tsp.reset_cache(max_links);
+        backing_file.as_ref().map_or(Err::Ok, |_| {
+            CStr::from_ptr(backing_file).to_str().map_or(Err::BadArgument, |path| {
+                tsp.load(path).map_or(Err::OperationFailed, |_| Err::Ok)
+            })
+        })
+    })
+}
+
+/// Save cached messages into the backing file of the transport.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_cache_flush(tsp: *const TransportWrap) -> Err {
+    tsp.as_ref().map_or(Err::NullArgument, |tsp| {
+        tsp.flush().map_or(Err::OperationFailed, |_| Err::Ok)
+    })
+}
+
+/// Deliver new messages through node events to the transport and the users created from it
+/// afterwards. Next messages are then retrieved only once announced, and every
+/// `fallback_interval_ms` regardless.
+#[cfg(feature = "mqtt")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_enable_events(tsp: *mut TransportWrap, fallback_interval_ms: u64) -> Err {
+    tsp.as_mut().map_or(Err::NullArgument, |tsp| {
+        tsp.transport_mut()
+            .enable_events(core::time::Duration::from_millis(fallback_interval_ms));
+        Err::Ok
+    })
+}
+
+/// Block until a message is announced for a user of the transport or `timeout_ms` has passed.
+/// Sets `arrived` to 1 if one was, so that fetching next messages finds it.
+#[cfg(feature = "mqtt")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_wait_for_arrival(
+    arrived: *mut uint8_t,
+    tsp: *const TransportWrap,
+    timeout_ms: u64,
+) -> Err {
+    tsp.as_ref().map_or(Err::NullArgument, |tsp| {
+        arrived.as_mut().map_or(Err::NullArgument, |arrived| {
+            let timeout = core::time::Duration::from_millis(timeout_ms);
+            *arrived = if tsp.transport().wait_for_arrival(timeout) {
+                1
+            } else {
+                0
+            };
+            Err::Ok
+        })
+    })
+}
+
+#[cfg(feature = "metrics")]
+#[repr(C)]
+pub struct PhaseMetrics {
+    calls: u64,
+    total_ns: u64,
+    max_ns: u64,
+}
+
+#[cfg(feature = "metrics")]
+#[repr(C)]
+pub struct Metrics {
+    wrap: PhaseMetrics,
+    sign: PhaseMetrics,
+    send: PhaseMetrics,
+    index_lookup: PhaseMetrics,
+    fetch: PhaseMetrics,
+    unwrap: PhaseMetrics,
+    verify: PhaseMetrics,
+    cache_hits: u64,
+    cache_misses: u64,
+    bytes_in: u64,
+    bytes_out: u64,
+}
+
+/// Timers and counters of the hot paths of all users and transports since the last reset.
+#[cfg(feature = "metrics")]
+#[no_mangle]
+pub unsafe extern "C" fn streams_metrics_snapshot(r: *mut Metrics) -> Err {
+    use iota_streams::core::metrics::{
+        self,
+        Counter,
+        Phase,
+    };
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        let snapshot = metrics::snapshot();
+        let phase = |phase| {
+            let stats = snapshot.phase(phase);
+            PhaseMetrics {
+                calls: stats.calls,
+                total_ns: stats.total_ns,
+                max_ns: stats.max_ns,
+            }
+        };
+        *r = Metrics {
+            wrap: phase(Phase::Wrap),
+            sign: phase(Phase::Sign),
+            send: phase(Phase::Send),
+            index_lookup: phase(Phase::IndexLookup),
+            fetch: phase(Phase::Fetch),
+            unwrap: phase(Phase::Unwrap),
+            verify: phase(Phase::Verify),
+            cache_hits: snapshot.counter(Counter::CacheHit),
+            cache_misses: snapshot.counter(Counter::CacheMiss),
+            bytes_in: snapshot.counter(Counter::BytesIn),
+            bytes_out: snapshot.counter(Counter::BytesOut),
+        };
+        Err::Ok
+    })
+}
+
+#[cfg(feature = "metrics")]
+#[no_mangle]
+pub extern "C" fn streams_metrics_reset() {
+    iota_streams::core::metrics::reset()
+}
+
+#[cfg(feature = "sync-client")]
+#[repr(C)]
+pub struct NodeStats {
+    latency_us: u64,
+    requests: u64,
+    failures: u64,
+    consecutive_failures: u32,
+}
+
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_node_count(tsp: *const TransportWrap) -> size_t {
+    tsp.as_ref().map_or(0, |tsp| tsp.transport().node_stats().len())
+}
+
+/// Request statistics of the node at `index` in the pool of the transport.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_get_node_stats(r: *mut NodeStats, tsp: *const TransportWrap, index: size_t) -> Err {
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        tsp.as_ref().map_or(Err::NullArgument, |tsp| {
+            let stats = tsp.transport().node_stats();
+            stats.get(index).map_or(Err::BadArgument, |(_url, stats)| {
+                *r = NodeStats {
+                    latency_us: stats.latency_us,
+                    requests: stats.requests,
+                    failures: stats.failures,
+                    consecutive_failures: stats.consecutive_failures,
+                };
+                Err::Ok
+            })
+        })
+    })
+}
+
+/// Set the maximum number of node requests in flight when fetching the next messages of all
+/// publishers. Users copy the transport options when created, so set it before creating them.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_set_fetch_concurrency(
+    tsp: *mut TransportWrap,
+    max_concurrent_fetches: size_t,
+) -> Err {
+    use iota_streams::app::transport::{
+        tangle::client::RecvOptions,
+        TransportOptions as _,
+    };
+    tsp.as_mut().map_or(Err::NullArgument, |tsp| {
+        if max_concurrent_fetches == 0 {
+            return Err::BadArgument;
+        }
+        tsp.set_recv_options(RecvOptions { max_concurrent_fetches });
+        Err::Ok
+    })
+}
+
+/// Queue messages sent through the transport and the users created from it afterwards, sends then
+/// return once queued and block while `depth` messages are queued or in flight. Queued messages
+/// are submitted with up to `max_concurrent_sends` requests in flight, fewer while the node slows
+/// down. Failures are reported by `transport_flush_sends`. Reads through the transport serve
+/// queued messages until their submission completes.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_enable_send_queue(
+    tsp: *mut TransportWrap,
+    depth: size_t,
+    max_concurrent_sends: size_t,
+) -> Err {
+    use iota_streams::app::transport::tangle::client::SendQueueOptions;
+    tsp.as_mut().map_or(Err::NullArgument, |tsp| {
+        if depth == 0 || max_concurrent_sends == 0 {
+            return Err::BadArgument;
+        }
+        let options = SendQueueOptions {
+            depth,
+            max_concurrent_sends,
+        };
+        tsp.transport_mut()
+            .enable_send_queue(options)
+            .map_or(Err::OperationFailed, |_| Err::Ok)
+    })
+}
+
+/// Block until all messages queued on the transport have been submitted, fails if any submission
+/// has failed since the last flush. The links of the failed messages are returned in `failed`
+/// unless it is null, they are not sent again.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_flush_sends(failed: *mut *const Addresses, tsp: *const TransportWrap) -> Err {
+    tsp.as_ref().map_or(Err::NullArgument, |tsp| {
+        let links = tsp.transport().flush_sends();
+        let e = if links.is_empty() {
+            Err::Ok
+        } else {
+            Err::OperationFailed
+        };
+        if let Some(failed) = failed.as_mut() {
+            *failed = safe_into_ptr(links);
+        }
+        e
+    })
+}
+
+#[cfg(feature = "sync-client")]
+#[repr(C)]
+pub struct SendQueueStats {
+    queued: size_t,
+    in_flight: size_t,
+    concurrency: size_t,
+    depth: size_t,
+    failed: size_t,
+}
+
+/// State of the send queue of the transport. Sends block once `queued + in_flight` reaches
+/// `depth`, fails if the queue is not enabled. The links of the submissions failed since the last
+/// flush are returned in `failed_links` unless it is null.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn transport_get_send_queue_stats(
+    r: *mut SendQueueStats,
+    failed_links: *mut *const Addresses,
+    tsp: *const TransportWrap,
+) -> Err {
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        tsp.as_ref().map_or(Err::NullArgument, |tsp| {
+            tsp.transport()
+                .send_queue_stats()
+                .map_or(Err::OperationFailed, |stats| {
+                    *r = SendQueueStats {
+                        queued: stats.queued,
+                        in_flight: stats.in_flight,
+                        concurrency: stats.concurrency,
+                        depth: stats.depth,
+                        failed: stats.failed,
+                    };
+                    if let Some(failed_links) = failed_links.as_mut() {
+                        *failed_links = safe_into_ptr(stats.failed_links);
+                    }
+                    Err::Ok
+                })
+        })
+    })
 }
 
 #[cfg(feature = "sync-client")]
@@ -340,6 +763,106 @@ mod client_details {
 #[cfg(feature = "sync-client")]
 pub use client_details::*;
 
+#[cfg(feature = "sync-client")]
+mod client_requests {
+    use super::*;
+    use iota_streams::app::transport::tangle::client::Request as ClientRequest;
+
+    /// Node request running in the background on the executor shared by a transport and its users.
+    pub enum Request {
+        Send(ClientRequest<()>),
+        Recv(ClientRequest<Message>),
+    }
+
+    #[repr(C)]
+    pub enum RequestState {
+        Pending,
+        Ready,
+        Failed,
+    }
+
+    impl From<Option<bool>> for RequestState {
+        fn from(succeeded: Option<bool>) -> Self {
+            match succeeded {
+                None => Self::Pending,
+                Some(true) => Self::Ready,
+                Some(false) => Self::Failed,
+            }
+        }
+    }
+
+    impl Request {
+        fn state(&mut self) -> RequestState {
+            match self {
+                Request::Send(req) => req.succeeded().into(),
+                Request::Recv(req) => req.succeeded().into(),
+            }
+        }
+
+        fn wait(&mut self) -> RequestState {
+            match self {
+                Request::Send(req) => req.wait(),
+                Request::Recv(req) => req.wait(),
+            }
+            self.state()
+        }
+
+        /// Wait for a fetch request and take the retrieved message.
+        pub(crate) fn take_message(&mut self) -> Option<Message> {
+            match self {
+                Request::Recv(req) => {
+                    req.wait();
+                    req.take().and_then(|result| result.ok())
+                }
+                Request::Send(_) => None,
+            }
+        }
+    }
+
+    /// Publish wrapped messages in the background and return a handle to the pending request.
+    pub(crate) fn spawn_send(tsp: &TransportWrap, msgs: Vec<Message>) -> *mut Request {
+        safe_into_mut_ptr(Request::Send(tsp.transport().spawn_send_messages(msgs)))
+    }
+
+    /// Start fetching a message in the background. Once ready, the message is processed with
+    /// `auth_receive_msg_from_request` or `sub_receive_msg_from_request`.
+    #[no_mangle]
+    pub unsafe extern "C" fn transport_fetch_msg_async(
+        r: *mut *mut Request,
+        tsp: *mut TransportWrap,
+        link: *const Address,
+    ) -> Err {
+        r.as_mut().map_or(Err::NullArgument, |r| {
+            tsp.as_ref().map_or(Err::NullArgument, |tsp| {
+                link.as_ref().map_or(Err::NullArgument, |link| {
+                    *r = safe_into_mut_ptr(Request::Recv(tsp.transport().spawn_recv_message(link.clone())));
+                    Err::Ok
+                })
+            })
+        })
+    }
+
+    /// Check the state of a request without blocking.
+    #[no_mangle]
+    pub unsafe extern "C" fn streams_poll(req: *mut Request) -> RequestState {
+        req.as_mut().map_or(RequestState::Failed, |req| req.state())
+    }
+
+    /// Block until a request has completed.
+    #[no_mangle]
+    pub unsafe extern "C" fn streams_wait(req: *mut Request) -> RequestState {
+        req.as_mut().map_or(RequestState::Failed, |req| req.wait())
+    }
+
+    #[no_mangle]
+    pub extern "C" fn drop_request(req: *mut Request) {
+        safe_drop_mut_ptr(req)
+    }
+}
+
+#[cfg(feature = "sync-client")]
+pub use client_requests::*;
+
 #[repr(C)]
 pub struct MessageLinks {
     pub msg_link: *const Address,
@@ -472,6 +995,43 @@ pub extern "C" fn drop_buffer(b: Buffer) {
     b.drop()
 }
 
+/// Approximate size of the chunks handed to and requested from stream callbacks.
+pub const STREAM_CHUNK_SIZE: usize = 16 * 1024;
+
+/// Consumer of a chunk of a streamed export, returning 0 once the chunk has been taken.
+pub type StreamWriteCallback = extern "C" fn(*mut c_void, *const uint8_t, size_t) -> c_int;
+
+/// Producer of a streamed import, filling at most `cap` bytes of the buffer and storing their
+/// number, 0 at the end. Returns 0 on success.
+pub type StreamReadCallback = extern "C" fn(*mut c_void, *mut uint8_t, size_t, *mut size_t) -> c_int;
+
+pub(crate) fn stream_sink(
+    write: StreamWriteCallback,
+    ctx: *mut c_void,
+) -> impl FnMut(&[u8]) -> iota_streams::core::Result<()> {
+    move |chunk| {
+        if write(ctx, chunk.as_ptr(), chunk.len()) == 0 {
+            Ok(())
+        } else {
+            err!(StreamSinkFailure(chunk.len()))
+        }
+    }
+}
+
+pub(crate) fn stream_source(
+    read: StreamReadCallback,
+    ctx: *mut c_void,
+) -> impl FnMut(&mut [u8]) -> iota_streams::core::Result<usize> {
+    move |buf| {
+        let mut n = 0;
+        if read(ctx, buf.as_mut_ptr(), buf.len(), &mut n) == 0 && n <= buf.len() {
+            Ok(n)
+        } else {
+            err!(StreamSourceFailure)
+        }
+    }
+}
+
 #[repr(C)]
 pub struct PacketPayloads {
     public_payload: Buffer,
@@ -519,6 +1079,79 @@ impl PacketPayloads {
     }
 }
 
+/// Borrow an array of C-owned packet payloads as `Bytes` pairs without copying them.
+/// The returned pairs must be handed back to `forget_payloads` so the C buffers are not freed.
+pub(crate) unsafe fn borrow_payloads(payloads: *const PacketPayloads, count: size_t) -> Vec<(Bytes, Bytes)> {
+    core::slice::from_raw_parts(payloads, count)
+        .iter()
+        .map(|p| {
+            (
+                Bytes(Vec::from_raw_parts(
+                    p.public_payload.ptr as *mut u8,
+                    p.public_payload.size,
+                    p.public_payload.size,
+                )),
+                Bytes(Vec::from_raw_parts(
+                    p.masked_payload.ptr as *mut u8,
+                    p.masked_payload.size,
+                    p.masked_payload.size,
+                )),
+            )
+        })
+        .collect()
+}
+
+/// Borrow a C-owned pair of payloads as `Bytes` without copying them.
+/// The returned pair must be handed back to `forget_payloads` so the C buffers are not freed.
+pub(crate) unsafe fn borrow_payload_pair(
+    public_payload_ptr: *const uint8_t,
+    public_payload_size: size_t,
+    masked_payload_ptr: *const uint8_t,
+    masked_payload_size: size_t,
+) -> Vec<(Bytes, Bytes)> {
+    let mut payloads = Vec::with_capacity(1);
+    payloads.push((
+        Bytes(Vec::from_raw_parts(
+            public_payload_ptr as *mut u8,
+            public_payload_size,
+            public_payload_size,
+        )),
+        Bytes(Vec::from_raw_parts(
+            masked_payload_ptr as *mut u8,
+            masked_payload_size,
+            masked_payload_size,
+        )),
+    ));
+    payloads
+}
+
+pub(crate) fn forget_payloads(payloads: Vec<(Bytes, Bytes)>) {
+    for (public_payload, masked_payload) in payloads {
+        let _ = core::mem::ManuallyDrop::new(public_payload.0);
+        let _ = core::mem::ManuallyDrop::new(masked_payload.0);
+    }
+}
+
+/// Borrow a C-owned output buffer of `capacity` bytes; a null buffer is only valid with zero capacity.
+pub(crate) unsafe fn borrow_out_buffer<'a>(buf: *mut uint8_t, capacity: size_t) -> Option<&'a mut [u8]> {
+    if buf.is_null() {
+        if capacity == 0 {
+            Some(&mut [])
+        } else {
+            None
+        }
+    } else {
+        Some(core::slice::from_raw_parts_mut(buf, capacity))
+    }
+}
+
+/// Write message links into a C array with room for at least `links.len()` entries.
+pub(crate) unsafe fn write_links(r: *mut MessageLinks, links: Vec<(Address, Option<Address>)>) {
+    for (r, links) in core::slice::from_raw_parts_mut(r, links.len()).iter_mut().zip(links) {
+        *r = links.into();
+    }
+}
+
 #[no_mangle]
 pub extern "C" fn drop_payloads(payloads: PacketPayloads) {
     payloads.drop()
@@ -566,6 +1199,76 @@ pub unsafe extern "C" fn get_address_index_str(address: *mut Address) -> *mut c_
     })
 }
 
+// Sizes defined in channels.h
+const _: [(); 52] = [(); ADDRESS_SIZE];
+const _: [(); 65] = [(); INDEX_HEX_SIZE + 1];
+
+/// Write the `ADDRESS_SIZE` bytes of the binary form of the address.
+#[no_mangle]
+pub unsafe extern "C" fn address_to_bytes(bytes: *mut uint8_t, address: *const Address) -> Err {
+    address.as_ref().map_or(Err::NullArgument, |addr| {
+        (bytes as *mut [u8; ADDRESS_SIZE])
+            .as_mut()
+            .map_or(Err::NullArgument, |bytes| {
+                addr.write_bytes(bytes);
+                Err::Ok
+            })
+    })
+}
+
+/// Read an address from the `ADDRESS_SIZE` bytes of its binary form.
+#[no_mangle]
+pub unsafe extern "C" fn address_from_bytes(address: *mut *const Address, bytes: *const uint8_t) -> Err {
+    address.as_mut().map_or(Err::NullArgument, |address| {
+        (bytes as *const [u8; ADDRESS_SIZE])
+            .as_ref()
+            .map_or(Err::NullArgument, |bytes| {
+                *address = safe_into_ptr(Address::read_bytes(bytes));
+                Err::Ok
+            })
+    })
+}
+
+/// FNV-1a hash of the binary form of the address, stable across processes.
+#[no_mangle]
+pub unsafe extern "C" fn address_hash(address: *const Address) -> uint64_t {
+    address.as_ref().map_or(0, |addr| {
+        addr.appinst
+            .as_ref()
+            .iter()
+            .chain(addr.msgid.as_ref())
+            .fold(0xcbf29ce484222325, |hash, byte| {
+                (hash ^ *byte as u64).wrapping_mul(0x100000001b3)
+            })
+    })
+}
+
+/// Order addresses by their binary form, null addresses first.
+#[no_mangle]
+pub unsafe extern "C" fn address_cmp(a: *const Address, b: *const Address) -> c_int {
+    let key = |address: *const Address| {
+        address
+            .as_ref()
+            .map(|addr| (addr.appinst.as_ref(), addr.msgid.as_ref()))
+    };
+    key(a).cmp(&key(b)) as c_int
+}
+
+/// Write the hex encoded Tangle index of the address as a null terminated string of
+/// `ADDRESS_INDEX_SIZE` bytes.
+#[no_mangle]
+pub unsafe extern "C" fn get_address_index_into(index: *mut c_char, address: *const Address) -> Err {
+    address.as_ref().map_or(Err::NullArgument, |addr| {
+        (index as *mut [u8; INDEX_HEX_SIZE])
+            .as_mut()
+            .map_or(Err::NullArgument, |hex| {
+                addr.write_index_hex(hex);
+                *index.add(INDEX_HEX_SIZE) = 0;
+                Err::Ok
+            })
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn get_payload(msg: *const UnwrappedMessage) -> PacketPayloads {
     msg.as_ref().map_or(PacketPayloads::default(), handle_message_contents)
@@ -604,3 +1307,9 @@ pub use auth::*;
 
 mod sub;
 pub use sub::*;
+
+mod manager;
+pub use manager::*;
+
+mod arena;
+pub use arena::*;
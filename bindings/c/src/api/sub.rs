@@ -50,6 +50,33 @@ pub unsafe extern "C" fn sub_recover(
     })
 }
 
+/// Recover a Subscriber from a checkpoint exported with the seed as password, fetching only the messages
+/// published after the checkpoint
+#[no_mangle]
+pub unsafe extern "C" fn sub_recover_from_checkpoint(
+    c_sub: *mut *mut Subscriber,
+    c_seed: *const c_char,
+    checkpoint: Buffer,
+    transport: *mut TransportWrap,
+) -> Err {
+    if c_seed == null() {
+        return Err::NullArgument;
+    }
+
+    CStr::from_ptr(c_seed).to_str().map_or(Err::BadArgument, |seed| {
+        transport.as_ref().map_or(Err::NullArgument, |tsp| {
+            c_sub.as_mut().map_or(Err::NullArgument, |sub| {
+                let bytes_vec: Vec<_> = checkpoint.into();
+                let recovered = Subscriber::recover_from_checkpoint(seed, &bytes_vec, tsp.clone());
+                recovered.map_or(Err::OperationFailed, |user| {
+                    *sub = safe_into_mut_ptr(user);
+                    Err::Ok
+                })
+            })
+        })
+    })
+}
+
 /// Import an Author instance from an encrypted binary array
 #[no_mangle]
 pub unsafe extern "C" fn sub_import(
@@ -93,6 +120,124 @@ pub unsafe extern "C" fn sub_export(buf: *mut Buffer, c_sub: *mut Subscriber, c_
     })
 }
 
+/// Export a Subscriber instance encrypted, handing the state over to `write` in chunks
+#[no_mangle]
+pub unsafe extern "C" fn sub_export_to_writer(
+    c_sub: *const Subscriber,
+    c_password: *const c_char,
+    write: Option<StreamWriteCallback>,
+    ctx: *mut c_void,
+) -> Err {
+    if c_password == null() {
+        return Err::NullArgument;
+    }
+
+    CStr::from_ptr(c_password).to_str().map_or(Err::BadArgument, |password| {
+        c_sub.as_ref().map_or(Err::NullArgument, |user| {
+            write.map_or(Err::NullArgument, |write| {
+                user.export_to(password, STREAM_CHUNK_SIZE, stream_sink(write, ctx))
+                    .map_or(Err::OperationFailed, |_| Err::Ok)
+            })
+        })
+    })
+}
+
+/// Import a Subscriber instance from an encrypted state pulled from `read` in chunks
+#[no_mangle]
+pub unsafe extern "C" fn sub_import_from_reader(
+    c_sub: *mut *mut Subscriber,
+    read: Option<StreamReadCallback>,
+    ctx: *mut c_void,
+    c_password: *const c_char,
+    transport: *mut TransportWrap,
+) -> Err {
+    if c_password == null() {
+        return Err::NullArgument;
+    }
+
+    CStr::from_ptr(c_password).to_str().map_or(Err::BadArgument, |password| {
+        transport.as_ref().map_or(Err::NullArgument, |tsp| {
+            c_sub.as_mut().map_or(Err::NullArgument, |sub| {
+                read.map_or(Err::NullArgument, |read| {
+                    Subscriber::import_from(password, STREAM_CHUNK_SIZE, stream_source(read, ctx), tsp.clone())
+                        .map_or(Err::OperationFailed, |user| {
+                            *sub = safe_into_mut_ptr(user);
+                            Err::Ok
+                        })
+                })
+            })
+        })
+    })
+}
+
+/// Write the state of a Subscriber instance into a new encrypted journal file
+#[no_mangle]
+pub unsafe extern "C" fn sub_journal_create(
+    c_journal: *mut *mut StateJournal,
+    c_subscriber: *const Subscriber,
+    c_path: *const c_char,
+    c_password: *const c_char,
+) -> Err {
+    if c_path == null() || c_password == null() {
+        return Err::NullArgument;
+    }
+
+    let (path, password) = match (CStr::from_ptr(c_path).to_str(), CStr::from_ptr(c_password).to_str()) {
+        (Ok(path), Ok(password)) => (path, password),
+        _ => return Err::BadArgument,
+    };
+
+    c_subscriber.as_ref().map_or(Err::NullArgument, |user| {
+        c_journal.as_mut().map_or(Err::NullArgument, |journal| {
+            user.create_journal(path, password).map_or(Err::OperationFailed, |j| {
+                *journal = safe_into_mut_ptr(j);
+                Err::Ok
+            })
+        })
+    })
+}
+
+/// Recover a Subscriber instance from an encrypted journal file
+#[no_mangle]
+pub unsafe extern "C" fn sub_journal_open(
+    c_subscriber: *mut *mut Subscriber,
+    c_journal: *mut *mut StateJournal,
+    c_path: *const c_char,
+    c_password: *const c_char,
+    transport: *mut TransportWrap,
+) -> Err {
+    if c_path == null() || c_password == null() {
+        return Err::NullArgument;
+    }
+
+    let (path, password) = match (CStr::from_ptr(c_path).to_str(), CStr::from_ptr(c_password).to_str()) {
+        (Ok(path), Ok(password)) => (path, password),
+        _ => return Err::BadArgument,
+    };
+
+    transport.as_ref().map_or(Err::NullArgument, |tsp| {
+        c_subscriber.as_mut().map_or(Err::NullArgument, |subscriber| {
+            c_journal.as_mut().map_or(Err::NullArgument, |journal| {
+                Subscriber::open_journal(path, password, tsp.clone()).map_or(Err::OperationFailed, |(user, j)| {
+                    *subscriber = safe_into_mut_ptr(user);
+                    *journal = safe_into_mut_ptr(j);
+                    Err::Ok
+                })
+            })
+        })
+    })
+}
+
+/// Append the changes of Subscriber state since the last sync to its journal
+#[no_mangle]
+pub unsafe extern "C" fn sub_journal_sync(journal: *mut StateJournal, c_subscriber: *const Subscriber) -> Err {
+    c_subscriber.as_ref().map_or(Err::NullArgument, |user| {
+        journal.as_mut().map_or(Err::NullArgument, |journal| {
+            user.sync_journal(journal).map_or(Err::OperationFailed, |_| Err::Ok)
+        })
+    })
+}
+
 #[no_mangle]
 pub extern "C" fn sub_drop(user: *mut Subscriber) {
     safe_drop_mut_ptr(user)
@@ -254,6 +399,203 @@ pub unsafe extern "C" fn sub_send_signed_packet(
     })
 }
 
+/// Send a chain of Tagged packets, the first one attached to `link_to` and each following one to the
+/// previous packet. `r` must point to an array of `payloads_count` message links, filled in chain order.
+#[no_mangle]
+pub unsafe extern "C" fn sub_send_tagged_packets_batch(
+    r: *mut MessageLinks,
+    user: *mut Subscriber,
+    link_to: MessageLinks,
+    payloads: *const PacketPayloads,
+    payloads_count: size_t,
+) -> Err {
+    if r == null_mut() || payloads == null() {
+        return Err::NullArgument;
+    }
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        link_to
+            .into_seq_link(user.is_multi_branching())
+            .map_or(Err::NullArgument, |link_to| {
+                let payloads = borrow_payloads(payloads, payloads_count);
+                let e = user
+                    .send_tagged_packets(link_to, &payloads)
+                    .map_or(Err::OperationFailed, |links| {
+                        write_links(r, links);
+                        Err::Ok
+                    });
+                forget_payloads(payloads);
+                e
+            })
+    })
+}
+
+/// Send a chain of Signed packets, the first one attached to `link_to` and each following one to the
+/// previous packet. `r` must point to an array of `payloads_count` message links, filled in chain order.
+#[no_mangle]
+pub unsafe extern "C" fn sub_send_signed_packets_batch(
+    r: *mut MessageLinks,
+    user: *mut Subscriber,
+    link_to: MessageLinks,
+    payloads: *const PacketPayloads,
+    payloads_count: size_t,
+) -> Err {
+    if r == null_mut() || payloads == null() {
+        return Err::NullArgument;
+    }
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        link_to
+            .into_seq_link(user.is_multi_branching())
+            .map_or(Err::NullArgument, |link_to| {
+                let payloads = borrow_payloads(payloads, payloads_count);
+                let e = user
+                    .send_signed_packets(link_to, &payloads)
+                    .map_or(Err::OperationFailed, |links| {
+                        write_links(r, links);
+                        Err::Ok
+                    });
+                forget_payloads(payloads);
+                e
+            })
+    })
+}
+
+/// Wrap a Tagged packet and publish it in the background. Links of the packet are available right
+/// away; `req` receives the handle of the pending publication, to be polled with `streams_poll`.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn sub_send_tagged_packet_async(
+    r: *mut MessageLinks,
+    req: *mut *mut Request,
+    user: *mut Subscriber,
+    link_to: MessageLinks,
+    public_payload_ptr: *const uint8_t,
+    public_payload_size: size_t,
+    masked_payload_ptr: *const uint8_t,
+    masked_payload_size: size_t,
+) -> Err {
+    if r == null_mut() {
+        return Err::NullArgument;
+    }
+    req.as_mut().map_or(Err::NullArgument, |req| {
+        user.as_mut().map_or(Err::NullArgument, |user| {
+            link_to
+                .into_seq_link(user.is_multi_branching())
+                .map_or(Err::NullArgument, |link_to| {
+                    let payloads = borrow_payload_pair(
+                        public_payload_ptr,
+                        public_payload_size,
+                        masked_payload_ptr,
+                        masked_payload_size,
+                    );
+                    let e = user
+                        .wrap_tagged_packets(link_to, &payloads)
+                        .map_or(Err::OperationFailed, |(msgs, links)| {
+                            write_links(r, links);
+                            *req = spawn_send(user.get_transport(), msgs);
+                            Err::Ok
+                        });
+                    forget_payloads(payloads);
+                    e
+                })
+        })
+    })
+}
+
+/// Wrap a Signed packet and publish it in the background. Links of the packet are available right
+/// away; `req` receives the handle of the pending publication, to be polled with `streams_poll`.
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn sub_send_signed_packet_async(
+    r: *mut MessageLinks,
+    req: *mut *mut Request,
+    user: *mut Subscriber,
+    link_to: MessageLinks,
+    public_payload_ptr: *const uint8_t,
+    public_payload_size: size_t,
+    masked_payload_ptr: *const uint8_t,
+    masked_payload_size: size_t,
+) -> Err {
+    if r == null_mut() {
+        return Err::NullArgument;
+    }
+    req.as_mut().map_or(Err::NullArgument, |req| {
+        user.as_mut().map_or(Err::NullArgument, |user| {
+            link_to
+                .into_seq_link(user.is_multi_branching())
+                .map_or(Err::NullArgument, |link_to| {
+                    let payloads = borrow_payload_pair(
+                        public_payload_ptr,
+                        public_payload_size,
+                        masked_payload_ptr,
+                        masked_payload_size,
+                    );
+                    let e = user
+                        .wrap_signed_packets(link_to, &payloads)
+                        .map_or(Err::OperationFailed, |(msgs, links)| {
+                            write_links(r, links);
+                            *req = spawn_send(user.get_transport(), msgs);
+                            Err::Ok
+                        });
+                    forget_payloads(payloads);
+                    e
+                })
+        })
+    })
+}
+
+/// Process the message retrieved by a completed `transport_fetch_msg_async` request
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn sub_receive_msg_from_request(
+    r: *mut *const UnwrappedMessage,
+    user: *mut Subscriber,
+    req: *mut Request,
+) -> Err {
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        user.as_mut().map_or(Err::NullArgument, |user| {
+            req.as_mut().map_or(Err::NullArgument, |req| {
+                req.take_message().map_or(Err::OperationFailed, |msg| {
+                    user.handle_msg(msg).map_or(Err::OperationFailed, |u| {
+                        *r = safe_into_ptr(u);
+                        Err::Ok
+                    })
+                })
+            })
+        })
+    })
+}
+
+/// Process the messages retrieved by completed `transport_fetch_msg_async` requests, unwrapping
+/// packets on up to `workers` threads. Requests that failed to fetch a message are skipped
+#[cfg(feature = "sync-client")]
+#[no_mangle]
+pub unsafe extern "C" fn sub_process_batch(
+    r: *mut *const UnwrappedMessages,
+    user: *mut Subscriber,
+    reqs: *const *mut Request,
+    reqs_count: size_t,
+    workers: size_t,
+) -> Err {
+    if reqs.is_null() && reqs_count != 0 {
+        return Err::NullArgument;
+    }
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        user.as_mut().map_or(Err::NullArgument, |user| {
+            let reqs: &[*mut Request] = if reqs_count == 0 {
+                &[]
+            } else {
+                core::slice::from_raw_parts(reqs, reqs_count)
+            };
+            let msgs = reqs
+                .iter()
+                .filter_map(|&req| req.as_mut().and_then(|req| req.take_message()))
+                .collect();
+            *r = safe_into_ptr(user.process_batch(msgs, workers));
+            Err::Ok
+        })
+    })
+}
+
 /// Process a keyload message
 #[no_mangle]
 pub unsafe extern "C" fn sub_receive_keyload(user: *mut Subscriber, link: *const Address) -> Err {
@@ -322,6 +664,76 @@ pub unsafe extern "C" fn sub_receive_signed_packet(
     })
 }
 
+/// Process a Tagged packet message, decrypting payloads into caller-provided buffers.
+/// Fails without touching `public_len`/`masked_len` if a payload does not fit its buffer.
+#[no_mangle]
+pub unsafe extern "C" fn sub_receive_tagged_packet_into(
+    public_len: *mut size_t,
+    masked_len: *mut size_t,
+    user: *mut Subscriber,
+    link: *const Address,
+    public_buf: *mut uint8_t,
+    public_cap: size_t,
+    masked_buf: *mut uint8_t,
+    masked_cap: size_t,
+) -> Err {
+    public_len.as_mut().map_or(Err::NullArgument, |public_len| {
+        masked_len.as_mut().map_or(Err::NullArgument, |masked_len| {
+            user.as_mut().map_or(Err::NullArgument, |user| {
+                link.as_ref().map_or(Err::NullArgument, |link| {
+                    borrow_out_buffer(public_buf, public_cap).map_or(Err::NullArgument, |public_buf| {
+                        borrow_out_buffer(masked_buf, masked_cap).map_or(Err::NullArgument, |masked_buf| {
+                            user.receive_tagged_packet_into(link, public_buf, masked_buf).map_or(
+                                Err::OperationFailed,
+                                |(public_size, masked_size)| {
+                                    *public_len = public_size;
+                                    *masked_len = masked_size;
+                                    Err::Ok
+                                },
+                            )
+                        })
+                    })
+                })
+            })
+        })
+    })
+}
+
+/// Process a Signed packet message, decrypting payloads into caller-provided buffers.
+/// Fails without touching `public_len`/`masked_len` if a payload does not fit its buffer.
+#[no_mangle]
+pub unsafe extern "C" fn sub_receive_signed_packet_into(
+    public_len: *mut size_t,
+    masked_len: *mut size_t,
+    user: *mut Subscriber,
+    link: *const Address,
+    public_buf: *mut uint8_t,
+    public_cap: size_t,
+    masked_buf: *mut uint8_t,
+    masked_cap: size_t,
+) -> Err {
+    public_len.as_mut().map_or(Err::NullArgument, |public_len| {
+        masked_len.as_mut().map_or(Err::NullArgument, |masked_len| {
+            user.as_mut().map_or(Err::NullArgument, |user| {
+                link.as_ref().map_or(Err::NullArgument, |link| {
+                    borrow_out_buffer(public_buf, public_cap).map_or(Err::NullArgument, |public_buf| {
+                        borrow_out_buffer(masked_buf, masked_cap).map_or(Err::NullArgument, |masked_buf| {
+                            user.receive_signed_packet_into(link, public_buf, masked_buf).map_or(
+                                Err::OperationFailed,
+                                |(_pk, public_size, masked_size)| {
+                                    *public_len = public_size;
+                                    *masked_len = masked_size;
+                                    Err::Ok
+                                },
+                            )
+                        })
+                    })
+                })
+            })
+        })
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn sub_gen_next_msg_ids(ids: *mut *const NextMsgIds, user: *mut Subscriber) -> Err {
     user.as_mut().map_or(Err::NullArgument, |user| {
@@ -333,6 +745,25 @@ pub unsafe extern "C" fn sub_gen_next_msg_ids(ids: *mut *const NextMsgIds, user:
     })
 }
 
+/// Same as `sub_gen_next_msg_ids`, with the ids allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn sub_gen_next_msg_ids_in(
+    ids: *mut *const NextMsgIds,
+    user: *mut Subscriber,
+    arena: *mut Arena,
+) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        ids.as_mut().map_or(Err::NullArgument, |ids| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                let next_msg_ids = arena.next_msg_ids();
+                next_msg_ids.extend(user.gen_next_msg_ids(user.is_multi_branching()));
+                *ids = next_msg_ids;
+                Err::Ok
+            })
+        })
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn sub_receive_keyload_from_ids(
     r: *mut MessageLinks,
@@ -389,6 +820,25 @@ pub unsafe extern "C" fn sub_fetch_next_msgs(r: *mut *const UnwrappedMessages, u
     })
 }
 
+/// Same as `sub_fetch_next_msgs`, with the messages allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn sub_fetch_next_msgs_in(
+    umsgs: *mut *const UnwrappedMessages,
+    user: *mut Subscriber,
+    arena: *mut Arena,
+) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        umsgs.as_mut().map_or(Err::NullArgument, |umsgs| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                let ms = arena.messages();
+                ms.extend(user.fetch_next_msgs());
+                *umsgs = ms;
+                Err::Ok
+            })
+        })
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn sub_fetch_prev_msg(m: *mut *const UnwrappedMessage, user: *mut Subscriber, address: *const Address) -> Err {
     m.as_mut().map_or(Err::NullArgument, |m| {
@@ -417,6 +867,30 @@ pub unsafe extern "C" fn sub_fetch_prev_msgs(umsgs: *mut *const UnwrappedMessage
     })
 }
 
+/// Fetch at most `num_msgs` messages preceding `address`, oldest first, walking back no longer
+/// than `timeout_ms`. The messages reached by then are returned.
+#[no_mangle]
+pub unsafe extern "C" fn sub_fetch_prev_msgs_window(
+    umsgs: *mut *const UnwrappedMessages,
+    user: *mut Subscriber,
+    address: *const Address,
+    num_msgs: size_t,
+    timeout_ms: u64,
+) -> Err {
+    umsgs.as_mut().map_or(Err::NullArgument, |umsgs| {
+        user.as_mut().map_or(Err::NullArgument, |user| {
+            address.as_ref().map_or(Err::NullArgument, |addr| {
+                let timeout = core::time::Duration::from_millis(timeout_ms);
+                user.fetch_prev_msgs_window(addr, num_msgs, timeout)
+                    .map_or(Err::OperationFailed, |msgs| {
+                        *umsgs = safe_into_ptr(msgs);
+                        Err::Ok
+                    })
+            })
+        })
+    })
+}
+
 
 #[no_mangle]
 pub unsafe extern "C" fn sub_sync_state(r: *mut *const UnwrappedMessages, user: *mut Subscriber) -> Err {
@@ -436,18 +910,153 @@ pub unsafe extern "C" fn sub_sync_state(r: *mut *const UnwrappedMessages, user:
     })
 }
 
+/// Same as `sub_sync_state`, with the messages allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn sub_sync_state_in(
+    umsgs: *mut *const UnwrappedMessages,
+    user: *mut Subscriber,
+    arena: *mut Arena,
+) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        umsgs.as_mut().map_or(Err::NullArgument, |umsgs| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                let ms = arena.messages();
+                loop {
+                    let m = user.fetch_next_msgs();
+                    if m.is_empty() {
+                        break;
+                    }
+                    ms.extend(m);
+                }
+                *umsgs = ms;
+                Err::Ok
+            })
+        })
+    })
+}
+
+pub type SubSync = SyncIterator<Subscriber>;
+
+/// Start synchronising the user state incrementally. The user must outlive the returned iterator.
+#[no_mangle]
+pub unsafe extern "C" fn sub_sync_begin(r: *mut *mut SubSync, user: *mut Subscriber) -> Err {
+    if user == null_mut() {
+        return Err::NullArgument;
+    }
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        *r = safe_into_mut_ptr(SubSync::new(user));
+        Err::Ok
+    })
+}
+
+/// Fetch and unwrap the next batch of at most `batch_size` messages. An empty batch means the user
+/// state has caught up.
+#[no_mangle]
+pub unsafe extern "C" fn sub_sync_next(
+    r: *mut *const UnwrappedMessages,
+    sync: *mut SubSync,
+    batch_size: size_t,
+) -> Err {
+    if batch_size == 0 {
+        return Err::BadArgument;
+    }
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        sync.as_mut().map_or(Err::NullArgument, |sync| {
+            sync.next_batch(batch_size, |user| user.fetch_next_msgs())
+                .map_or(Err::NullArgument, |ms| {
+                    *r = safe_into_ptr(ms);
+                    Err::Ok
+                })
+        })
+    })
+}
+
+/// Same as `sub_sync_next`, with the batch allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn sub_sync_next_in(
+    r: *mut *const UnwrappedMessages,
+    sync: *mut SubSync,
+    batch_size: size_t,
+    arena: *mut Arena,
+) -> Err {
+    if batch_size == 0 {
+        return Err::BadArgument;
+    }
+    r.as_mut().map_or(Err::NullArgument, |r| {
+        sync.as_mut().map_or(Err::NullArgument, |sync| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                sync.next_batch(batch_size, |user| user.fetch_next_msgs())
+                    .map_or(Err::NullArgument, |m| {
+                        let ms = arena.messages();
+                        ms.extend(m);
+                        *r = ms;
+                        Err::Ok
+                    })
+            })
+        })
+    })
+}
+
+#[no_mangle]
+pub extern "C" fn sub_sync_end(sync: *mut SubSync) {
+    safe_drop_mut_ptr(sync)
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn sub_fetch_state(state: *mut *const UserState, user: *mut Subscriber) -> Err {
     user.as_mut().map_or(Err::NullArgument, |user| {
         state.as_mut().map_or(Err::NullArgument, |state| {
-            user.fetch_state().map_or(Err::OperationFailed, |st| {
-                *state = safe_into_ptr(st);
+            user.fetch_key_state().map_or(Err::OperationFailed, |st| {
+                *state = safe_into_ptr(user_state_from(st));
                 Err::Ok
             })
         })
     })
 }
 
+/// Same as `sub_fetch_state`, with the state allocated in `arena`.
+#[no_mangle]
+pub unsafe extern "C" fn sub_fetch_state_in(
+    state: *mut *const UserState,
+    user: *mut Subscriber,
+    arena: *mut Arena,
+) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        state.as_mut().map_or(Err::NullArgument, |state| {
+            arena.as_mut().map_or(Err::NullArgument, |arena| {
+                user.fetch_key_state().map_or(Err::OperationFailed, |st| {
+                    let user_state = arena.user_state();
+                    user_state.extend(st.into_iter().map(|(pk, cursor)| (pk.into(), cursor)));
+                    *state = user_state;
+                    Err::Ok
+                })
+            })
+        })
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn sub_fetch_link_of(link: *mut *const Address, user: *mut Subscriber, pub_key: *const PublicKey) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        link.as_mut().map_or(Err::NullArgument, |link| {
+            pub_key.as_ref().map_or(Err::NullArgument, |pub_key| {
+                user.fetch_state_of(pub_key).map_or(Err::OperationFailed, |cursor| {
+                    *link = cursor.map_or(null(), |cursor| safe_into_ptr(cursor.link));
+                    Err::Ok
+                })
+            })
+        })
+    })
+}
+
+#[no_mangle]
+pub unsafe extern "C" fn sub_set_link_store_policy(user: *mut Subscriber, policy: uint8_t, window: size_t) -> Err {
+    user.as_mut().map_or(Err::NullArgument, |user| {
+        user.set_link_store_policy(get_link_store_policy(policy, window));
+        Err::Ok
+    })
+}
+
 #[no_mangle]
 pub unsafe extern "C" fn sub_store_psk(c_pskid: *mut *const PskId, c_user: *mut Subscriber, c_psk_seed: *const c_char) -> Err {
     if c_psk_seed == null() {
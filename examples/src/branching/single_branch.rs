@@ -278,6 +278,8 @@ pub fn example<T: Transport>(transport: Rc<RefCell<T>>, channel_impl: ChannelTyp
     {
         let msgs = subscriberB.fetch_prev_msgs(&signed_packet_link, 5)?;
         try_or!(msgs.len() == 5, ValueMismatch(5, msgs.len()))?;
+        let window = subscriberB.fetch_prev_msgs_window(&signed_packet_link, 5, core::time::Duration::from_secs(60))?;
+        try_or!(window.len() == 5, ValueMismatch(5, window.len()))?;
         println!("Found {} messages", msgs.len());
         println!("  SubscriberB: {}", subscriberB);
     }
@@ -22,6 +22,40 @@ pub enum ChannelType {
     SingleDepth,
 }
 
+/// Policy for the spongos states of processed messages kept in the link store.
+#[derive(Clone, Copy)]
+pub enum LinkStorePolicy {
+    /// Keep the states of all the messages.
+    KeepAll,
+    /// Keep only the states linked to by the publisher cursors and the announcement, plus the
+    /// given number of most recent ones. Evicted states are restored from the transport on demand.
+    Bounded(usize),
+}
+
+impl Default for LinkStorePolicy {
+    fn default() -> Self {
+        LinkStorePolicy::KeepAll
+    }
+}
+
+/// Key of the sender the keys shared with the recipients of a keyload are derived from.
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+pub enum KeyloadKeyExchange {
+    /// A new ephemeral X25519 key for every keyload message. A leaked sender key does not expose
+    /// the session keys of keyloads sent before.
+    Ephemeral,
+    /// The X25519 key of the sender. The key shared with each recipient is derived once and cached,
+    /// so that keyloads cost no key exchange for recipients already known, but a leaked sender key
+    /// exposes the session key of every keyload sent.
+    Static,
+}
+
+impl Default for KeyloadKeyExchange {
+    fn default() -> Self {
+        KeyloadKeyExchange::Ephemeral
+    }
+}
+
 use iota_streams_core::psk;
 pub use iota_streams_core::psk::{
     Psk,
@@ -1,7 +1,12 @@
-use core::fmt;
+use core::{
+    fmt,
+    iter,
+    slice,
+};
 use iota_streams_core::Result;
 
 use iota_streams_core::prelude::{
+    Box,
     HashMap,
     Vec,
 };
@@ -10,6 +15,26 @@ use iota_streams_core_edsig::{
     signature::ed25519,
 };
 
+/// Iterator over identities and precalculated x25519 pks of the participants.
+pub type DynKeys<'a> = Box<dyn Iterator<Item = (&'a ed25519::PublicKey, &'a x25519::PublicKey)> + 'a>;
+/// Iterator over identities of the participants and their additional info.
+pub type DynIter<'a, Info> = Box<dyn Iterator<Item = (&'a ed25519::PublicKey, &'a Info)> + 'a>;
+/// Iterator over identities of the participants and mutable references to their additional info.
+pub type DynIterMut<'a, Info> = Box<dyn Iterator<Item = (&'a ed25519::PublicKey, &'a mut Info)> + 'a>;
+
+/// Iterator over identities and precalculated x25519 pks of the participants of a `PublicKeyMap`.
+pub type Keys<'a, Info> = iter::Map<
+    slice::Iter<'a, KeyEntry<Info>>,
+    fn(&'a KeyEntry<Info>) -> (&'a ed25519::PublicKey, &'a x25519::PublicKey),
+>;
+/// Iterator over identities of the participants of a `PublicKeyMap` and their additional info.
+pub type Iter<'a, Info> =
+    iter::Map<slice::Iter<'a, KeyEntry<Info>>, fn(&'a KeyEntry<Info>) -> (&'a ed25519::PublicKey, &'a Info)>;
+/// Iterator over identities of the participants of a `PublicKeyMap` and mutable references to
+/// their additional info.
+pub type IterMut<'a, Info> =
+    iter::Map<slice::IterMut<'a, KeyEntry<Info>>, fn(&'a mut KeyEntry<Info>) -> (&'a ed25519::PublicKey, &'a mut Info)>;
+
 pub trait PublicKeyStore<Info>: Default {
     fn filter<'a>(&'a self, pks: &'a [ed25519::PublicKey]) -> Vec<(&'a ed25519::PublicKey, &'a x25519::PublicKey)>;
 
@@ -18,20 +43,51 @@ pub trait PublicKeyStore<Info>: Default {
     fn get_mut(&mut self, pk: &ed25519::PublicKey) -> Option<&mut Info>;
     fn get_ke_pk(&self, pk: &ed25519::PublicKey) -> Option<&x25519::PublicKey>;
     fn insert(&mut self, pk: ed25519::PublicKey, info: Info) -> Result<()>;
-    fn keys(&self) -> Vec<(&ed25519::PublicKey, &x25519::PublicKey)>;
-    fn iter(&self) -> Vec<(&ed25519::PublicKey, &Info)>;
-    fn iter_mut(&mut self) -> Vec<(&ed25519::PublicKey, &mut Info)>;
+    fn len(&self) -> usize;
+    fn keys(&self) -> DynKeys<'_>;
+    fn iter(&self) -> DynIter<'_, Info>;
+    fn iter_mut(&mut self) -> DynIterMut<'_, Info>;
+}
+
+/// User identity -- ed25519 pk -- along with
+/// a precalculated corresponding x25519 pk and some additional info.
+pub struct KeyEntry<Info> {
+    pub sig_pk: ed25519::PublicKey,
+    pub ke_pk: x25519::PublicKey,
+    pub info: Info,
 }
 
 pub struct PublicKeyMap<Info> {
-    /// Map from user identity -- ed25519 pk -- to
-    /// a precalculated corresponding x25519 pk and some additional info.
-    pks: HashMap<ed25519::PublicKeyWrap, (x25519::PublicKey, Info)>,
+    /// Entries kept contiguous in insertion order so that walking all of them doesn't allocate.
+    entries: Vec<KeyEntry<Info>>,
+    /// Position of each user identity in `entries`.
+    index: HashMap<ed25519::PublicKeyWrap, usize>,
 }
 
 impl<Info> PublicKeyMap<Info> {
     pub fn new() -> Self {
-        Self { pks: HashMap::new() }
+        Self {
+            entries: Vec::new(),
+            index: HashMap::new(),
+        }
+    }
+
+    fn entry(&self, pk: &ed25519::PublicKey) -> Option<&KeyEntry<Info>> {
+        self.index.get(pk.into()).map(|i| &self.entries[*i])
+    }
+
+    /// Walk the entries without boxing the iterator, unlike `PublicKeyStore::keys`.
+    pub fn keys<'a>(&'a self) -> Keys<'a, Info> {
+        let f: fn(&'a KeyEntry<Info>) -> (&'a ed25519::PublicKey, &'a x25519::PublicKey) = |e| (&e.sig_pk, &e.ke_pk);
+        self.entries.iter().map(f)
+    }
+    pub fn iter<'a>(&'a self) -> Iter<'a, Info> {
+        let f: fn(&'a KeyEntry<Info>) -> (&'a ed25519::PublicKey, &'a Info) = |e| (&e.sig_pk, &e.info);
+        self.entries.iter().map(f)
+    }
+    pub fn iter_mut<'a>(&'a mut self) -> IterMut<'a, Info> {
+        let f: fn(&'a mut KeyEntry<Info>) -> (&'a ed25519::PublicKey, &'a mut Info) = |e| (&e.sig_pk, &mut e.info);
+        self.entries.iter_mut().map(f)
     }
 }
 
@@ -44,39 +100,53 @@ impl<Info> Default for PublicKeyMap<Info> {
 impl<Info> PublicKeyStore<Info> for PublicKeyMap<Info> {
     fn filter<'a>(&'a self, pks: &'a [ed25519::PublicKey]) -> Vec<(&'a ed25519::PublicKey, &'a x25519::PublicKey)> {
         pks.iter()
-            .filter_map(|pk| self.pks.get_key_value(pk.into()).map(|(e, (x, _))| (&e.0, x)))
+            .filter_map(|pk| self.entry(pk).map(|e| (&e.sig_pk, &e.ke_pk)))
             .collect()
     }
 
     fn get(&self, pk: &ed25519::PublicKey) -> Option<&Info> {
-        self.pks.get(pk.into()).map(|(_x, i)| i)
+        self.entry(pk).map(|e| &e.info)
     }
     fn get_mut(&mut self, pk: &ed25519::PublicKey) -> Option<&mut Info> {
-        self.pks.get_mut(pk.into()).map(|(_x, i)| i)
+        let entries = &mut self.entries;
+        self.index.get(pk.into()).map(move |i| &mut entries[*i].info)
     }
     fn get_ke_pk(&self, pk: &ed25519::PublicKey) -> Option<&x25519::PublicKey> {
-        self.pks.get(pk.into()).map(|(x, _i)| x)
+        self.entry(pk).map(|e| &e.ke_pk)
     }
     fn insert(&mut self, pk: ed25519::PublicKey, info: Info) -> Result<()> {
-        let xpk = x25519::public_from_ed25519(&pk)?;
-        self.pks.insert(pk.into(), (xpk, info));
+        match self.index.get(<&ed25519::PublicKeyWrap>::from(&pk)) {
+            Some(i) => self.entries[*i].info = info,
+            None => {
+                let ke_pk = x25519::public_from_ed25519(&pk)?;
+                self.index.insert(pk.into(), self.entries.len());
+                self.entries.push(KeyEntry {
+                    sig_pk: pk,
+                    ke_pk,
+                    info,
+                });
+            }
+        }
         Ok(())
     }
-    fn keys(&self) -> Vec<(&ed25519::PublicKey, &x25519::PublicKey)> {
-        self.pks.iter().map(|(k, (x, _i))| (&k.0, x)).collect()
+    fn len(&self) -> usize {
+        self.entries.len()
+    }
+    fn keys(&self) -> DynKeys<'_> {
+        Box::new(PublicKeyMap::keys(self))
     }
-    fn iter(&self) -> Vec<(&ed25519::PublicKey, &Info)> {
-        self.pks.iter().map(|(k, (_x, i))| (&k.0, i)).collect()
+    fn iter(&self) -> DynIter<'_, Info> {
+        Box::new(PublicKeyMap::iter(self))
     }
-    fn iter_mut(&mut self) -> Vec<(&ed25519::PublicKey, &mut Info)> {
-        self.pks.iter_mut().map(|(k, (_x, i))| (&k.0, i)).collect()
+    fn iter_mut(&mut self) -> DynIterMut<'_, Info> {
+        Box::new(PublicKeyMap::iter_mut(self))
     }
 }
 
 impl<Info: fmt::Display> fmt::Display for PublicKeyMap<Info> {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
-        for (k, (_x, i)) in self.pks.iter() {
-            writeln!(f, "    <{}> => {}", hex::encode(k.0.as_bytes()), i)?;
+        for e in self.entries.iter() {
+            writeln!(f, "    <{}> => {}", hex::encode(e.sig_pk.as_bytes()), e.info)?;
         }
         Ok(())
     }
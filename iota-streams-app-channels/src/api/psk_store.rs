@@ -1,37 +1,69 @@
+use core::{
+    iter,
+    slice,
+};
 use iota_streams_core::{
     prelude::{
+        Box,
         HashMap,
         Vec,
     },
     psk,
 };
 
+/// Iterator over stored pre-shared keys along with their identifiers.
+pub type DynPsks<'a> = Box<dyn Iterator<Item = psk::IPsk<'a>> + 'a>;
+
+/// Iterator over pre-shared keys stored in a `PresharedKeyMap` along with their identifiers.
+pub type Psks<'a> = iter::Map<slice::Iter<'a, (psk::PskId, psk::Psk)>, fn(&'a (psk::PskId, psk::Psk)) -> psk::IPsk<'a>>;
+
 pub trait PresharedKeyStore: Default {
     fn insert(&mut self, pskid: psk::PskId, psk: psk::Psk);
     fn filter<'a>(&'a self, psk_ids: &'_ psk::PskIds) -> Vec<psk::IPsk<'a>>;
     fn get<'a>(&'a self, pskid: &'_ psk::PskId) -> Option<&'a psk::Psk>;
-    fn iter(&self) -> Vec<(&psk::PskId, &psk::Psk)>;
+    fn len(&self) -> usize;
+    fn iter(&self) -> DynPsks<'_>;
 }
 
 #[derive(Default)]
 pub struct PresharedKeyMap {
-    psks: HashMap<psk::PskId, psk::Psk>,
+    /// Pre-shared keys kept contiguous in insertion order.
+    psks: Vec<(psk::PskId, psk::Psk)>,
+    /// Position of each pre-shared key in `psks` by its identifier.
+    index: HashMap<psk::PskId, usize>,
+}
+
+impl PresharedKeyMap {
+    /// Walk the pre-shared keys without boxing the iterator, unlike `PresharedKeyStore::iter`.
+    pub fn iter<'a>(&'a self) -> Psks<'a> {
+        let f: fn(&'a (psk::PskId, psk::Psk)) -> psk::IPsk<'a> = |(pskid, psk)| (pskid, psk);
+        self.psks.iter().map(f)
+    }
 }
 
 impl PresharedKeyStore for PresharedKeyMap {
     fn insert(&mut self, pskid: psk::PskId, psk: psk::Psk) {
-        self.psks.insert(pskid, psk);
+        match self.index.get(&pskid) {
+            Some(i) => self.psks[*i].1 = psk,
+            None => {
+                self.index.insert(pskid, self.psks.len());
+                self.psks.push((pskid, psk));
+            }
+        }
     }
     fn filter<'a>(&'a self, psk_ids: &'_ psk::PskIds) -> Vec<psk::IPsk<'a>> {
         psk_ids
             .iter()
-            .filter_map(|psk_id| self.psks.get_key_value(psk_id))
+            .filter_map(|psk_id| self.index.get(psk_id).map(|i| (&self.psks[*i].0, &self.psks[*i].1)))
             .collect()
     }
     fn get<'a>(&'a self, pskid: &'_ psk::PskId) -> Option<&'a psk::Psk> {
-        self.psks.get(pskid)
+        self.index.get(pskid).map(|i| &self.psks[*i].1)
+    }
+    fn len(&self) -> usize {
+        self.psks.len()
     }
-    fn iter(&self) -> Vec<(&psk::PskId, &psk::Psk)> {
-        self.psks.iter().collect()
+    fn iter(&self) -> DynPsks<'_> {
+        Box::new(PresharedKeyMap::iter(self))
     }
 }
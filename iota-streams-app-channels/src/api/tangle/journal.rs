@@ -0,0 +1,612 @@
+//! Append-only file journal of user state.
+//!
+//! Instead of exporting the whole user on every checkpoint, each `sync` appends a single record with
+//! the spongos states, pre-shared keys and publisher cursors that changed since the previous one.
+//! Records are encrypted and authenticated with a key derived from a password and are bound to their
+//! position in the file. Once the file outgrows twice its last compacted size it is rewritten as a
+//! single record holding the current state.
+//!
+//! Opening a journal replays the records straight into the user stores, reading the file one record
+//! at a time. A record cut short at the end of the file, eg. by a crash while appending, is dropped.
+//! Compaction streams the new record to disk in chunks rather than building it in memory first.
+
+use std::{
+    fs,
+    io::{
+        BufReader,
+        Read as _,
+        Seek as _,
+        SeekFrom,
+        Write as _,
+    },
+};
+
+use iota_streams_app::message::{
+    ContentSizeof,
+    ContentUnwrap,
+    ContentWrap,
+    Cursor,
+    LinkGenerator as _,
+};
+use iota_streams_core::{
+    prelude::{
+        generic_array::GenericArray,
+        typenum::U32,
+        String,
+        Vec,
+    },
+    prng,
+    psk,
+    sponge::prp::{
+        Inner,
+        PRP,
+    },
+    try_or,
+    wrapped_err,
+    Errors::{
+        AppInstRecoveryFailure,
+        AuthorSigPkRecoveryFailure,
+        BadStateJournal,
+        KeyloadKeyRecoveryFailure,
+        InputStreamNotFullyConsumed,
+        StateJournalFailure,
+        StateJournalRecordMismatch,
+        UserFlagRecoveryFailure,
+        UserVersionRecoveryFailure,
+    },
+    Error,
+    Result,
+    WrappedError,
+};
+use iota_streams_core_edsig::{
+    key_exchange::x25519,
+    signature::ed25519,
+};
+use iota_streams_ddml::{
+    command::*,
+    io,
+    link_store::{
+        EmptyLinkStore,
+        LinkStore as _,
+    },
+    types::*,
+};
+
+use super::*;
+use crate::api::{
+    self,
+    pk_store::PublicKeyStore as _,
+    psk_store::PresharedKeyStore as _,
+};
+
+/// Records of version 0 have no keyload key.
+const VERSION: u8 = 1;
+/// Size of the big-endian record length preceding each record.
+const LENGTH_SIZE: usize = 4;
+/// Files smaller than this are not compacted.
+const MIN_COMPACTED_SIZE: u64 = 64 * 1024;
+/// Size of the chunks written while compacting.
+const CHUNK_SIZE: usize = 64 * 1024;
+
+type UserImp = api::user::User<DefaultF, Address, LinkGen, LinkStore, PkStore, PskStore>;
+type NoStore = EmptyLinkStore<DefaultF, MsgId, ()>;
+
+/// Changes of user state written as one record.
+struct Delta<'a> {
+    /// User keys and channel details, written on the first record and whenever they change.
+    header: Option<&'a UserImp>,
+    links: Vec<(&'a MsgId, &'a (Inner<DefaultF>, MsgInfo))>,
+    psks: Vec<psk::IPsk<'a>>,
+    cursors: Vec<(&'a PublicKey, &'a Cursor<MsgId>)>,
+    /// Nonce and session key of the last keyload unwrapped, written whenever it changes.
+    keyload_key: Option<&'a api::user::KeyloadKey>,
+}
+
+impl<'a> Delta<'a> {
+    fn is_empty(&self) -> bool {
+        self.header.is_none()
+            && self.links.is_empty()
+            && self.psks.is_empty()
+            && self.cursors.is_empty()
+            && self.keyload_key.is_none()
+    }
+}
+
+impl<'a> ContentSizeof<DefaultF> for Delta<'a> {
+    fn sizeof<'c>(&self, ctx: &'c mut sizeof::Context<DefaultF>) -> Result<&'c mut sizeof::Context<DefaultF>> {
+        ctx.absorb(Uint8(self.header.is_some() as u8))?;
+        if let Some(user) = self.header {
+            ctx.mask(<&NBytes<U32>>::from(&user.sig_kp.secret.as_bytes()[..]))?
+                .absorb(Uint8(user.flags))?
+                .absorb(<&Bytes>::from(&user.message_encoding))?
+                .absorb(Uint64(user.uniform_payload_length as u64))?
+                .absorb(Uint8(user.appinst.is_some() as u8))?;
+            if let Some(ref appinst) = user.appinst {
+                ctx.absorb(<&Fallback<Address>>::from(appinst))?;
+            }
+            ctx.absorb(Uint8(user.author_sig_pk.is_some() as u8))?;
+            if let Some(ref author_sig_pk) = user.author_sig_pk {
+                ctx.absorb(author_sig_pk)?;
+            }
+        }
+        ctx.absorb(Size(self.links.len()))?
+            .repeated(self.links.iter(), |ctx, (link, (s, info))| {
+                ctx.absorb(<&Fallback<MsgId>>::from(*link))?
+                    .mask(<&NBytes<<DefaultF as PRP>::CapacitySize>>::from(s.arr()))?
+                    .absorb(<&Fallback<MsgInfo>>::from(info))?;
+                Ok(ctx)
+            })?
+            .absorb(Size(self.psks.len()))?
+            .repeated(self.psks.iter(), |ctx, (pskid, psk)| {
+                ctx.mask(<&NBytes<psk::PskIdSize>>::from(*pskid))?
+                    .mask(<&NBytes<psk::PskSize>>::from(*psk))?;
+                Ok(ctx)
+            })?
+            .absorb(Size(self.cursors.len()))?
+            .repeated(self.cursors.iter(), |ctx, (pk, cursor)| {
+                ctx.absorb(*pk)?
+                    .absorb(<&Fallback<MsgId>>::from(&cursor.link))?
+                    .absorb(Uint32(cursor.branch_no))?
+                    .absorb(Uint32(cursor.seq_no))?;
+                Ok(ctx)
+            })?
+            .absorb(Uint8(self.keyload_key.is_some() as u8))?;
+        if let Some(keyload_key) = self.keyload_key {
+            ctx.mask(&keyload_key.nonce)?.mask(&keyload_key.key)?;
+        }
+        ctx.commit()?.squeeze(Mac(32))?;
+        Ok(ctx)
+    }
+}
+
+impl<'a> ContentWrap<DefaultF, NoStore> for Delta<'a> {
+    fn wrap<'c, OS: io::OStream>(
+        &self,
+        _store: &NoStore,
+        ctx: &'c mut wrap::Context<DefaultF, OS>,
+    ) -> Result<&'c mut wrap::Context<DefaultF, OS>> {
+        ctx.absorb(Uint8(self.header.is_some() as u8))?;
+        if let Some(user) = self.header {
+            ctx.mask(<&NBytes<U32>>::from(&user.sig_kp.secret.as_bytes()[..]))?
+                .absorb(Uint8(user.flags))?
+                .absorb(<&Bytes>::from(&user.message_encoding))?
+                .absorb(Uint64(user.uniform_payload_length as u64))?
+                .absorb(Uint8(user.appinst.is_some() as u8))?;
+            if let Some(ref appinst) = user.appinst {
+                ctx.absorb(<&Fallback<Address>>::from(appinst))?;
+            }
+            ctx.absorb(Uint8(user.author_sig_pk.is_some() as u8))?;
+            if let Some(ref author_sig_pk) = user.author_sig_pk {
+                ctx.absorb(author_sig_pk)?;
+            }
+        }
+        ctx.absorb(Size(self.links.len()))?
+            .repeated(self.links.iter(), |ctx, (link, (s, info))| {
+                ctx.absorb(<&Fallback<MsgId>>::from(*link))?
+                    .mask(<&NBytes<<DefaultF as PRP>::CapacitySize>>::from(s.arr()))?
+                    .absorb(<&Fallback<MsgInfo>>::from(info))?;
+                Ok(ctx)
+            })?
+            .absorb(Size(self.psks.len()))?
+            .repeated(self.psks.iter(), |ctx, (pskid, psk)| {
+                ctx.mask(<&NBytes<psk::PskIdSize>>::from(*pskid))?
+                    .mask(<&NBytes<psk::PskSize>>::from(*psk))?;
+                Ok(ctx)
+            })?
+            .absorb(Size(self.cursors.len()))?
+            .repeated(self.cursors.iter(), |ctx, (pk, cursor)| {
+                ctx.absorb(*pk)?
+                    .absorb(<&Fallback<MsgId>>::from(&cursor.link))?
+                    .absorb(Uint32(cursor.branch_no))?
+                    .absorb(Uint32(cursor.seq_no))?;
+                Ok(ctx)
+            })?
+            .absorb(Uint8(self.keyload_key.is_some() as u8))?;
+        if let Some(keyload_key) = self.keyload_key {
+            ctx.mask(&keyload_key.nonce)?.mask(&keyload_key.key)?;
+        }
+        ctx.commit()?.squeeze(Mac(32))?;
+        Ok(ctx)
+    }
+}
+
+/// Record replayed into user state.
+struct Replay<'a> {
+    user: &'a mut UserImp,
+    has_header: bool,
+    /// Version of the record being replayed.
+    version: u8,
+}
+
+impl<'a> ContentUnwrap<DefaultF, NoStore> for Replay<'a> {
+    fn unwrap<'c, IS: io::IStream>(
+        &mut self,
+        _store: &NoStore,
+        ctx: &'c mut unwrap::Context<DefaultF, IS>,
+    ) -> Result<&'c mut unwrap::Context<DefaultF, IS>> {
+        let mut oneof_header = Uint8(0);
+        ctx.absorb(&mut oneof_header)?;
+        if oneof_header.0 == 1 {
+            let mut sig_sk_bytes = NBytes::<U32>::default();
+            let mut flags = Uint8(0);
+            let mut message_encoding = Bytes::new();
+            let mut uniform_payload_length = Uint64(0);
+            let mut oneof_appinst = Uint8(0);
+            ctx.mask(&mut sig_sk_bytes)?
+                .absorb(&mut flags)?
+                .absorb(&mut message_encoding)?
+                .absorb(&mut uniform_payload_length)?
+                .absorb(&mut oneof_appinst)?
+                .guard(oneof_appinst.0 < 2, AppInstRecoveryFailure(oneof_appinst.0))?;
+            let appinst = if oneof_appinst.0 == 1 {
+                let mut appinst = Address::default();
+                ctx.absorb(<&mut Fallback<Address>>::from(&mut appinst))?;
+                Some(appinst)
+            } else {
+                None
+            };
+            let mut oneof_author_sig_pk = Uint8(0);
+            ctx.absorb(&mut oneof_author_sig_pk)?.guard(
+                oneof_author_sig_pk.0 < 2,
+                AuthorSigPkRecoveryFailure(oneof_author_sig_pk.0),
+            )?;
+            let author_sig_pk = if oneof_author_sig_pk.0 == 1 {
+                let mut author_sig_pk = ed25519::PublicKey::default();
+                ctx.absorb(&mut author_sig_pk)?;
+                Some(author_sig_pk)
+            } else {
+                None
+            };
+
+            let user = &mut *self.user;
+            let sig_sk = ed25519::SecretKey::from_bytes(sig_sk_bytes.as_ref()).unwrap();
+            let sig_pk = ed25519::PublicKey::from(&sig_sk);
+            user.sig_kp = ed25519::Keypair {
+                secret: sig_sk,
+                public: sig_pk,
+            };
+            user.ke_kp = x25519::keypair_from_ed25519(&user.sig_kp);
+            user.ke_secrets.clear();
+            user.author_sig_pk = author_sig_pk;
+            if let Some(ref seed) = appinst {
+                user.link_gen.reset(seed.clone());
+            }
+            user.appinst = appinst;
+            user.flags = flags.0;
+            user.message_encoding = message_encoding.0;
+            user.uniform_payload_length = uniform_payload_length.0 as usize;
+            self.has_header = true;
+        }
+
+        let user = &mut *self.user;
+        let mut repeated_links = Size(0);
+        ctx.absorb(&mut repeated_links)?.repeated(repeated_links, |ctx| {
+            let mut link = Fallback(MsgId::default());
+            let mut s = NBytes::<<DefaultF as PRP>::CapacitySize>::default();
+            let mut info = Fallback(MsgInfo::default());
+            ctx.absorb(&mut link)?.mask(&mut s)?.absorb(&mut info)?;
+            let a: GenericArray<u8, <DefaultF as PRP>::CapacitySize> = s.into();
+            user.link_store.borrow_mut().insert(&link.0, Inner::from(a), info.0)?;
+            Ok(ctx)
+        })?;
+
+        let mut repeated_psks = Size(0);
+        ctx.absorb(&mut repeated_psks)?.repeated(repeated_psks, |ctx| {
+            let mut pskid = NBytes::<psk::PskIdSize>::default();
+            let mut psk = NBytes::<psk::PskSize>::default();
+            ctx.mask(&mut pskid)?.mask(&mut psk)?;
+            user.psk_store.insert(pskid.0, psk.0);
+            Ok(ctx)
+        })?;
+
+        let mut repeated_cursors = Size(0);
+        ctx.absorb(&mut repeated_cursors)?.repeated(repeated_cursors, |ctx| {
+            let mut pk = ed25519::PublicKey::default();
+            let mut link = Fallback(MsgId::default());
+            let mut branch_no = Uint32(0);
+            let mut seq_no = Uint32(0);
+            ctx.absorb(&mut pk)?
+                .absorb(&mut link)?
+                .absorb(&mut branch_no)?
+                .absorb(&mut seq_no)?;
+            user.pk_store
+                .insert(pk, Cursor::new_at(link.0, branch_no.0, seq_no.0))?;
+            Ok(ctx)
+        })?;
+
+        if self.version > 0 {
+            let mut oneof_keyload_key = Uint8(0);
+            ctx.absorb(&mut oneof_keyload_key)?
+                .guard(oneof_keyload_key.0 < 2, KeyloadKeyRecoveryFailure(oneof_keyload_key.0))?;
+            if oneof_keyload_key.0 == 1 {
+                let mut keyload_key = api::user::KeyloadKey::default();
+                ctx.mask(&mut keyload_key.nonce)?.mask(&mut keyload_key.key)?;
+                user.keyload_key = Some(keyload_key);
+            }
+        }
+        ctx.commit()?.squeeze(Mac(32))?;
+        Ok(ctx)
+    }
+}
+
+/// Append-only journal of an Author or Subscriber state, see the module documentation.
+pub struct StateJournal {
+    path: String,
+    flag: u8,
+    key: NBytes<U32>,
+    file: fs::File,
+    /// Number of records in the file, the next record is bound to this index.
+    records: u64,
+    /// Size of the file and its size right after the last compaction.
+    len: u64,
+    compacted_len: u64,
+    /// Link store insertions, pre-shared keys and publisher cursors already in the journal.
+    links: u64,
+    psks: Vec<psk::Psk>,
+    cursors: Vec<Cursor<MsgId>>,
+    /// Channel details already in the journal.
+    appinst: Option<Address>,
+    author_sig_pk: Option<PublicKey>,
+    keyload_key: Option<api::user::KeyloadKey>,
+}
+
+fn journal_key(pwd: &str) -> NBytes<U32> {
+    let prng = prng::from_seed::<DefaultF>("IOTA Streams Channels app", pwd);
+    NBytes::<U32>(prng.gen_arr("user journal key"))
+}
+
+fn file_err(path: &str, e: std::io::Error) -> Error {
+    wrapped_err!(StateJournalFailure(path.into()), WrappedError(e))
+}
+
+impl StateJournal {
+    /// Write the whole state of `user` into a new journal file at `path`, replacing an existing one.
+    ///
+    ///   # Arguments
+    ///   * `path` - Path of the journal file
+    ///   * `flag` - User type, as in `User::export`
+    ///   * `pwd` - Encryption password
+    ///   * `user` - User to be journaled
+    pub fn create<Trans>(path: &str, flag: u8, pwd: &str, user: &User<Trans>) -> Result<Self> {
+        let file = fs::OpenOptions::new()
+            .append(true)
+            .create(true)
+            .open(path)
+            .map_err(|e| file_err(path, e))?;
+        let mut journal = Self {
+            path: path.into(),
+            flag,
+            key: journal_key(pwd),
+            file,
+            records: 0,
+            len: 0,
+            compacted_len: 0,
+            links: 0,
+            psks: Vec::new(),
+            cursors: Vec::new(),
+            appinst: None,
+            author_sig_pk: None,
+            keyload_key: None,
+        };
+        journal.compact(user)?;
+        Ok(journal)
+    }
+
+    /// Recover a user from the journal file at `path` and keep appending to it.
+    ///
+    ///   # Arguments
+    ///   * `path` - Path of the journal file
+    ///   * `flag` - User type, as in `User::import`
+    ///   * `pwd` - Encryption password
+    ///   * `tsp` - Transport object of the recovered user
+    pub fn open<Trans>(path: &str, flag: u8, pwd: &str, tsp: Trans) -> Result<(User<Trans>, Self)> {
+        let file = fs::File::open(path).map_err(|e| file_err(path, e))?;
+        let file_len = file.metadata().map_err(|e| file_err(path, e))?.len();
+        let mut reader = BufReader::new(file);
+        let key = journal_key(pwd);
+        let mut user = UserImp::default();
+        let mut replay = Replay {
+            user: &mut user,
+            has_header: false,
+            version: VERSION,
+        };
+        let mut records = 0;
+        let mut len = 0_u64;
+        let mut record = Vec::new();
+        while file_len - len >= LENGTH_SIZE as u64 {
+            let mut length = [0_u8; LENGTH_SIZE];
+            reader.read_exact(&mut length).map_err(|e| file_err(path, e))?;
+            let record_len = u32::from_be_bytes(length) as usize;
+            if file_len - len - (LENGTH_SIZE as u64) < record_len as u64 {
+                break;
+            }
+            record.resize(record_len, 0);
+            reader.read_exact(&mut record).map_err(|e| file_err(path, e))?;
+            unwrap_record(&record, flag, &key, records, &mut replay)
+                .map_err(|e| wrapped_err!(BadStateJournal(path.into()), WrappedError(e)))?;
+            try_or!(replay.has_header, BadStateJournal(path.into()))?;
+            records += 1;
+            len += (LENGTH_SIZE + record_len) as u64;
+        }
+        try_or!(records > 0, BadStateJournal(path.into()))?;
+
+        // Drop a record cut short so that the next one is appended right after the last complete one
+        let file = fs::OpenOptions::new()
+            .append(true)
+            .open(path)
+            .map_err(|e| file_err(path, e))?;
+        if len < file_len {
+            file.set_len(len).map_err(|e| file_err(path, e))?;
+        }
+
+        let user = User { user, transport: tsp };
+        let mut journal = Self {
+            path: path.into(),
+            flag,
+            key,
+            file,
+            records,
+            len,
+            compacted_len: len,
+            links: 0,
+            psks: Vec::new(),
+            cursors: Vec::new(),
+            appinst: None,
+            author_sig_pk: None,
+            keyload_key: None,
+        };
+        journal.mark_synced(&user);
+        Ok((user, journal))
+    }
+
+    /// Append the changes of user state since the last sync to the journal, compacting the file
+    /// once it has grown to twice its compacted size. Does nothing if nothing has changed.
+    ///
+    ///   # Arguments
+    ///   * `user` - User the journal was created or opened for
+    pub fn sync<Trans>(&mut self, user: &User<Trans>) -> Result<()> {
+        if self.len > 2 * self.compacted_len.max(MIN_COMPACTED_SIZE) {
+            return self.compact(user);
+        }
+
+        let imp = &user.user;
+        let link_store = imp.link_store.borrow();
+        let header_changed = imp.appinst != self.appinst || imp.author_sig_pk != self.author_sig_pk;
+        let delta = Delta {
+            header: if header_changed { Some(imp) } else { None },
+            links: link_store.inserted_since(self.links),
+            psks: imp
+                .psk_store
+                .iter()
+                .enumerate()
+                .filter(|(i, (_pskid, psk))| self.psks.get(*i) != Some(*psk))
+                .map(|(_i, ipsk)| ipsk)
+                .collect(),
+            cursors: imp
+                .pk_store
+                .iter()
+                .enumerate()
+                .filter(|(i, (_pk, cursor))| match self.cursors.get(*i) {
+                    Some(synced) => {
+                        synced.link != cursor.link
+                            || synced.branch_no != cursor.branch_no
+                            || synced.seq_no != cursor.seq_no
+                    }
+                    None => true,
+                })
+                .map(|(_i, pk_cursor)| pk_cursor)
+                .collect(),
+            keyload_key: match imp.keyload_key != self.keyload_key {
+                true => imp.keyload_key.as_ref(),
+                false => None,
+            },
+        };
+        if delta.is_empty() {
+            return Ok(());
+        }
+        let record = wrap_record(&delta, self.flag, &self.key, self.records, Vec::new())?;
+        self.append(&record)?;
+        self.mark_synced(user);
+        Ok(())
+    }
+
+    /// Rewrite the journal as a single record with the whole state of `user`.
+    ///
+    ///   # Arguments
+    ///   * `user` - User the journal was created or opened for
+    pub fn compact<Trans>(&mut self, user: &User<Trans>) -> Result<()> {
+        let imp = &user.user;
+        let link_store = imp.link_store.borrow();
+        let delta = Delta {
+            header: Some(imp),
+            links: link_store.iter(),
+            psks: imp.psk_store.iter().collect(),
+            cursors: imp.pk_store.iter().collect(),
+            keyload_key: imp.keyload_key.as_ref(),
+        };
+
+        // The new file replaces the old one only once it is complete. Its record length is known
+        // once the record has been written, it is filled in last.
+        let tmp_path = self.path.clone() + ".tmp";
+        let mut tmp = fs::File::create(&tmp_path).map_err(|e| file_err(&tmp_path, e))?;
+        tmp.write_all(&[0; LENGTH_SIZE]).map_err(|e| file_err(&tmp_path, e))?;
+        let mut record_len = 0;
+        let sink = |chunk: &[u8]| {
+            record_len += chunk.len();
+            tmp.write_all(chunk).map_err(|e| file_err(&tmp_path, e))
+        };
+        wrap_record(&delta, self.flag, &self.key, 0, io::ChunkedOStream::new(CHUNK_SIZE, sink))?.finish()?;
+        tmp.seek(SeekFrom::Start(0))
+            .and_then(|_| tmp.write_all(&(record_len as u32).to_be_bytes()))
+            .map_err(|e| file_err(&tmp_path, e))?;
+        drop(tmp);
+        fs::rename(&tmp_path, &self.path).map_err(|e| file_err(&self.path, e))?;
+        self.file = fs::OpenOptions::new()
+            .append(true)
+            .open(&self.path)
+            .map_err(|e| file_err(&self.path, e))?;
+        self.records = 1;
+        self.len = (LENGTH_SIZE + record_len) as u64;
+        self.compacted_len = self.len;
+        self.mark_synced(user);
+        Ok(())
+    }
+
+    /// Path of the journal file.
+    pub fn path(&self) -> &str {
+        &self.path
+    }
+
+    /// Size of the journal file in bytes.
+    pub fn len(&self) -> u64 {
+        self.len
+    }
+
+    fn append(&mut self, record: &[u8]) -> Result<()> {
+        let mut bytes = Vec::with_capacity(LENGTH_SIZE + record.len());
+        bytes.extend_from_slice(&(record.len() as u32).to_be_bytes());
+        bytes.extend_from_slice(record);
+        self.file.write_all(&bytes).map_err(|e| file_err(&self.path, e))?;
+        self.records += 1;
+        self.len += bytes.len() as u64;
+        Ok(())
+    }
+
+    fn mark_synced<Trans>(&mut self, user: &User<Trans>) {
+        let imp = &user.user;
+        self.links = imp.link_store.borrow().inserted();
+        self.psks = imp.psk_store.iter().map(|(_pskid, psk)| psk.clone()).collect();
+        self.cursors = imp.pk_store.iter().map(|(_pk, cursor)| cursor.clone()).collect();
+        self.appinst = imp.appinst.clone();
+        self.author_sig_pk = imp.author_sig_pk;
+        self.keyload_key = imp.keyload_key;
+    }
+}
+
+fn wrap_record<OS: io::OStream>(delta: &Delta, flag: u8, key: &NBytes<U32>, index: u64, stream: OS) -> Result<OS> {
+    let mut ctx = wrap::Context::<DefaultF, OS>::new(stream);
+    ctx.absorb(Uint8(VERSION))?
+        .absorb(Uint8(flag))?
+        .absorb(External(key))?
+        .absorb(Uint64(index))?;
+    delta.wrap(&NoStore::default(), &mut ctx)?;
+    Ok(ctx.stream)
+}
+
+fn unwrap_record(record: &[u8], flag: u8, key: &NBytes<U32>, index: u64, replay: &mut Replay) -> Result<()> {
+    let mut ctx = unwrap::Context::new(record);
+    let mut version = Uint8(0);
+    let mut flag2 = Uint8(0);
+    let mut index2 = Uint64(0);
+    ctx.absorb(&mut version)?
+        .guard(version.0 <= VERSION, UserVersionRecoveryFailure(VERSION, version.0))?
+        .absorb(&mut flag2)?
+        .guard(flag2.0 == flag, UserFlagRecoveryFailure(flag, flag2.0))?
+        .absorb(External(key))?
+        .absorb(&mut index2)?
+        .guard(index2.0 == index, StateJournalRecordMismatch(index, index2.0))?;
+    replay.version = version.0;
+    replay.unwrap(&NoStore::default(), &mut ctx)?;
+    try_or!(ctx.stream.is_empty(), InputStreamNotFullyConsumed(ctx.stream.len()))?;
+    Ok(())
+}
@@ -32,7 +32,11 @@ pub use transport::{
     TransportOptions as _,
 };
 
-pub use super::ChannelType;
+pub use super::{
+    ChannelType,
+    KeyloadKeyExchange,
+    LinkStorePolicy,
+};
 use super::DefaultF;
 use iota_streams_core::psk;
 use iota_streams_ddml::link_store::DefaultLinkStore;
@@ -81,8 +85,14 @@ pub type LinkGen = DefaultTangleLinkGenerator<DefaultF>;
 /// Link Store.
 pub type LinkStore = DefaultLinkStore<DefaultF, MsgId, MsgInfo>;
 
+/// Maximum number of recipients of a single keyload message. Keyloads for more recipients are
+/// split into several messages so that each of them fits into a Tangle message.
+pub const KEYLOAD_MAX_RECIPIENTS: usize = 256;
+
 /// Test Transport.
 pub type BucketTransport = transport::BucketTransport<Address, Message>;
+#[cfg(feature = "std")]
+pub type ShardedBucketTransport = transport::ShardedBucketTransport<Address, Message>;
 
 /// Transportation trait for Tangle Client implementation
 // TODO: Use trait synonyms `pub Transport = transport::Transport<DefaultF, Address>;`.
@@ -161,4 +171,10 @@ mod subscriber;
 /// Tangle-specific Channel Subscriber type.
 pub use subscriber::Subscriber;
 
+#[cfg(feature = "std")]
+mod journal;
+/// Append-only file journal of user state.
+#[cfg(feature = "std")]
+pub use journal::StateJournal;
+
 pub mod test;
@@ -108,13 +108,36 @@ impl<Trans> Subscriber<Trans> {
     /// user to see the latest messages present from each publisher
     pub fn fetch_state(&self) -> Result<Vec<(String, Cursor<Address>)>> {
         let state_list = self.user.fetch_state()?;
-        let mut state = Vec::new();
+        let mut state = Vec::with_capacity(state_list.len());
         for (pk, cursor) in state_list {
             state.push((hex::encode(pk.as_bytes()), cursor))
         }
         Ok(state)
     }
 
+    /// Fetches the latest PublicKey -> Cursor state mapping keyed by the public keys themselves,
+    /// without encoding them
+    pub fn fetch_key_state(&self) -> Result<Vec<(PublicKey, Cursor<Address>)>> {
+        self.user.fetch_state()
+    }
+
+    /// Fetches the latest Cursor state of a single publisher
+    ///
+    ///   # Arguments
+    ///   * `pk` - Public key of the publisher
+    pub fn fetch_state_of(&self, pk: &PublicKey) -> Result<Option<Cursor<Address>>> {
+        self.user.fetch_state_of(pk)
+    }
+
+    /// Set the policy for the spongos states of processed messages kept in the link store. Under a
+    /// bounded policy evicted states are restored from the transport when a message links to them
+    ///
+    ///   # Arguments
+    ///   * `policy` - Link store policy
+    pub fn set_link_store_policy(&mut self, policy: LinkStorePolicy) {
+        self.user.set_link_store_policy(policy)
+    }
+
     /// Generate a vector containing the next sequenced message identifier for each publishing
     /// participant in the channel
     ///
@@ -124,6 +147,42 @@ impl<Trans> Subscriber<Trans> {
         self.user.gen_next_msg_ids(branching)
     }
 
+    /// Links of the next message of each publishing participant in the channel, as retrieved by
+    /// `fetch_next_msgs`
+    pub fn next_msg_links(&self) -> Vec<Address> {
+        self.user.next_msg_links()
+    }
+
+    /// Wrap a chain of signed packets, each one attached to the previous, without sending them.
+    /// The chain is committed to the user state; the returned messages are left for the caller to
+    /// publish in the given order.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub fn wrap_signed_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<(Vec<Message>, Vec<(Address, Option<Address>)>)> {
+        self.user.wrap_signed_packets(link_to, payloads)
+    }
+
+    /// Wrap a chain of tagged packets, each one attached to the previous, without sending them.
+    /// The chain is committed to the user state; the returned messages are left for the caller to
+    /// publish in the given order.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub fn wrap_tagged_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<(Vec<Message>, Vec<(Address, Option<Address>)>)> {
+        self.user.wrap_tagged_packets(link_to, payloads)
+    }
+
     /// Serialize user state and encrypt it with password.
     ///
     ///   # Arguments
@@ -132,6 +191,20 @@ impl<Trans> Subscriber<Trans> {
         self.user.export(1, pwd)
     }
 
+    /// Serialize user state and encrypt it with password, handing it over to `sink` in chunks
+    /// rather than as a whole.
+    ///
+    ///   # Arguments
+    ///   * `pwd` - Encryption password
+    ///   * `chunk_size` - Approximate size of the chunks
+    ///   * `sink` - Consumer of the encrypted serialized user state
+    pub fn export_to<W>(&self, pwd: &str, chunk_size: usize, sink: W) -> Result<()>
+    where
+        W: FnMut(&[u8]) -> Result<()>,
+    {
+        self.user.export_to(1, pwd, chunk_size, sink)
+    }
+
     /// Deserialize user state and decrypt it with password.
     ///
     ///   # Arguments
@@ -141,6 +214,53 @@ impl<Trans> Subscriber<Trans> {
     pub fn import(bytes: &[u8], pwd: &str, tsp: Trans) -> Result<Self> {
         User::<Trans>::import(bytes, 1, pwd, tsp).map(|user| Self { user })
     }
+
+    /// Deserialize user state and decrypt it with password, pulling it from `source` in chunks
+    /// rather than as a whole.
+    ///
+    ///   # Arguments
+    ///   * `pwd` - Encryption password
+    ///   * `chunk_size` - Approximate size of the chunks
+    ///   * `source` - Producer of the encrypted serialized user state, filling the buffer it is
+    ///     given and returning the number of bytes written, 0 at the end of the state
+    ///   * `tsp` - Transport object
+    pub fn import_from<R>(pwd: &str, chunk_size: usize, source: R, tsp: Trans) -> Result<Self>
+    where
+        R: FnMut(&mut [u8]) -> Result<usize>,
+    {
+        User::<Trans>::import_from(1, pwd, chunk_size, source, tsp).map(|user| Self { user })
+    }
+
+    /// Write user state into a new journal file, encrypted with password. Subsequent changes are
+    /// appended to the file with `sync_journal`.
+    ///
+    ///   # Arguments
+    ///   * `path` - Path of the journal file
+    ///   * `pwd` - Encryption password
+    #[cfg(feature = "std")]
+    pub fn create_journal(&self, path: &str, pwd: &str) -> Result<StateJournal> {
+        StateJournal::create(path, 1, pwd, &self.user)
+    }
+
+    /// Append the changes of user state since the last sync to the journal.
+    ///
+    ///   # Arguments
+    ///   * `journal` - Journal created or opened for this user
+    #[cfg(feature = "std")]
+    pub fn sync_journal(&self, journal: &mut StateJournal) -> Result<()> {
+        journal.sync(&self.user)
+    }
+
+    /// Recover user state from a journal file and decrypt it with password.
+    ///
+    ///   # Arguments
+    ///   * `path` - Path of the journal file
+    ///   * `pwd` - Encryption password
+    ///   * `tsp` - Transport object
+    #[cfg(feature = "std")]
+    pub fn open_journal(path: &str, pwd: &str, tsp: Trans) -> Result<(Self, StateJournal)> {
+        StateJournal::open(path, 1, pwd, tsp).map(|(user, journal)| (Self { user }, journal))
+    }
 }
 
 #[cfg(not(feature = "async"))]
@@ -160,6 +280,22 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
         Ok(subscriber)
     }
 
+    /// Restores a Subscriber from a checkpoint and syncs to the latest state. Only messages published
+    /// after the checkpoint was taken are fetched, instead of the whole channel from the announcement.
+    ///
+    ///  # Arguements
+    /// * `seed` - A string slice representing the seed of the user [Characters: A-Z, 9]
+    /// * `checkpoint` - User state exported with the seed as password
+    /// * `transport` - Transport object used for sending and receiving
+    pub fn recover_from_checkpoint(seed: &str, checkpoint: &[u8], transport: Trans) -> Result<Self> {
+        let mut subscriber = Self {
+            user: User::import_checkpoint(checkpoint, 1, seed, transport)?,
+        };
+        subscriber.sync_state();
+
+        Ok(subscriber)
+    }
+
     /// Create and Send a Subscribe message to a Channel app instance.
     ///
     /// # Arguments
@@ -198,6 +334,32 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
         self.user.send_signed_packet(link_to, public_payload, masked_payload)
     }
 
+    /// Create and send a chain of signed packets, each one attached to the previous.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub fn send_signed_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<Vec<(Address, Option<Address>)>> {
+        self.user.send_signed_packets(link_to, payloads)
+    }
+
+    /// Create and send a chain of tagged packets, each one attached to the previous.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub fn send_tagged_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<Vec<(Address, Option<Address>)>> {
+        self.user.send_tagged_packets(link_to, payloads)
+    }
+
     // Unsubscribe from the Channel app instance.
     // pub pub fn unsubscribe(&mut self, link_to: &Address) -> Result<Message> {
     // TODO: lookup link_to Subscribe message.
@@ -236,6 +398,38 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
         self.user.receive_tagged_packet(link)
     }
 
+    /// Receive and process a signed packet message, decrypting the payloads into the provided
+    /// buffers. Returns the sender public key and the public and masked payload lengths.
+    ///
+    ///   # Arguments
+    ///   * `link` - Address of the message to be processed
+    ///   * `public_buf` - Buffer receiving the public payload
+    ///   * `masked_buf` - Buffer receiving the masked payload
+    pub fn receive_signed_packet_into(
+        &mut self,
+        link: &Address,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<(ed25519::PublicKey, usize, usize)> {
+        self.user.receive_signed_packet_into(link, public_buf, masked_buf)
+    }
+
+    /// Receive and process a tagged packet message, decrypting the payloads into the provided
+    /// buffers. Returns the public and masked payload lengths.
+    ///
+    ///   # Arguments
+    ///   * `link` - Address of the message to be processed
+    ///   * `public_buf` - Buffer receiving the public payload
+    ///   * `masked_buf` - Buffer receiving the masked payload
+    pub fn receive_tagged_packet_into(
+        &mut self,
+        link: &Address,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<(usize, usize)> {
+        self.user.receive_tagged_packet_into(link, public_buf, masked_buf)
+    }
+
     /// Receive and process a sequence message.
     ///
     ///  # Arguments
@@ -249,6 +443,15 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
         self.user.fetch_next_msgs()
     }
 
+    /// Process the next messages retrieved for the links of `next_msg_links`, in the same order,
+    /// and return the unwrapped ones
+    ///
+    ///   # Arguments
+    ///   * `msgs` - Results of retrieving the messages
+    pub fn handle_next_msgs(&mut self, msgs: Vec<Result<Message>>) -> Vec<UnwrappedMessage> {
+        self.user.handle_next_msgs(msgs)
+    }
+
     /// Retrieves the previous message from the message specified (provided the user has access to it)
     pub fn fetch_prev_msg(&mut self, link: &Address) -> Result<UnwrappedMessage> {
         self.user.fetch_prev_msg(link)
@@ -259,6 +462,18 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
         self.user.fetch_prev_msgs(link, max)
     }
 
+    /// Retrieves at most `max` previous messages from an original specified messsage link, walking
+    /// back no longer than `timeout`
+    #[cfg(feature = "std")]
+    pub fn fetch_prev_msgs_window(
+        &mut self,
+        link: &Address,
+        max: usize,
+        timeout: core::time::Duration,
+    ) -> Result<Vec<UnwrappedMessage>> {
+        self.user.fetch_prev_msgs_window(link, max, timeout)
+    }
+
     /// Iteratively fetches next message until no new messages can be found, and return a vector
     /// containing all of them.
     pub fn fetch_all_next_msgs(&mut self) -> Vec<UnwrappedMessage> {
@@ -292,6 +507,25 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
     pub fn receive_msg(&mut self, link: &Address) -> Result<UnwrappedMessage> {
         self.user.receive_message(link)
     }
+
+    /// Process a message of unknown type that has already been retrieved from the transport.
+    /// Message will be handled appropriately and the unwrapped contents returned
+    ///
+    ///   # Arguments
+    ///   * `msg` - Binary message to be processed
+    pub fn handle_msg(&mut self, msg: Message) -> Result<UnwrappedMessage> {
+        self.user.handle_message(msg, true)
+    }
+
+    /// Process a batch of messages that have already been retrieved from the transport. Signed
+    /// and tagged packets are unwrapped on up to `workers` threads, state is updated in batch order
+    ///
+    ///   # Arguments
+    ///   * `msgs` - Binary messages to be processed
+    ///   * `workers` - Maximum number of threads unwrapping packets, each gets at least 8 of them
+    pub fn process_batch(&mut self, msgs: Vec<Message>, workers: usize) -> Vec<UnwrappedMessage> {
+        self.user.process_batch(msgs, workers)
+    }
 }
 
 #[cfg(feature = "async")]
@@ -311,6 +545,22 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
         Ok(subscriber)
     }
 
+    /// Restores a Subscriber from a checkpoint and syncs to the latest state. Only messages published
+    /// after the checkpoint was taken are fetched, instead of the whole channel from the announcement.
+    ///
+    ///  # Arguements
+    /// * `seed` - A string slice representing the seed of the user [Characters: A-Z, 9]
+    /// * `checkpoint` - User state exported with the seed as password
+    /// * `transport` - Transport object used for sending and receiving
+    pub async fn recover_from_checkpoint(seed: &str, checkpoint: &[u8], transport: Trans) -> Result<Self> {
+        let mut subscriber = Self {
+            user: User::import_checkpoint(checkpoint, 1, seed, transport)?,
+        };
+        subscriber.sync_state().await;
+
+        Ok(subscriber)
+    }
+
     /// Create and Send a Subscribe message to a Channel app instance.
     ///
     /// # Arguments
@@ -353,6 +603,32 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
             .await
     }
 
+    /// Create and send a chain of signed packets, each one attached to the previous.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub async fn send_signed_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<Vec<(Address, Option<Address>)>> {
+        self.user.send_signed_packets(link_to, payloads).await
+    }
+
+    /// Create and send a chain of tagged packets, each one attached to the previous.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub async fn send_tagged_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<Vec<(Address, Option<Address>)>> {
+        self.user.send_tagged_packets(link_to, payloads).await
+    }
+
     // Unsubscribe from the Channel app instance.
     // pub pub async fn unsubscribe(&mut self, link_to: &Address) -> Result<Message> {
     // TODO: lookup link_to Subscribe message.
@@ -391,6 +667,38 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
         self.user.receive_tagged_packet(link).await
     }
 
+    /// Receive and process a signed packet message, decrypting the payloads into the provided
+    /// buffers. Returns the sender public key and the public and masked payload lengths.
+    ///
+    ///   # Arguments
+    ///   * `link` - Address of the message to be processed
+    ///   * `public_buf` - Buffer receiving the public payload
+    ///   * `masked_buf` - Buffer receiving the masked payload
+    pub async fn receive_signed_packet_into(
+        &mut self,
+        link: &Address,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<(ed25519::PublicKey, usize, usize)> {
+        self.user.receive_signed_packet_into(link, public_buf, masked_buf).await
+    }
+
+    /// Receive and process a tagged packet message, decrypting the payloads into the provided
+    /// buffers. Returns the public and masked payload lengths.
+    ///
+    ///   # Arguments
+    ///   * `link` - Address of the message to be processed
+    ///   * `public_buf` - Buffer receiving the public payload
+    ///   * `masked_buf` - Buffer receiving the masked payload
+    pub async fn receive_tagged_packet_into(
+        &mut self,
+        link: &Address,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<(usize, usize)> {
+        self.user.receive_tagged_packet_into(link, public_buf, masked_buf).await
+    }
+
     /// Receive and process a sequence message.
     ///
     ///  # Arguments
@@ -404,6 +712,15 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
         self.user.fetch_next_msgs().await
     }
 
+    /// Process the next messages retrieved for the links of `next_msg_links`, in the same order,
+    /// and return the unwrapped ones
+    ///
+    ///   # Arguments
+    ///   * `msgs` - Results of retrieving the messages
+    pub async fn handle_next_msgs(&mut self, msgs: Vec<Result<Message>>) -> Vec<UnwrappedMessage> {
+        self.user.handle_next_msgs(msgs).await
+    }
+
     /// Retrieves the previous message from the message specified (provided the user has access to it)
     pub async fn fetch_prev_msg(&mut self, link: &Address) -> Result<UnwrappedMessage> {
         self.user.fetch_prev_msg(link).await
@@ -414,6 +731,18 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
         self.user.fetch_prev_msgs(link, max).await
     }
 
+    /// Retrieves at most `max` previous messages from an original specified messsage link, walking
+    /// back no longer than `timeout`
+    #[cfg(feature = "std")]
+    pub async fn fetch_prev_msgs_window(
+        &mut self,
+        link: &Address,
+        max: usize,
+        timeout: core::time::Duration,
+    ) -> Result<Vec<UnwrappedMessage>> {
+        self.user.fetch_prev_msgs_window(link, max, timeout).await
+    }
+
     /// Iteratively fetches next message until no new messages can be found, and return a vector
     /// containing all of them.
     pub async fn fetch_all_next_msgs(&mut self) -> Vec<UnwrappedMessage> {
@@ -447,6 +776,15 @@ impl<Trans: Transport + Clone> Subscriber<Trans> {
     pub async fn receive_msg(&mut self, link: &Address) -> Result<UnwrappedMessage> {
         self.user.receive_message(link).await
     }
+
+    /// Process a message of unknown type that has already been retrieved from the transport.
+    /// Message will be handled appropriately and the unwrapped contents returned
+    ///
+    ///   # Arguments
+    ///   * `msg` - Binary message to be processed
+    pub async fn handle_msg(&mut self, msg: Message) -> Result<UnwrappedMessage> {
+        self.user.handle_message(msg, true).await
+    }
 }
 
 impl<T: Transport + Clone> fmt::Display for Subscriber<T> {
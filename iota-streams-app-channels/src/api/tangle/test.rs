@@ -8,6 +8,7 @@ use iota_streams_app::message::HasLink;
 
 #[cfg(not(feature = "async"))]
 use iota_streams_core::{
+    prelude::Vec,
     try_or,
     Errors::*,
 };
@@ -120,6 +121,27 @@ pub fn example<T: Transport + Clone>(transport: T) -> Result<()> {
         ensure!(masked_payload == unwrapped_masked, "bad unwrapped masked payload");
     }
 
+    println!("\ntag packets batch");
+    let batch_links = {
+        let payloads = vec![(public_payload.clone(), masked_payload.clone()); 3];
+        let links = author.send_tagged_packets(&tagged_packet_link, &payloads)?;
+        ensure!(links.len() == payloads.len(), "bad number of batch links");
+        links
+    };
+
+    {
+        let mut public_buf = vec![0_u8; public_payload.0.len()];
+        let mut masked_buf = vec![0_u8; masked_payload.0.len()];
+        for (msg, _) in &batch_links {
+            println!("  {}", msg);
+            let (public_len, masked_len) =
+                subscriberB.receive_tagged_packet_into(msg, &mut public_buf, &mut masked_buf)?;
+            let (unwrapped_public, unwrapped_masked) = (&public_buf[..public_len], &masked_buf[..masked_len]);
+            ensure!(public_payload.0 == unwrapped_public, "bad unwrapped public payload");
+            ensure!(masked_payload.0 == unwrapped_masked, "bad unwrapped masked payload");
+        }
+    }
+
     {
         subscriberB.receive_keyload(&keyload_link)?;
     }
@@ -131,7 +153,23 @@ pub fn example<T: Transport + Clone>(transport: T) -> Result<()> {
     let _subscriberB2 = Subscriber::import(subBdump.as_ref(), "pwdSubB", transport.clone()).unwrap();
 
     let authordump = author.export("pwdAuthor").unwrap();
-    let _author2 = Author::import(authordump.as_ref(), "pwdAuthor", transport).unwrap();
+    let _author2 = Author::import(authordump.as_ref(), "pwdAuthor", transport.clone()).unwrap();
+
+    let mut chunks = Vec::new();
+    author.export_to("pwdAuthor", 64, |chunk| {
+        chunks.push(chunk.to_vec());
+        Ok(())
+    })?;
+    ensure!(chunks.concat() == authordump, "streamed export differs");
+    let mut rest = &authordump[..];
+    let source = |buf: &mut [u8]| {
+        let n = buf.len().min(rest.len());
+        buf[..n].copy_from_slice(&rest[..n]);
+        rest = &rest[n..];
+        Ok(n)
+    };
+    let author3 = Author::import_from("pwdAuthor", 64, source, transport)?;
+    ensure!(author3.get_pk() == author.get_pk(), "streamed import differs");
 
     Ok(())
 }
@@ -236,6 +274,28 @@ pub async fn example<T: Transport + Clone>(transport: T) -> Result<()> where
         ensure!(masked_payload == unwrapped_masked, "bad unwrapped masked payload");
     }
 
+    println!("\ntag packets batch");
+    let batch_links = {
+        let payloads = vec![(public_payload.clone(), masked_payload.clone()); 3];
+        let links = author.send_tagged_packets(&tagged_packet_link, &payloads).await?;
+        ensure!(links.len() == payloads.len(), "bad number of batch links");
+        links
+    };
+
+    {
+        let mut public_buf = vec![0_u8; public_payload.0.len()];
+        let mut masked_buf = vec![0_u8; masked_payload.0.len()];
+        for (msg, _) in &batch_links {
+            println!("  {}", msg);
+            let (public_len, masked_len) = subscriberB
+                .receive_tagged_packet_into(msg, &mut public_buf, &mut masked_buf)
+                .await?;
+            let (unwrapped_public, unwrapped_masked) = (&public_buf[..public_len], &masked_buf[..masked_len]);
+            ensure!(public_payload.0 == unwrapped_public, "bad unwrapped public payload");
+            ensure!(masked_payload.0 == unwrapped_masked, "bad unwrapped masked payload");
+        }
+    }
+
     {
         subscriberB.receive_keyload(&keyload_link).await?;
     }
@@ -259,6 +319,321 @@ fn run_basic_scenario() {
     assert!(dbg!(example(transport)).is_ok());
 }
 
+#[test]
+#[cfg(all(feature = "std", not(feature = "async")))]
+fn run_basic_scenario_on_thread_safe_transport() {
+    let transport = iota_streams_app::transport::new_thread_safe_transport(crate::api::tangle::BucketTransport::new());
+    let worker = std::thread::spawn(move || example(transport).map_err(|e| e.to_string()));
+    assert!(dbg!(worker.join().unwrap()).is_ok());
+}
+
+#[test]
+#[cfg(all(feature = "std", not(feature = "async")))]
+fn run_basic_scenario_on_sharded_transport() {
+    let transport = crate::api::tangle::ShardedBucketTransport::with_shards(4);
+    let worker = std::thread::spawn({
+        let transport = transport.clone();
+        move || example(transport).map_err(|e| e.to_string())
+    });
+    assert!(dbg!(worker.join().unwrap()).is_ok());
+    assert!(!transport.is_empty());
+}
+
+#[test]
+#[cfg(not(feature = "async"))]
+fn recover_subscriber_from_checkpoint() -> Result<()> {
+    let transport = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let mut author = Author::new("AUTHOR9SEED", ChannelType::SingleBranch, transport.clone());
+    let mut subscriber = Subscriber::new("SUBSCRIBERA9SEED", transport.clone());
+    let payload = Bytes("PUBLICPAYLOAD".as_bytes().to_vec());
+
+    let announcement = author.send_announce()?;
+    subscriber.receive_announcement(&announcement)?;
+    let (first, _) = author.send_signed_packet(&announcement, &payload, &Bytes::default())?;
+    ensure!(subscriber.fetch_next_msgs().len() == 1);
+    let checkpoint = subscriber.export("SUBSCRIBERA9SEED")?;
+
+    let (second, _) = author.send_signed_packet(&first, &payload, &Bytes::default())?;
+    ensure!(Subscriber::recover_from_checkpoint("SUBSCRIBERB9SEED", &checkpoint, transport.clone()).is_err());
+    let mut recovered = Subscriber::recover_from_checkpoint("SUBSCRIBERA9SEED", &checkpoint, transport)?;
+    ensure!(recovered.fetch_next_msgs().is_empty());
+
+    author.send_signed_packet(&second, &payload, &Bytes::default())?;
+    ensure!(recovered.fetch_next_msgs().len() == 1);
+    Ok(())
+}
+
+#[test]
+#[cfg(all(feature = "std", not(feature = "async")))]
+fn run_basic_scenario_on_cached_transport() {
+    let bucket = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let transport = iota_streams_app::transport::CachedTransport::new(bucket, 16);
+    assert!(dbg!(example(transport)).is_ok());
+}
+
+#[test]
+#[cfg(not(feature = "async"))]
+fn process_packets_batch() -> Result<()> {
+    use iota_streams_core::prelude::Vec;
+    let mut transport = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let mut author = Author::new("AUTHOR9SEED", ChannelType::SingleBranch, transport.clone());
+    let mut subscriber = Subscriber::new("SUBSCRIBERA9SEED", transport.clone());
+    let public_payload = Bytes("PUBLICPAYLOAD".as_bytes().to_vec());
+    let masked_payload = Bytes("MASKEDPAYLOAD".as_bytes().to_vec());
+
+    let announcement = author.send_announce()?;
+    subscriber.receive_announcement(&announcement)?;
+    let mut msgs = Vec::new();
+    // Enough packets for two worker threads
+    for _ in 0..16 {
+        let (link, _) = author.send_signed_packet(&announcement, &public_payload, &masked_payload)?;
+        msgs.push(transport.recv_message(&link)?);
+    }
+
+    let unwrapped = subscriber.process_batch(msgs, 2);
+    ensure!(unwrapped.len() == 16, "bad number of unwrapped packets");
+    for msg in &unwrapped {
+        match &msg.body {
+            MessageContent::SignedPacket {
+                public_payload: p,
+                masked_payload: m,
+                ..
+            } => ensure!(*p == public_payload && *m == masked_payload, "bad unwrapped payload"),
+            _ => ensure!(false, "unexpected message content"),
+        }
+    }
+    ensure!(subscriber.fetch_next_msgs().is_empty(), "batch state not committed");
+    Ok(())
+}
+
+#[test]
+#[cfg(not(feature = "async"))]
+fn restore_evicted_links() -> Result<()> {
+    let transport = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let mut author = Author::new("AUTHOR9SEED", ChannelType::SingleBranch, transport.clone());
+    let mut subscriber = Subscriber::new("SUBSCRIBERA9SEED", transport);
+    author.set_link_store_policy(LinkStorePolicy::Bounded(0));
+    subscriber.set_link_store_policy(LinkStorePolicy::Bounded(1));
+    let public_payload = Bytes("PUBLICPAYLOAD".as_bytes().to_vec());
+    let masked_payload = Bytes("MASKEDPAYLOAD".as_bytes().to_vec());
+
+    let announcement = author.send_announce()?;
+    subscriber.receive_announcement(&announcement)?;
+    let (first, _) = author.send_signed_packet(&announcement, &public_payload, &masked_payload)?;
+    subscriber.receive_signed_packet(&first)?;
+    let mut link = first.clone();
+    for _ in 0..8 {
+        link = author.send_signed_packet(&link, &public_payload, &masked_payload)?.0;
+        subscriber.receive_signed_packet(&link)?;
+    }
+
+    // Both the author and the subscriber have evicted the state of the first packet by now
+    let (last, _) = author.send_signed_packet(&first, &public_payload, &masked_payload)?;
+    let (_, p, m) = subscriber.receive_signed_packet(&last)?;
+    ensure!(p == public_payload && m == masked_payload, "bad unwrapped payload");
+    Ok(())
+}
+
+#[test]
+#[cfg(not(feature = "async"))]
+fn restore_evicted_links_after_import() -> Result<()> {
+    let transport = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let mut author = Author::new("AUTHOR9SEED", ChannelType::SingleBranch, transport.clone());
+    let mut subscriber = Subscriber::new("SUBSCRIBERA9SEED", transport.clone());
+    subscriber.set_link_store_policy(LinkStorePolicy::Bounded(1));
+    let public_payload = Bytes("PUBLICPAYLOAD".as_bytes().to_vec());
+    let masked_payload = Bytes("MASKEDPAYLOAD".as_bytes().to_vec());
+
+    let announcement = author.send_announce()?;
+    subscriber.receive_announcement(&announcement)?;
+    let (first, _) = author.send_signed_packet(&announcement, &public_payload, &masked_payload)?;
+    subscriber.receive_signed_packet(&first)?;
+    let mut link = first.clone();
+    for _ in 0..8 {
+        link = author.send_signed_packet(&link, &public_payload, &masked_payload)?.0;
+        subscriber.receive_signed_packet(&link)?;
+    }
+
+    // The state of the first packet is neither in the exported store nor recorded as evicted
+    let exported = subscriber.export("PASSWORD")?;
+    let mut subscriber = Subscriber::import(&exported, "PASSWORD", transport)?;
+    let (last, _) = author.send_signed_packet(&first, &public_payload, &masked_payload)?;
+    let (_, p, m) = subscriber.receive_signed_packet(&last)?;
+    ensure!(p == public_payload && m == masked_payload, "bad unwrapped payload");
+    Ok(())
+}
+
+#[test]
+#[cfg(not(feature = "async"))]
+fn share_keyloads_with_static_key_exchange() -> Result<()> {
+    let transport = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let mut author = Author::new("AUTHOR9SEED", ChannelType::SingleBranch, transport.clone());
+    let mut subscriber = Subscriber::new("SUBSCRIBERA9SEED", transport);
+    author.set_keyload_key_exchange(KeyloadKeyExchange::Static);
+
+    let announcement = author.send_announce()?;
+    subscriber.receive_announcement(&announcement)?;
+    let subscribe = subscriber.send_subscribe(&announcement)?;
+    author.receive_subscribe(&subscribe)?;
+    // The second keyload reuses the key shared with the subscriber
+    for _ in 0..2 {
+        let (keyload, _) = author.send_keyload_for_everyone(&announcement)?;
+        ensure!(subscriber.receive_keyload(&keyload)?, "keyload not unwrapped");
+    }
+    author.set_keyload_key_exchange(KeyloadKeyExchange::Ephemeral);
+    let (keyload, _) = author.send_keyload_for_everyone(&announcement)?;
+    ensure!(subscriber.receive_keyload(&keyload)?, "keyload not unwrapped");
+    Ok(())
+}
+
+#[test]
+#[cfg(not(feature = "async"))]
+fn read_packet_attached_to_split_keyload() -> Result<()> {
+    let transport = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let mut author = Author::new("AUTHOR9SEED", ChannelType::SingleBranch, transport.clone());
+    let mut subscriberA = Subscriber::new("SUBSCRIBERA9SEED", transport.clone());
+    let mut subscriberB = Subscriber::new("SUBSCRIBERB9SEED", transport.clone());
+    let mut subscriberC = Subscriber::new("SUBSCRIBERC9SEED", transport);
+    let public_payload = Bytes("PUBLICPAYLOAD".as_bytes().to_vec());
+    let masked_payload = Bytes("MASKEDPAYLOAD".as_bytes().to_vec());
+
+    let announcement = author.send_announce()?;
+    for subscriber in [&mut subscriberA, &mut subscriberB, &mut subscriberC].iter_mut() {
+        subscriber.receive_announcement(&announcement)?;
+        let subscribe = subscriber.send_subscribe(&announcement)?;
+        author.receive_subscribe(&subscribe)?;
+    }
+
+    // One recipient per part: subscriber A is only in the first part, the packet is attached to the last one
+    let ke_pks = [*subscriberA.get_pk(), *subscriberB.get_pk(), *subscriberC.get_pk()];
+    let (keyload, _) = author.send_keyload_split(&announcement, &Vec::new(), &ke_pks, 1)?;
+    ensure!(subscriberA.fetch_next_msgs().len() == 3, "keyload parts not fetched");
+    ensure!(subscriberC.receive_keyload(&keyload)?, "keyload not unwrapped");
+
+    let (packet, _) = author.send_tagged_packet(&keyload, &public_payload, &masked_payload)?;
+    let (p, m) = subscriberA.receive_tagged_packet(&packet)?;
+    ensure!(p == public_payload && m == masked_payload, "bad unwrapped payload");
+    let (_, m) = subscriberC.receive_tagged_packet(&packet)?;
+    ensure!(m == masked_payload, "bad unwrapped payload");
+    Ok(())
+}
+
+#[cfg(all(feature = "std", not(feature = "async")))]
+fn journal_path(name: &str) -> std::string::String {
+    let path = std::env::temp_dir().join(format!("streams-journal-{}-{}", name, std::process::id()));
+    let _ = std::fs::remove_file(&path);
+    path.to_string_lossy().into_owned()
+}
+
+#[test]
+#[cfg(all(feature = "std", not(feature = "async")))]
+fn journal_round_trip() -> Result<()> {
+    let transport = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let mut author = User::new("AUTHOR9SEED", ChannelType::SingleBranch, transport.clone());
+    let payload = Bytes("PUBLICPAYLOAD".as_bytes().to_vec());
+    let path = journal_path("round-trip");
+
+    let announcement = author.send_announce()?;
+    let mut journal = StateJournal::create(&path, 0, "PASSWORD", &author)?;
+    let psk = crate::api::psk_from_seed(b"PSK A");
+    let pskid = crate::api::pskid_from_psk(&psk);
+    author.store_psk(pskid, psk);
+    let (mut link, _) = author.send_signed_packet(&announcement, &payload, &Bytes::default())?;
+    journal.sync(&author)?;
+    // The key of a known pre-shared key id is replaced in place
+    author.store_psk(pskid, crate::api::psk_from_seed(b"PSK B"));
+    link = author.send_signed_packet(&link, &payload, &Bytes::default())?.0;
+    journal.sync(&author)?;
+    author.send_signed_packet(&link, &payload, &Bytes::default())?;
+    journal.sync(&author)?;
+
+    let (recovered, _) = StateJournal::open(&path, 0, "PASSWORD", transport.clone())?;
+    ensure!(
+        recovered.export(0, "PASSWORD")? == author.export(0, "PASSWORD")?,
+        "journaled state mismatch"
+    );
+    ensure!(
+        StateJournal::open(&path, 0, "WRONG", transport).is_err(),
+        "opened with a bad password"
+    );
+    std::fs::remove_file(&path).ok();
+    Ok(())
+}
+
+#[test]
+#[cfg(all(feature = "std", not(feature = "async")))]
+fn journal_compaction() -> Result<()> {
+    let transport = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let mut author = User::new("AUTHOR9SEED", ChannelType::SingleBranch, transport.clone());
+    let payload = Bytes("PUBLICPAYLOAD".as_bytes().to_vec());
+    let path = journal_path("compaction");
+
+    let mut link = author.send_announce()?;
+    let mut journal = StateJournal::create(&path, 0, "PASSWORD", &author)?;
+    for _ in 0..8 {
+        link = author.send_signed_packet(&link, &payload, &Bytes::default())?.0;
+        journal.sync(&author)?;
+    }
+    let len = journal.len();
+    journal.compact(&author)?;
+    ensure!(journal.len() < len, "journal not compacted");
+    ensure!(
+        std::fs::metadata(&path).map(|m| m.len()).ok() == Some(journal.len()),
+        "bad journal length"
+    );
+
+    // Records are appended to the compacted file
+    author.send_signed_packet(&link, &payload, &Bytes::default())?;
+    journal.sync(&author)?;
+    let (recovered, _) = StateJournal::open(&path, 0, "PASSWORD", transport)?;
+    ensure!(
+        recovered.export(0, "PASSWORD")? == author.export(0, "PASSWORD")?,
+        "journaled state mismatch"
+    );
+    std::fs::remove_file(&path).ok();
+    Ok(())
+}
+
+#[test]
+#[cfg(all(feature = "std", not(feature = "async")))]
+fn journal_drops_record_cut_short() -> Result<()> {
+    let transport = iota_streams_app::transport::new_shared_transport(crate::api::tangle::BucketTransport::new());
+    let mut author = User::new("AUTHOR9SEED", ChannelType::SingleBranch, transport.clone());
+    let payload = Bytes("PUBLICPAYLOAD".as_bytes().to_vec());
+    let path = journal_path("cut-short");
+
+    let announcement = author.send_announce()?;
+    let mut journal = StateJournal::create(&path, 0, "PASSWORD", &author)?;
+    let (link, _) = author.send_signed_packet(&announcement, &payload, &Bytes::default())?;
+    journal.sync(&author)?;
+    let synced = author.export(0, "PASSWORD")?;
+    let synced_len = journal.len();
+    author.send_signed_packet(&link, &payload, &Bytes::default())?;
+    journal.sync(&author)?;
+    drop(journal);
+
+    // A crash while appending leaves the last record incomplete
+    let file = std::fs::OpenOptions::new().write(true).open(&path).unwrap();
+    file.set_len(synced_len + 5).unwrap();
+    drop(file);
+    let (mut recovered, mut journal) = StateJournal::open(&path, 0, "PASSWORD", transport.clone())?;
+    ensure!(
+        recovered.export(0, "PASSWORD")? == synced,
+        "state of the complete records not recovered"
+    );
+    ensure!(journal.len() == synced_len, "incomplete record not dropped");
+
+    recovered.send_signed_packet(&link, &payload, &Bytes::default())?;
+    journal.sync(&recovered)?;
+    let (reopened, _) = StateJournal::open(&path, 0, "PASSWORD", transport)?;
+    ensure!(
+        reopened.export(0, "PASSWORD")? == recovered.export(0, "PASSWORD")?,
+        "journaled state mismatch"
+    );
+    std::fs::remove_file(&path).ok();
+    Ok(())
+}
+
 #[test]
 #[cfg(feature = "async")]
 fn run_basic_scenario() {
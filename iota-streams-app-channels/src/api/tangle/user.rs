@@ -8,7 +8,10 @@ use iota_streams_core::{
     prng,
     try_or,
     Errors::{
+        MessageLinkNotFoundInTangle,
         UnknownMsgType,
+        UnwrapWorkerPanicked,
+        UserCheckpointMismatch,
         UserNotRegistered,
     },
     Result,
@@ -28,9 +31,28 @@ use iota_streams_core::{
 };
 
 type UserImp = api::user::User<DefaultF, Address, LinkGen, LinkStore, PkStore, PskStore>;
+type Packet = api::user::UnwrappedPacket<DefaultF, Address>;
+
+/// Info committed along with spongos state of a message of the given content type.
+fn msg_info(content_type: u8) -> Result<MsgInfo> {
+    match content_type {
+        message::ANNOUNCE => Ok(MsgInfo::Announce),
+        message::KEYLOAD => Ok(MsgInfo::Keyload),
+        message::SEQUENCE => Ok(MsgInfo::Sequence),
+        message::SIGNED_PACKET => Ok(MsgInfo::SignedPacket),
+        message::TAGGED_PACKET => Ok(MsgInfo::TaggedPacket),
+        message::SUBSCRIBE => Ok(MsgInfo::Subscribe),
+        message::UNSUBSCRIBE => Ok(MsgInfo::Unsubscribe),
+        unknown_content => err!(UnknownMsgType(unknown_content)),
+    }
+}
 
 const ENCODING: &str = "utf-8";
 const PAYLOAD_LENGTH: usize = 32_000;
+/// Spongos states restored at most when a message links to an evicted state
+const MAX_RESTORED_LINKS: usize = 1024;
+/// Packets a worker thread has to unwrap at least when handling a batch
+const MIN_PACKETS_PER_WORKER: usize = 8;
 
 /// Baseline User api object. Contains the api user implementation as well as the transport object
 pub struct User<Trans> {
@@ -125,6 +147,34 @@ impl<Trans> User<Trans> {
         self.user.fetch_state()
     }
 
+    /// Fetches the latest Cursor state of a single publisher
+    /// [Author, Subscriber]
+    ///
+    ///   # Arguments
+    ///   * `pk` - Public key of the publisher
+    pub fn fetch_state_of(&self, pk: &PublicKey) -> Result<Option<Cursor<Address>>> {
+        self.user.fetch_state_of(pk)
+    }
+
+    /// Set the policy for the spongos states of processed messages kept in the link store. Under a
+    /// bounded policy evicted states are restored from the transport when a message links to them
+    /// [Author, Subscriber]
+    ///
+    ///   # Arguments
+    ///   * `policy` - Link store policy
+    pub fn set_link_store_policy(&mut self, policy: LinkStorePolicy) {
+        self.user.set_link_store_policy(policy)
+    }
+
+    /// Set how the keys shared with keyload recipients are derived, ephemeral keys by default
+    /// [Author]
+    ///
+    ///   # Arguments
+    ///   * `key_exchange` - Keyload key exchange
+    pub fn set_keyload_key_exchange(&mut self, key_exchange: KeyloadKeyExchange) {
+        self.user.set_keyload_key_exchange(key_exchange)
+    }
+
     /// Generate a vector containing the next sequenced message identifier for each publishing
     /// participant in the channel
     /// [Author, Subscriber]
@@ -135,6 +185,12 @@ impl<Trans> User<Trans> {
         self.user.gen_next_msg_ids(branching)
     }
 
+    /// Links of the next message of each publisher, as retrieved by `fetch_next_msgs`.
+    pub fn next_msg_links(&self) -> Vec<Address> {
+        let ids = self.user.gen_next_msg_ids(self.user.is_multi_branching());
+        ids.into_iter().map(|(_pk, cursor)| cursor.link).collect()
+    }
+
     /// Commit to state a wrapped message and type
     /// [Author, Subscriber]
     ///
@@ -148,17 +204,115 @@ impl<Trans> User<Trans> {
     pub fn export(&self, flag: u8, pwd: &str) -> Result<Vec<u8>> {
         self.user.export(flag, pwd)
     }
+    pub fn export_to<W>(&self, flag: u8, pwd: &str, chunk_size: usize, sink: W) -> Result<()>
+    where
+        W: FnMut(&[u8]) -> Result<()>,
+    {
+        self.user.export_to(flag, pwd, chunk_size, sink)
+    }
     pub fn import(bytes: &[u8], flag: u8, pwd: &str, tsp: Trans) -> Result<Self> {
         UserImp::import(bytes, flag, pwd).map(|u| Self {
             user: u,
             transport: tsp,
         })
     }
+    pub fn import_from<R>(flag: u8, pwd: &str, chunk_size: usize, source: R, tsp: Trans) -> Result<Self>
+    where
+        R: FnMut(&mut [u8]) -> Result<usize>,
+    {
+        UserImp::import_from(flag, pwd, chunk_size, source).map(|u| Self {
+            user: u,
+            transport: tsp,
+        })
+    }
+
+    /// Deserialize user state exported with the user seed as password, and check that the state
+    /// belongs to the keypair generated from the seed.
+    pub fn import_checkpoint(bytes: &[u8], flag: u8, seed: &str, tsp: Trans) -> Result<Self> {
+        let user = Self::import(bytes, flag, seed, tsp)?;
+        let expected = User::new(seed, ChannelType::SingleBranch, ());
+        try_or!(user.get_pk() == expected.get_pk(), UserCheckpointMismatch)?;
+        Ok(user)
+    }
 
     pub fn store_psk(&mut self, pskid: PskId, psk: Psk) {
         self.user.store_psk(pskid, psk)
     }
 
+    /// Wrap a chain of signed packets without sending them [Author, Subscriber]. The first packet
+    /// is attached to `link_to` and every following packet to the one before it. The chain is
+    /// committed to the user state right away; the returned binary messages (packets and their
+    /// sequence messages, in sending order) are left for the caller to publish, along with the
+    /// links of every packet.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub fn wrap_signed_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<(Vec<Message>, Vec<(Address, Option<Address>)>)> {
+        self.wrap_packets_chained(
+            link_to,
+            payloads,
+            MsgInfo::SignedPacket,
+            |user, link_to, public_payload, masked_payload| user.sign_packet(link_to, public_payload, masked_payload),
+        )
+    }
+
+    /// Wrap a chain of tagged packets without sending them [Author, Subscriber]. See
+    /// `wrap_signed_packets`.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub fn wrap_tagged_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<(Vec<Message>, Vec<(Address, Option<Address>)>)> {
+        self.wrap_packets_chained(
+            link_to,
+            payloads,
+            MsgInfo::TaggedPacket,
+            |user, link_to, public_payload, masked_payload| user.tag_packet(link_to, public_payload, masked_payload),
+        )
+    }
+
+    /// Wrap and commit a chain of packets, each one attached to the previous packet of the chain
+    fn wrap_packets_chained<W>(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+        info: MsgInfo,
+        wrap: W,
+    ) -> Result<(Vec<Message>, Vec<(Address, Option<Address>)>)>
+    where
+        W: Fn(&mut UserImp, &Address, &Bytes, &Bytes) -> Result<WrappedMessage>,
+    {
+        let mut msgs = Vec::with_capacity(2 * payloads.len());
+        let mut links = Vec::with_capacity(payloads.len());
+        let mut link_to = link_to.clone();
+        for (public_payload, masked_payload) in payloads {
+            let msg = wrap(&mut self.user, &link_to, public_payload, masked_payload)?;
+            let seq = self.user.wrap_sequence(link_to.rel())?;
+            msgs.push(Message::new(msg.message));
+            if let Some(seq_msg) = seq.0 {
+                msgs.push(Message::new(seq_msg));
+            }
+            // Next packet of the chain is wrapped against the state of this one, so commit right away.
+            let seq_link = match seq.1 {
+                Some(wrap_state) => self.user.commit_sequence(wrap_state, MsgInfo::Sequence)?,
+                None => None,
+            };
+            let msg_link = self.commit_wrapped(msg.wrapped, info)?;
+            link_to = msg_link.clone();
+            links.push((msg_link, seq_link));
+        }
+        Ok((msgs, links))
+    }
+
     /// Consume a binary sequence message and return the derived message link
     fn process_sequence(&mut self, msg: BinaryMessage, store: bool) -> Result<Address> {
         let unwrapped = self.user.handle_sequence(msg, MsgInfo::Sequence, store)?;
@@ -168,6 +322,51 @@ impl<Trans> User<Trans> {
         );
         Ok(msg_link)
     }
+
+    /// Unwrap and verify a message reached walking back the history before the messages preceding
+    /// it, if it is a packet linked and joined to messages whose state is known. The packet is still
+    /// committed in order with `commit_unwrapped`. None for other messages, which update the state
+    /// of the user and are handled in order.
+    fn unwrap_early(&self, content_type: u8, prev_link: &Address, msg: &Message) -> Option<Result<Packet>> {
+        if content_type != message::SIGNED_PACKET && content_type != message::TAGGED_PACKET
+            || !self.user.has_link(prev_link.rel())
+        {
+            return None;
+        }
+        let join_store = self.user.packet_join_store(&msg.binary).ok()?;
+        let mut packet = Packet::unwrap(&msg.binary, &join_store);
+        if let Ok(packet) = packet.as_mut() {
+            Packet::verify_batch(core::iter::once(packet));
+        }
+        Some(packet)
+    }
+
+    /// Commit a packet unwrapped apart from the user. Packets of a sequence that fail are returned
+    /// as unreadable.
+    fn commit_unwrapped(&mut self, msg: Message, sequenced: bool, packet: Result<Packet>) -> Result<UnwrappedMessage> {
+        let committed = packet.and_then(|packet| {
+            let info = match packet.is_signed() {
+                true => MsgInfo::SignedPacket,
+                false => MsgInfo::TaggedPacket,
+            };
+            self.user.commit_packet(packet, info)
+        });
+        match committed {
+            Ok(m) => Ok(m.map(|content| match content {
+                api::user::PacketContent::Signed(pk, public, masked) => {
+                    MessageContent::new_signed_packet(pk, public, masked)
+                }
+                api::user::PacketContent::Tagged(public, masked) => MessageContent::new_tagged_packet(public, masked),
+            })),
+            Err(e) => match sequenced {
+                true => msg.binary.parse_header().map(|preparsed| {
+                    let prev_link = TangleAddress::from_bytes(&preparsed.header.previous_msg_link.0);
+                    UnwrappedMessage::new(msg.binary.link.clone(), prev_link, MessageContent::unreadable())
+                }),
+                false => Err(e),
+            },
+        }
+    }
 }
 
 #[cfg(not(feature = "async"))]
@@ -181,7 +380,7 @@ impl<Trans: Transport + Clone> User<Trans> {
     /// * `wrapped` - A wrapped sequence object containing the sequence message and state
     fn send_sequence(&mut self, wrapped: WrappedSequence) -> Result<Option<Address>> {
         if let Some(seq_msg) = wrapped.0 {
-            self.transport.send_message(&Message::new(seq_msg))?;
+            self.transport.send_owned_message(Message::new(seq_msg))?;
         }
 
         if let Some(wrap_state) = wrapped.1 {
@@ -193,7 +392,7 @@ impl<Trans: Transport + Clone> User<Trans> {
 
     /// Send a message without using sequencing logic. Reserved for Announce and Subscribe messages
     fn send_message(&mut self, msg: WrappedMessage, info: MsgInfo) -> Result<Address> {
-        self.transport.send_message(&Message::new(msg.message))?;
+        self.transport.send_owned_message(Message::new(msg.message))?;
         self.commit_wrapped(msg.wrapped, info)
     }
 
@@ -210,7 +409,7 @@ impl<Trans: Transport + Clone> User<Trans> {
         info: MsgInfo,
     ) -> Result<(Address, Option<Address>)> {
         let seq = self.user.wrap_sequence(ref_link)?;
-        self.transport.send_message(&Message::new(msg.message))?;
+        self.transport.send_owned_message(Message::new(msg.message))?;
         let seq_link = self.send_sequence(seq)?;
         let msg_link = self.commit_wrapped(msg.wrapped, info)?;
         Ok((msg_link, seq_link))
@@ -238,6 +437,7 @@ impl<Trans: Transport + Clone> User<Trans> {
         public_payload: &Bytes,
         masked_payload: &Bytes,
     ) -> Result<(Address, Option<Address>)> {
+        self.restore_link(link_to)?;
         let msg = self.user.sign_packet(link_to, public_payload, masked_payload)?;
         self.send_message_sequenced(msg, link_to.rel(), MsgInfo::SignedPacket)
     }
@@ -254,11 +454,52 @@ impl<Trans: Transport + Clone> User<Trans> {
         public_payload: &Bytes,
         masked_payload: &Bytes,
     ) -> Result<(Address, Option<Address>)> {
+        self.restore_link(link_to)?;
         let msg = self.user.tag_packet(link_to, public_payload, masked_payload)?;
         self.send_message_sequenced(msg, link_to.rel(), MsgInfo::TaggedPacket)
     }
 
-    /// Create and send a new keyload for a list of subscribers [Author].
+    /// Create and send a chain of signed packets [Author, Subscriber]. The first packet is attached
+    /// to `link_to` and every following packet to the one before it. All messages are wrapped
+    /// up front and handed to the transport as a single batch; as the chain is committed to the
+    /// user state before sending, a failed batch should be followed by a state sync.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub fn send_signed_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<Vec<(Address, Option<Address>)>> {
+        self.restore_link(link_to)?;
+        let (msgs, links) = self.wrap_signed_packets(link_to, payloads)?;
+        self.transport.send_messages(msgs)?;
+        Ok(links)
+    }
+
+    /// Create and send a chain of tagged packets [Author, Subscriber]. The first packet is attached
+    /// to `link_to` and every following packet to the one before it. All messages are wrapped
+    /// up front and handed to the transport as a single batch; as the chain is committed to the
+    /// user state before sending, a failed batch should be followed by a state sync.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub fn send_tagged_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<Vec<(Address, Option<Address>)>> {
+        self.restore_link(link_to)?;
+        let (msgs, links) = self.wrap_tagged_packets(link_to, payloads)?;
+        self.transport.send_messages(msgs)?;
+        Ok(links)
+    }
+
+    /// Create and send a new keyload for a list of subscribers [Author]. Keyloads for more than
+    /// `KEYLOAD_MAX_RECIPIENTS` recipients are split into several messages sharing the session key;
+    /// the links of the last one are returned and messages should be attached to it.
     ///
     ///  # Arguments
     ///  * `link_to` - Address of the message the keyload will be attached to
@@ -270,17 +511,35 @@ impl<Trans: Transport + Clone> User<Trans> {
         psk_ids: &PskIds,
         ke_pks: &Vec<PublicKey>,
     ) -> Result<(Address, Option<Address>)> {
-        let msg = self.user.share_keyload(link_to, psk_ids, ke_pks)?;
-        self.send_message_sequenced(msg, link_to.rel(), MsgInfo::Keyload)
+        self.send_keyload_split(link_to, psk_ids, ke_pks, KEYLOAD_MAX_RECIPIENTS)
     }
 
-    /// Create and send keyload for all subscribed subscribers [Author].
+    /// Create and send a new keyload split into messages of at most `max_recipients` recipients
+    /// each [Author], for transports with smaller messages. The links of the last one are returned.
+    pub fn send_keyload_split(
+        &mut self,
+        link_to: &Address,
+        psk_ids: &PskIds,
+        ke_pks: &[PublicKey],
+        max_recipients: usize,
+    ) -> Result<(Address, Option<Address>)> {
+        self.restore_link(link_to)?;
+        let keyload_key = api::user::KeyloadKey::new();
+        let mut links = (link_to.clone(), None);
+        for (psk_ids, ke_pks) in api::user::split_keyload_recipients(psk_ids, ke_pks, max_recipients) {
+            let msg = self.user.share_keyload_part(link_to, psk_ids, ke_pks, keyload_key)?;
+            links = self.send_message_sequenced(msg, link_to.rel(), MsgInfo::Keyload)?;
+        }
+        Ok(links)
+    }
+
+    /// Create and send keyload for all subscribed subscribers [Author], split like `send_keyload`.
     ///
     ///  # Arguments
     ///  * `link_to` - Address of the message the keyload will be attached to
     pub fn send_keyload_for_everyone(&mut self, link_to: &Address) -> Result<(Address, Option<Address>)> {
-        let msg = self.user.share_keyload_for_everyone(link_to)?;
-        self.send_message_sequenced(msg, link_to.rel(), MsgInfo::Keyload)
+        let (psk_ids, ke_pks) = self.user.keyload_recipients();
+        self.send_keyload(link_to, &psk_ids, &ke_pks)
     }
 
     /// Create and Send a Subscribe message to a Channel app instance [Subscriber].
@@ -300,6 +559,7 @@ impl<Trans: Transport + Clone> User<Trans> {
     ///  * `link` - Address of the message to be processed
     pub fn receive_sequence(&mut self, link: &Address) -> Result<Address> {
         let msg = self.transport.recv_message(link)?;
+        self.restore_prev_link(&msg)?;
         if let Some(_addr) = &self.user.appinst {
             let seq_msg = self.user.handle_sequence(msg.binary, MsgInfo::Sequence, true)?.body;
             let msg_id = self.user.link_gen.link_from(
@@ -319,6 +579,7 @@ impl<Trans: Transport + Clone> User<Trans> {
     ///  * `link` - Address of the message to be processed
     pub fn receive_signed_packet(&mut self, link: &Address) -> Result<(PublicKey, Bytes, Bytes)> {
         let msg = self.transport.recv_message(link)?;
+        self.restore_prev_link(&msg)?;
         // TODO: msg.timestamp is lost
         let m = self.user.handle_signed_packet(msg.binary, MsgInfo::SignedPacket)?;
         Ok(m.body)
@@ -330,16 +591,61 @@ impl<Trans: Transport + Clone> User<Trans> {
     ///  * `link` - Address of the message to be processed
     pub fn receive_tagged_packet(&mut self, link: &Address) -> Result<(Bytes, Bytes)> {
         let msg = self.transport.recv_message(link)?;
+        self.restore_prev_link(&msg)?;
         let m = self.user.handle_tagged_packet(msg.binary, MsgInfo::TaggedPacket)?;
         Ok(m.body)
     }
 
+    /// Receive and process a signed packet message decrypting payloads directly into the provided
+    /// buffers [Author, Subscriber]. Returns the sender public key and the public and masked
+    /// payload lengths.
+    ///
+    ///  # Arguments
+    ///  * `link` - Address of the message to be processed
+    ///  * `public_buf` - Buffer receiving the public payload
+    ///  * `masked_buf` - Buffer receiving the masked payload
+    pub fn receive_signed_packet_into(
+        &mut self,
+        link: &Address,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<(PublicKey, usize, usize)> {
+        let msg = self.transport.recv_message(link)?;
+        self.restore_prev_link(&msg)?;
+        let m = self
+            .user
+            .handle_signed_packet_into(msg.binary, MsgInfo::SignedPacket, public_buf, masked_buf)?;
+        Ok(m.body)
+    }
+
+    /// Receive and process a tagged packet message decrypting payloads directly into the provided
+    /// buffers [Author, Subscriber]. Returns the public and masked payload lengths.
+    ///
+    ///  # Arguments
+    ///  * `link` - Address of the message to be processed
+    ///  * `public_buf` - Buffer receiving the public payload
+    ///  * `masked_buf` - Buffer receiving the masked payload
+    pub fn receive_tagged_packet_into(
+        &mut self,
+        link: &Address,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<(usize, usize)> {
+        let msg = self.transport.recv_message(link)?;
+        self.restore_prev_link(&msg)?;
+        let m = self
+            .user
+            .handle_tagged_packet_into(msg.binary, MsgInfo::TaggedPacket, public_buf, masked_buf)?;
+        Ok(m.body)
+    }
+
     /// Receive and process a subscribe message [Author].
     ///
     ///  # Arguments
     ///  * `link` - Address of the message to be processed
     pub fn receive_subscribe(&mut self, link: &Address) -> Result<()> {
         let msg = self.transport.recv_message(link)?;
+        self.restore_prev_link(&msg)?;
         // TODO: Timestamp is lost.
         self.user.handle_subscribe(msg.binary, MsgInfo::Subscribe)
     }
@@ -359,6 +665,7 @@ impl<Trans: Transport + Clone> User<Trans> {
     ///  * `link` - Address of the message to be processed
     pub fn receive_keyload(&mut self, link: &Address) -> Result<bool> {
         let msg = self.transport.recv_message(link)?;
+        self.restore_prev_link(&msg)?;
         let m = self.user.handle_keyload(msg.binary, MsgInfo::Keyload)?;
         Ok(m.body)
     }
@@ -375,27 +682,66 @@ impl<Trans: Transport + Clone> User<Trans> {
 
     /// Retrieves the next message for each user (if present in transport layer) and returns them [Author, Subscriber]
     pub fn fetch_next_msgs(&mut self) -> Vec<UnwrappedMessage> {
-        let ids = self.user.gen_next_msg_ids(self.user.is_multi_branching());
-        let mut msgs = Vec::new();
-
-        for (
-            _pk,
-            Cursor {
-                link,
-                branch_no: _,
-                seq_no: _,
-            },
-        ) in ids
-        {
-            let msg = self.transport.recv_message(&link);
+        let links = self.next_msg_links();
+        let msgs = self.transport.recv_message_batch(&links);
+        self.handle_next_msgs(msgs)
+    }
 
-            if let Ok(msg) = msg {
-                if let Ok(msg) = self.handle_message(msg, true) {
-                    msgs.push(msg);
+    /// Process the next messages of all publishers, fetched for the links of `next_msg_links` and in
+    /// the same order, and return the unwrapped ones [Author, Subscriber]. Lets the caller retrieve
+    /// the next messages of many users at once.
+    ///
+    ///   # Arguments
+    ///   * `msgs` - Results of retrieving the messages
+    pub fn handle_next_msgs(&mut self, msgs: Vec<Result<Message>>) -> Vec<UnwrappedMessage> {
+        let prev_links = self.next_msg_links();
+        // Messages referenced by the sequence messages among the next messages are retrieved in one
+        // batch. Unwrapping keeps publisher order, signatures of the packets among them are verified
+        // in a batch.
+        let mut fetched = Vec::with_capacity(msgs.len());
+        let mut ref_links = Vec::new();
+        for msg in msgs.into_iter().flatten() {
+            let content_type = msg.binary.parse_header().map(|preparsed| preparsed.header.content_type);
+            match content_type {
+                Ok(message::SEQUENCE) => {
+                    if let Ok(msg_link) = self.process_sequence(msg.binary, true) {
+                        ref_links.push(msg_link);
+                        fetched.push(None);
+                    }
                 }
+                Ok(_) => fetched.push(Some(msg)),
+                Err(_) => {}
             }
         }
-        msgs
+
+        let mut ref_msgs = self.transport.recv_message_batch(&ref_links).into_iter();
+        let mut batch = Vec::with_capacity(fetched.len());
+        for msg in fetched {
+            match msg {
+                Some(msg) => batch.push((msg, false)),
+                None => match ref_msgs.next() {
+                    Some(Ok(msg)) => batch.push((msg, true)),
+                    _ => continue,
+                },
+            }
+        }
+        let unwrapped: Vec<UnwrappedMessage> = self
+            .handle_batch(batch, true, 1)
+            .into_iter()
+            .filter_map(|unwrapped| unwrapped.ok())
+            .collect();
+
+        // Next links of the publishers whose state moved on are hinted to the transport, so that
+        // their messages may already be at hand when the next messages are fetched again
+        let upcoming: Vec<Address> = self
+            .next_msg_links()
+            .into_iter()
+            .filter(|link| !prev_links.contains(link))
+            .collect();
+        if !upcoming.is_empty() {
+            self.transport.prefetch(&upcoming);
+        }
+        unwrapped
     }
 
     /// Retrieves the previous message from the message specified (provided the user has access to it) [Author,
@@ -420,26 +766,69 @@ impl<Trans: Transport + Clone> User<Trans> {
     /// * `link` - Address of message to act as root of previous message fetching
     /// * `max` - The number of msgs to try and parse
     pub fn fetch_prev_msgs(&mut self, link: &Address, max: usize) -> Result<Vec<UnwrappedMessage>> {
-        let mut msg_info: (Address, u8, Message) = self.parse_msg_info(link)?;
-        let mut to_process = Vec::new();
-        let mut msgs = Vec::new();
+        self.walk_prev_msgs(link, max, || false)
+    }
+
+    /// Retrieves at most `max` previous messages from an original specified messsage link, walking
+    /// back no longer than `timeout` [Author, Subscriber]
+    ///
+    /// # Arguments
+    /// * `link` - Address of message to act as root of previous message fetching
+    /// * `max` - The number of msgs to try and parse
+    /// * `timeout` - Time after which no further msgs are retrieved, the msgs reached are returned
+    #[cfg(feature = "std")]
+    pub fn fetch_prev_msgs_window(
+        &mut self,
+        link: &Address,
+        max: usize,
+        timeout: core::time::Duration,
+    ) -> Result<Vec<UnwrappedMessage>> {
+        let deadline = std::time::Instant::now() + timeout;
+        self.walk_prev_msgs(link, max, || std::time::Instant::now() >= deadline)
+    }
 
-        for _ in 0..max {
-            msg_info = self.parse_msg_info(&msg_info.0)?;
+    /// Walk back from `link` until `max` messages are reached or `expired` holds, and return them
+    /// oldest first. The predecessor of each message is hinted to the transport before the message
+    /// is unwrapped, so that a transport retrieving in the background has the next hop under way
+    /// meanwhile. Packets are unwrapped and verified as soon as they are reached when the messages
+    /// they depend on are known, the other messages once the walk is over. State updates are
+    /// committed oldest first either way.
+    fn walk_prev_msgs<E>(&mut self, link: &Address, max: usize, mut expired: E) -> Result<Vec<UnwrappedMessage>>
+    where
+        E: FnMut() -> bool,
+    {
+        let mut link = self.parse_msg_info(link)?.0;
+        // Newest first, along with the packets unwrapped during the walk
+        let mut history = Vec::new();
+
+        while history.len() < max && !expired() {
+            let mut msg_info = self.parse_msg_info(&link)?;
             if msg_info.1 == message::SEQUENCE {
                 let msg_link = self.process_sequence(msg_info.2.binary, false)?;
                 msg_info = self.parse_msg_info(&msg_link)?;
             }
-            to_process.push(msg_info.2);
+            let (prev_link, content_type, msg) = msg_info;
+            if history.len() + 1 < max {
+                self.transport.prefetch(core::slice::from_ref(&prev_link));
+            }
+            let early = self.unwrap_early(content_type, &prev_link, &msg);
+            history.push((msg, early));
+            link = prev_link;
         }
 
-        to_process.reverse();
-        for msg in to_process {
-            let unwrapped = self.handle_message(msg, false)?;
-            msgs.push(unwrapped);
+        let mut unwrapped = Vec::with_capacity(history.len());
+        let mut pending = Vec::new();
+        for (msg, early) in history.into_iter().rev() {
+            match early {
+                Some(packet) => {
+                    unwrapped.extend(self.handle_batch(core::mem::take(&mut pending), false, 1));
+                    unwrapped.push(self.commit_unwrapped(msg, false, packet));
+                }
+                None => pending.push((msg, false)),
+            }
         }
-
-        Ok(msgs)
+        unwrapped.extend(self.handle_batch(pending, false, 1));
+        unwrapped.into_iter().collect()
     }
 
     /// Handle message of unknown type. Ingests a message and unwraps it according to its determined
@@ -448,14 +837,25 @@ impl<Trans: Transport + Clone> User<Trans> {
     /// # Arguments
     /// * `msg` - Binary message of unknown type
     /// * `pk` - Optional ed25519 Public Key of the sending participant. None if unknown
-    pub fn handle_message(&mut self, mut msg0: Message, store: bool) -> Result<UnwrappedMessage> {
-        let mut sequenced = false;
+    pub fn handle_message(&mut self, msg: Message, store: bool) -> Result<UnwrappedMessage> {
+        self.handle_message_impl(msg, store, false)
+    }
+
+    /// Handle message of unknown type, `sequenced` being set for messages referenced by a sequence
+    /// message. Packets of a sequence that the user cannot unwrap are returned as unreadable.
+    fn handle_message_impl(&mut self, mut msg0: Message, store: bool, mut sequenced: bool) -> Result<UnwrappedMessage> {
         loop {
             // Forget TangleMessage and timestamp
             let msg = msg0.binary;
             let preparsed = msg.parse_header()?;
             let link = preparsed.header.link.clone();
             let prev_link = TangleAddress::from_bytes(&preparsed.header.previous_msg_link.0);
+            // Spongos state of the linked message may have been evicted from the link store
+            if let Err(e) = self.restore_link(&prev_link) {
+                if !sequenced {
+                    return Err(e);
+                }
+            }
             match preparsed.header.content_type {
                 message::SIGNED_PACKET => match self.user.handle_signed_packet(msg, MsgInfo::SignedPacket) {
                     Ok(m) => {
@@ -493,6 +893,42 @@ impl<Trans: Transport + Clone> User<Trans> {
         }
     }
 
+    /// Restore spongos states evicted from the link store, walking back from the message at `link`
+    /// to the first one still in the store and unwrapping the messages on the way in order. No record
+    /// of evicted links is kept, which would grow with the messages processed and need persisting:
+    /// any state missing from the store is restored if the transport has it, walking back through
+    /// at most `MAX_RESTORED_LINKS` messages.
+    fn restore_link(&mut self, link: &Address) -> Result<()> {
+        if self.user.has_link(link.rel()) {
+            return Ok(());
+        }
+        let mut evicted = Vec::new();
+        let mut next = link.clone();
+        while !self.user.has_link(next.rel()) {
+            try_or!(
+                evicted.len() < MAX_RESTORED_LINKS,
+                MessageLinkNotFoundInTangle(next.to_string())
+            )?;
+            let msg = self.transport.recv_message(&next)?;
+            let header = msg.binary.parse_header()?.header;
+            next = Address::from_bytes(&header.previous_msg_link.0);
+            evicted.push((msg, msg_info(header.content_type)?));
+            if header.content_type == message::ANNOUNCE {
+                break;
+            }
+        }
+        for (msg, info) in evicted.into_iter().rev() {
+            self.user.restore_link(msg.binary, info)?;
+        }
+        Ok(())
+    }
+
+    /// Restore spongos state of the message `msg` is linked to, see `restore_link`.
+    fn restore_prev_link(&mut self, msg: &Message) -> Result<()> {
+        let prev_link = Address::from_bytes(&msg.binary.parse_header()?.header.previous_msg_link.0);
+        self.restore_link(&prev_link)
+    }
+
     // Get the previous msg link and msg type from header of message
     fn parse_msg_info(&mut self, link: &Address) -> Result<(Address, u8, Message)> {
         let msg = self.transport.recv_message(link)?;
@@ -502,6 +938,122 @@ impl<Trans: Transport + Clone> User<Trans> {
     }
 }
 
+#[cfg(not(feature = "async"))]
+type JoinStore = iota_streams_ddml::link_store::SingleLinkStore<DefaultF, MsgId, MsgInfo>;
+
+#[cfg(not(feature = "async"))]
+impl<Trans: Transport + Clone> User<Trans> {
+    /// Handle a batch of fetched messages [Author, Subscriber]. Signed and tagged packets are
+    /// unwrapped and their signatures verified on up to `workers` threads, while state updates
+    /// are committed in the order of the batch. Messages that cannot be handled are skipped.
+    ///
+    ///   # Arguments
+    ///   * `msgs` - Messages in the order they would be handled one by one
+    ///   * `workers` - Maximum number of threads unwrapping packets, ignored without `std`. Each
+    ///     thread gets at least 8 packets, smaller batches are unwrapped on the calling thread
+    pub fn process_batch(&mut self, msgs: Vec<Message>, workers: usize) -> Vec<UnwrappedMessage> {
+        let msgs = msgs.into_iter().map(|msg| (msg, false)).collect();
+        self.handle_batch(msgs, true, workers)
+            .into_iter()
+            .filter_map(|unwrapped| unwrapped.ok())
+            .collect()
+    }
+
+    /// Handle messages in order, each along with its `sequenced` flag. Consecutive packets
+    /// joined to messages already known are unwrapped together and their signatures checked
+    /// with batch verification; messages depending on state from the batch itself, eg. packets
+    /// following a keyload of the batch, are handled one by one in between.
+    fn handle_batch(
+        &mut self,
+        msgs: Vec<(Message, bool)>,
+        store: bool,
+        workers: usize,
+    ) -> Vec<Result<UnwrappedMessage>> {
+        let mut unwrapped = Vec::with_capacity(msgs.len());
+        let mut detached = Vec::new();
+        for (msg, sequenced) in msgs {
+            if let Ok(join_store) = self.user.packet_join_store(&msg.binary) {
+                detached.push((msg, join_store, sequenced));
+                continue;
+            }
+            self.commit_packets(core::mem::take(&mut detached), workers, &mut unwrapped);
+            unwrapped.push(self.handle_message_impl(msg, store, sequenced));
+        }
+        self.commit_packets(detached, workers, &mut unwrapped);
+        unwrapped
+    }
+
+    fn commit_packets(
+        &mut self,
+        detached: Vec<(Message, JoinStore, bool)>,
+        workers: usize,
+        unwrapped: &mut Vec<Result<UnwrappedMessage>>,
+    ) {
+        if detached.is_empty() {
+            return;
+        }
+        // Spawning threads costs about as much as unwrapping a few packets, small batches are
+        // unwrapped in place.
+        let workers = workers.max(1).min(detached.len() / MIN_PACKETS_PER_WORKER).max(1);
+        let chunk_size = (detached.len() + workers - 1) / workers;
+        let mut chunks = Vec::new();
+        let mut detached = detached.into_iter().peekable();
+        while detached.peek().is_some() {
+            chunks.push(detached.by_ref().take(chunk_size).collect::<Vec<_>>());
+        }
+
+        let unwrap_chunk = |chunk: Vec<(Message, JoinStore, bool)>| {
+            let mut results: Vec<_> = chunk
+                .into_iter()
+                .map(|(msg, join_store, sequenced)| {
+                    let packet = Packet::unwrap(&msg.binary, &join_store);
+                    (msg, sequenced, packet)
+                })
+                .collect();
+            Packet::verify_batch(results.iter_mut().filter_map(|(_, _, r)| r.as_mut().ok()));
+            results
+        };
+        // Each chunk yields its results, or the number of its messages if its worker panicked
+        #[cfg(feature = "std")]
+        let chunks: Vec<core::result::Result<Vec<_>, usize>> = if chunks.len() > 1 {
+            let workers: Vec<_> = chunks
+                .into_iter()
+                .map(|chunk| {
+                    let len = chunk.len();
+                    (len, std::thread::spawn(move || unwrap_chunk(chunk)))
+                })
+                .collect();
+            workers
+                .into_iter()
+                .map(|(len, worker)| worker.join().map_err(|_panic| len))
+                .collect()
+        } else {
+            chunks.into_iter().map(|chunk| Ok(unwrap_chunk(chunk))).collect()
+        };
+        #[cfg(not(feature = "std"))]
+        let chunks: Vec<core::result::Result<Vec<_>, usize>> =
+            chunks.into_iter().map(|chunk| Ok(unwrap_chunk(chunk))).collect();
+
+        let mut results = Vec::new();
+        for chunk in chunks {
+            match chunk {
+                Ok(chunk) => results.extend(chunk.into_iter().map(Some)),
+                Err(len) => results.extend((0..len).map(|_| None)),
+            }
+        }
+        for result in results {
+            let (msg, sequenced, packet) = match result {
+                Some(result) => result,
+                None => {
+                    unwrapped.push(err!(UnwrapWorkerPanicked));
+                    continue;
+                }
+            };
+            unwrapped.push(self.commit_unwrapped(msg, sequenced, packet));
+        }
+    }
+}
+
 #[cfg(feature = "async")]
 impl<Trans: Transport + Clone> User<Trans> {
     // Send
@@ -513,7 +1065,7 @@ impl<Trans: Transport + Clone> User<Trans> {
     /// * `wrapped` - A wrapped sequence object containing the sequence message and state
     async fn send_sequence(&mut self, wrapped: WrappedSequence) -> Result<Option<Address>> {
         if let Some(seq_msg) = wrapped.0 {
-            self.transport.send_message(&Message::new(seq_msg)).await?;
+            self.transport.send_owned_message(Message::new(seq_msg)).await?;
         }
 
         if let Some(wrap_state) = wrapped.1 {
@@ -525,7 +1077,7 @@ impl<Trans: Transport + Clone> User<Trans> {
 
     /// Send a message without using sequencing logic. Reserved for Announce and Subscribe messages
     async fn send_message(&mut self, msg: WrappedMessage, info: MsgInfo) -> Result<Address> {
-        self.transport.send_message(&Message::new(msg.message)).await?;
+        self.transport.send_owned_message(Message::new(msg.message)).await?;
         self.commit_wrapped(msg.wrapped, info)
     }
 
@@ -542,7 +1094,7 @@ impl<Trans: Transport + Clone> User<Trans> {
         info: MsgInfo,
     ) -> Result<(Address, Option<Address>)> {
         let seq = self.user.wrap_sequence(ref_link)?;
-        self.transport.send_message(&Message::new(msg.message)).await?;
+        self.transport.send_owned_message(Message::new(msg.message)).await?;
         let seq_link = self.send_sequence(seq).await?;
         let msg_link = self.commit_wrapped(msg.wrapped, info)?;
         Ok((msg_link, seq_link))
@@ -570,6 +1122,7 @@ impl<Trans: Transport + Clone> User<Trans> {
         public_payload: &Bytes,
         masked_payload: &Bytes,
     ) -> Result<(Address, Option<Address>)> {
+        self.restore_link(link_to).await?;
         let msg = self.user.sign_packet(link_to, public_payload, masked_payload)?;
         self.send_message_sequenced(msg, link_to.rel(), MsgInfo::SignedPacket)
             .await
@@ -587,12 +1140,53 @@ impl<Trans: Transport + Clone> User<Trans> {
         public_payload: &Bytes,
         masked_payload: &Bytes,
     ) -> Result<(Address, Option<Address>)> {
+        self.restore_link(link_to).await?;
         let msg = self.user.tag_packet(link_to, public_payload, masked_payload)?;
         self.send_message_sequenced(msg, link_to.rel(), MsgInfo::TaggedPacket)
             .await
     }
 
-    /// Create and send a new keyload for a list of subscribers [Author].
+    /// Create and send a chain of signed packets [Author, Subscriber]. The first packet is attached
+    /// to `link_to` and every following packet to the one before it. All messages are wrapped
+    /// up front and handed to the transport as a single batch; as the chain is committed to the
+    /// user state before sending, a failed batch should be followed by a state sync.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub async fn send_signed_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<Vec<(Address, Option<Address>)>> {
+        self.restore_link(link_to).await?;
+        let (msgs, links) = self.wrap_signed_packets(link_to, payloads)?;
+        self.transport.send_messages(msgs).await?;
+        Ok(links)
+    }
+
+    /// Create and send a chain of tagged packets [Author, Subscriber]. The first packet is attached
+    /// to `link_to` and every following packet to the one before it. All messages are wrapped
+    /// up front and handed to the transport as a single batch; as the chain is committed to the
+    /// user state before sending, a failed batch should be followed by a state sync.
+    ///
+    ///  # Arguments
+    ///  * `link_to` - Address of the message the first packet will be attached to
+    ///  * `payloads` - Public and masked payload pairs of the packets, in chain order
+    pub async fn send_tagged_packets(
+        &mut self,
+        link_to: &Address,
+        payloads: &[(Bytes, Bytes)],
+    ) -> Result<Vec<(Address, Option<Address>)>> {
+        self.restore_link(link_to).await?;
+        let (msgs, links) = self.wrap_tagged_packets(link_to, payloads)?;
+        self.transport.send_messages(msgs).await?;
+        Ok(links)
+    }
+
+    /// Create and send a new keyload for a list of subscribers [Author]. Keyloads for more than
+    /// `KEYLOAD_MAX_RECIPIENTS` recipients are split into several messages sharing the session key;
+    /// the links of the last one are returned and messages should be attached to it.
     ///
     ///  # Arguments
     ///  * `link_to` - Address of the message the keyload will be attached to
@@ -604,17 +1198,38 @@ impl<Trans: Transport + Clone> User<Trans> {
         psk_ids: &PskIds,
         ke_pks: &Vec<PublicKey>,
     ) -> Result<(Address, Option<Address>)> {
-        let msg = self.user.share_keyload(link_to, psk_ids, ke_pks)?;
-        self.send_message_sequenced(msg, link_to.rel(), MsgInfo::Keyload).await
+        self.send_keyload_split(link_to, psk_ids, ke_pks, KEYLOAD_MAX_RECIPIENTS)
+            .await
+    }
+
+    /// Create and send a new keyload split into messages of at most `max_recipients` recipients
+    /// each [Author], for transports with smaller messages. The links of the last one are returned.
+    pub async fn send_keyload_split(
+        &mut self,
+        link_to: &Address,
+        psk_ids: &PskIds,
+        ke_pks: &[PublicKey],
+        max_recipients: usize,
+    ) -> Result<(Address, Option<Address>)> {
+        self.restore_link(link_to).await?;
+        let keyload_key = api::user::KeyloadKey::new();
+        let mut links = (link_to.clone(), None);
+        for (psk_ids, ke_pks) in api::user::split_keyload_recipients(psk_ids, ke_pks, max_recipients) {
+            let msg = self.user.share_keyload_part(link_to, psk_ids, ke_pks, keyload_key)?;
+            links = self
+                .send_message_sequenced(msg, link_to.rel(), MsgInfo::Keyload)
+                .await?;
+        }
+        Ok(links)
     }
 
-    /// Create and send keyload for all subscribed subscribers [Author].
+    /// Create and send keyload for all subscribed subscribers [Author], split like `send_keyload`.
     ///
     ///  # Arguments
     ///  * `link_to` - Address of the message the keyload will be attached to
     pub async fn send_keyload_for_everyone(&mut self, link_to: &Address) -> Result<(Address, Option<Address>)> {
-        let msg = self.user.share_keyload_for_everyone(link_to)?;
-        self.send_message_sequenced(msg, link_to.rel(), MsgInfo::Keyload).await
+        let (psk_ids, ke_pks) = self.user.keyload_recipients();
+        self.send_keyload(link_to, &psk_ids, &ke_pks).await
     }
 
     /// Create and Send a Subscribe message to a Channel app instance [Subscriber].
@@ -634,6 +1249,7 @@ impl<Trans: Transport + Clone> User<Trans> {
     ///  * `link` - Address of the message to be processed
     pub async fn receive_sequence(&mut self, link: &Address) -> Result<Address> {
         let msg = self.transport.recv_message(link).await?;
+        self.restore_prev_link(&msg).await?;
         if let Some(_addr) = &self.user.appinst {
             let seq_msg = self.user.handle_sequence(msg.binary, MsgInfo::Sequence, true)?.body;
             let msg_id = self.user.link_gen.link_from(
@@ -653,6 +1269,7 @@ impl<Trans: Transport + Clone> User<Trans> {
     ///  * `link` - Address of the message to be processed
     pub async fn receive_signed_packet(&mut self, link: &Address) -> Result<(PublicKey, Bytes, Bytes)> {
         let msg = self.transport.recv_message(link).await?;
+        self.restore_prev_link(&msg).await?;
         // TODO: msg.timestamp is lost
         let m = self.user.handle_signed_packet(msg.binary, MsgInfo::SignedPacket)?;
         Ok(m.body)
@@ -664,16 +1281,61 @@ impl<Trans: Transport + Clone> User<Trans> {
     ///  * `link` - Address of the message to be processed
     pub async fn receive_tagged_packet(&mut self, link: &Address) -> Result<(Bytes, Bytes)> {
         let msg = self.transport.recv_message(link).await?;
+        self.restore_prev_link(&msg).await?;
         let m = self.user.handle_tagged_packet(msg.binary, MsgInfo::TaggedPacket)?;
         Ok(m.body)
     }
 
+    /// Receive and process a signed packet message decrypting payloads directly into the provided
+    /// buffers [Author, Subscriber]. Returns the sender public key and the public and masked
+    /// payload lengths.
+    ///
+    ///  # Arguments
+    ///  * `link` - Address of the message to be processed
+    ///  * `public_buf` - Buffer receiving the public payload
+    ///  * `masked_buf` - Buffer receiving the masked payload
+    pub async fn receive_signed_packet_into(
+        &mut self,
+        link: &Address,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<(PublicKey, usize, usize)> {
+        let msg = self.transport.recv_message(link).await?;
+        self.restore_prev_link(&msg).await?;
+        let m = self
+            .user
+            .handle_signed_packet_into(msg.binary, MsgInfo::SignedPacket, public_buf, masked_buf)?;
+        Ok(m.body)
+    }
+
+    /// Receive and process a tagged packet message decrypting payloads directly into the provided
+    /// buffers [Author, Subscriber]. Returns the public and masked payload lengths.
+    ///
+    ///  # Arguments
+    ///  * `link` - Address of the message to be processed
+    ///  * `public_buf` - Buffer receiving the public payload
+    ///  * `masked_buf` - Buffer receiving the masked payload
+    pub async fn receive_tagged_packet_into(
+        &mut self,
+        link: &Address,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<(usize, usize)> {
+        let msg = self.transport.recv_message(link).await?;
+        self.restore_prev_link(&msg).await?;
+        let m = self
+            .user
+            .handle_tagged_packet_into(msg.binary, MsgInfo::TaggedPacket, public_buf, masked_buf)?;
+        Ok(m.body)
+    }
+
     /// Receive and process a subscribe message [Author].
     ///
     ///  # Arguments
     ///  * `link` - Address of the message to be processed
     pub async fn receive_subscribe(&mut self, link: &Address) -> Result<()> {
         let msg = self.transport.recv_message(link).await?;
+        self.restore_prev_link(&msg).await?;
         // TODO: Timestamp is lost.
         self.user.handle_subscribe(msg.binary, MsgInfo::Subscribe)
     }
@@ -693,6 +1355,7 @@ impl<Trans: Transport + Clone> User<Trans> {
     ///  * `link` - Address of the message to be processed
     pub async fn receive_keyload(&mut self, link: &Address) -> Result<bool> {
         let msg = self.transport.recv_message(link).await?;
+        self.restore_prev_link(&msg).await?;
         let m = self.user.handle_keyload(msg.binary, MsgInfo::Keyload)?;
         Ok(m.body)
     }
@@ -710,24 +1373,48 @@ impl<Trans: Transport + Clone> User<Trans> {
 
     /// Retrieves the next message for each user (if present in transport layer) and returns them [Author, Subscriber]
     pub async fn fetch_next_msgs(&mut self) -> Vec<UnwrappedMessage> {
-        let ids = self.user.gen_next_msg_ids(self.user.is_multi_branching());
-        let mut msgs = Vec::new();
-
-        for (
-            _pk,
-            Cursor {
-                link,
-                branch_no: _,
-                seq_no: _,
-            },
-        ) in ids
-        {
-            let msg = self.transport.recv_message(&link).await;
+        let links = self.next_msg_links();
+        let msgs = self.transport.recv_message_batch(&links).await;
+        self.handle_next_msgs(msgs).await
+    }
 
-            if let Ok(msg) = msg {
-                if let Ok(msg) = self.handle_message(msg, true).await {
-                    msgs.push(msg);
+    /// Process the next messages of all publishers, fetched for the links of `next_msg_links` and in
+    /// the same order, and return the unwrapped ones [Author, Subscriber]. Lets the caller retrieve
+    /// the next messages of many users at once.
+    ///
+    ///   # Arguments
+    ///   * `msgs` - Results of retrieving the messages
+    pub async fn handle_next_msgs(&mut self, msgs: Vec<Result<Message>>) -> Vec<UnwrappedMessage> {
+        // Messages referenced by the sequence messages among the next messages are retrieved in one
+        // batch.
+        let mut fetched = Vec::with_capacity(msgs.len());
+        let mut ref_links = Vec::new();
+        for msg in msgs.into_iter().flatten() {
+            let content_type = msg.binary.parse_header().map(|preparsed| preparsed.header.content_type);
+            match content_type {
+                Ok(message::SEQUENCE) => {
+                    if let Ok(msg_link) = self.process_sequence(msg.binary, true) {
+                        ref_links.push(msg_link);
+                        fetched.push(None);
+                    }
                 }
+                Ok(_) => fetched.push(Some(msg)),
+                Err(_) => {}
+            }
+        }
+
+        let mut ref_msgs = self.transport.recv_message_batch(&ref_links).await.into_iter();
+        let mut msgs = Vec::new();
+        for msg in fetched {
+            let unwrapped = match msg {
+                Some(msg) => self.handle_message(msg, true).await,
+                None => match ref_msgs.next() {
+                    Some(Ok(msg)) => self.handle_message_impl(msg, true, true).await,
+                    _ => continue,
+                },
+            };
+            if let Ok(msg) = unwrapped {
+                msgs.push(msg);
             }
         }
         msgs
@@ -753,25 +1440,58 @@ impl<Trans: Transport + Clone> User<Trans> {
     /// * `link` - Address of message to act as root of previous message fetching
     /// * `max` - The number of msgs to try and parse
     pub async fn fetch_prev_msgs(&mut self, link: &Address, max: usize) -> Result<Vec<UnwrappedMessage>> {
-        let mut msg_info: (Address, u8, Message) = self.parse_msg_info(link).await?;
-        let mut to_process = Vec::new();
-        let mut msgs = Vec::new();
+        self.walk_prev_msgs(link, max, || false).await
+    }
+
+    /// Retrieves at most `max` previous messages from an original specified messsage link, walking
+    /// back no longer than `timeout` [Author, Subscriber]
+    /// # Arguments
+    /// * `link` - Address of message to act as root of previous message fetching
+    /// * `max` - The number of msgs to try and parse
+    /// * `timeout` - Time after which no further msgs are retrieved, the msgs reached are returned
+    #[cfg(feature = "std")]
+    pub async fn fetch_prev_msgs_window(
+        &mut self,
+        link: &Address,
+        max: usize,
+        timeout: core::time::Duration,
+    ) -> Result<Vec<UnwrappedMessage>> {
+        let deadline = std::time::Instant::now() + timeout;
+        self.walk_prev_msgs(link, max, || std::time::Instant::now() >= deadline)
+            .await
+    }
 
-        for _ in 0..max {
-            msg_info = self.parse_msg_info(&msg_info.0).await?;
+    /// Walk back from `link` until `max` messages are reached or `expired` holds, and return them
+    /// oldest first. Packets are unwrapped and verified as soon as they are reached when the
+    /// messages they depend on are known, the other messages once the walk is over. State updates
+    /// are committed oldest first either way.
+    async fn walk_prev_msgs<E>(&mut self, link: &Address, max: usize, mut expired: E) -> Result<Vec<UnwrappedMessage>>
+    where
+        E: FnMut() -> bool,
+    {
+        let mut link = self.parse_msg_info(link).await?.0;
+        // Newest first, along with the packets unwrapped during the walk
+        let mut history = Vec::new();
+
+        while history.len() < max && !expired() {
+            let mut msg_info = self.parse_msg_info(&link).await?;
             if msg_info.1 == message::SEQUENCE {
                 let msg_link = self.process_sequence(msg_info.2.binary, false)?;
                 msg_info = self.parse_msg_info(&msg_link).await?;
             }
-            to_process.push(msg_info.2);
+            let (prev_link, content_type, msg) = msg_info;
+            let early = self.unwrap_early(content_type, &prev_link, &msg);
+            history.push((msg, early));
+            link = prev_link;
         }
 
-        to_process.reverse();
-        for msg in to_process {
-            let unwrapped = self.handle_message(msg, false).await?;
-            msgs.push(unwrapped);
+        let mut msgs = Vec::with_capacity(history.len());
+        for (msg, early) in history.into_iter().rev() {
+            msgs.push(match early {
+                Some(packet) => self.commit_unwrapped(msg, false, packet)?,
+                None => self.handle_message(msg, false).await?,
+            });
         }
-
         Ok(msgs)
     }
 
@@ -780,14 +1500,30 @@ impl<Trans: Transport + Clone> User<Trans> {
     ///
     /// # Arguments
     /// * `msg` - Binary message of unknown type
-    pub async fn handle_message(&mut self, mut msg0: Message, store: bool) -> Result<UnwrappedMessage> {
-        let mut sequenced = false;
+    pub async fn handle_message(&mut self, msg: Message, store: bool) -> Result<UnwrappedMessage> {
+        self.handle_message_impl(msg, store, false).await
+    }
+
+    /// Handle message of unknown type, `sequenced` being set for messages referenced by a sequence
+    /// message. Packets of a sequence that the user cannot unwrap are returned as unreadable.
+    async fn handle_message_impl(
+        &mut self,
+        mut msg0: Message,
+        store: bool,
+        mut sequenced: bool,
+    ) -> Result<UnwrappedMessage> {
         loop {
             // Forget TangleMessage and timestamp
             let msg = msg0.binary;
             let preparsed = msg.parse_header()?;
             let link = preparsed.header.link.clone();
             let prev_link = TangleAddress::from_bytes(&preparsed.header.previous_msg_link.0);
+            // Spongos state of the linked message may have been evicted from the link store
+            if let Err(e) = self.restore_link(&prev_link).await {
+                if !sequenced {
+                    return Err(e);
+                }
+            }
             match preparsed.header.content_type {
                 message::SIGNED_PACKET => match self.user.handle_signed_packet(msg, MsgInfo::SignedPacket) {
                     Ok(m) => {
@@ -825,6 +1561,42 @@ impl<Trans: Transport + Clone> User<Trans> {
         }
     }
 
+    /// Restore spongos states evicted from the link store, walking back from the message at `link`
+    /// to the first one still in the store and unwrapping the messages on the way in order. No record
+    /// of evicted links is kept, which would grow with the messages processed and need persisting:
+    /// any state missing from the store is restored if the transport has it, walking back through
+    /// at most `MAX_RESTORED_LINKS` messages.
+    async fn restore_link(&mut self, link: &Address) -> Result<()> {
+        if self.user.has_link(link.rel()) {
+            return Ok(());
+        }
+        let mut evicted = Vec::new();
+        let mut next = link.clone();
+        while !self.user.has_link(next.rel()) {
+            try_or!(
+                evicted.len() < MAX_RESTORED_LINKS,
+                MessageLinkNotFoundInTangle(next.to_string())
+            )?;
+            let msg = self.transport.recv_message(&next).await?;
+            let header = msg.binary.parse_header()?.header;
+            next = Address::from_bytes(&header.previous_msg_link.0);
+            evicted.push((msg, msg_info(header.content_type)?));
+            if header.content_type == message::ANNOUNCE {
+                break;
+            }
+        }
+        for (msg, info) in evicted.into_iter().rev() {
+            self.user.restore_link(msg.binary, info)?;
+        }
+        Ok(())
+    }
+
+    /// Restore spongos state of the message `msg` is linked to, see `restore_link`.
+    async fn restore_prev_link(&mut self, msg: &Message) -> Result<()> {
+        let prev_link = Address::from_bytes(&msg.binary.parse_header()?.header.previous_msg_link.0);
+        self.restore_link(&prev_link).await
+    }
+
     /// Get the previous msg link and msg type from header of message and return in a tuple alongside
     /// the message itself
     async fn parse_msg_info(&mut self, link: &Address) -> Result<(Address, u8, Message)> {
@@ -10,6 +10,7 @@ use iota_streams_core::{
         string::ToString,
         typenum::U32,
         vec,
+        HashMap,
         Vec,
     },
     prng,
@@ -40,6 +41,7 @@ use iota_streams_ddml::{
     link_store::{
         EmptyLinkStore,
         LinkStore,
+        SingleLinkStore,
     },
     types::*,
 };
@@ -49,6 +51,8 @@ use crate::{
         pk_store::*,
         psk_store::*,
         ChannelType,
+        KeyloadKeyExchange,
+        LinkStorePolicy,
     },
     message::*,
 };
@@ -115,6 +119,152 @@ impl<F, Link: HasLink> WrappedSequence<F, Link> {
     }
 }
 
+/// Signed or tagged packet unwrapped apart from the user, to be committed with `User::commit_packet`.
+pub struct UnwrappedPacket<F, Link: HasLink> {
+    prev_link: Link,
+    seq_no: u64,
+    content: PacketUnwrap<F, Link>,
+    verified: bool,
+}
+
+enum PacketUnwrap<F, Link: HasLink> {
+    Signed(UnwrappedMessage<F, Link, signed_packet::ContentUnwrapDeferred<F, Link>>),
+    Tagged(UnwrappedMessage<F, Link, tagged_packet::ContentUnwrap<F, Link>>),
+}
+
+/// Payloads of a committed packet, along with the sender public key for signed packets.
+pub enum PacketContent {
+    Signed(ed25519::PublicKey, Bytes, Bytes),
+    Tagged(Bytes, Bytes),
+}
+
+impl<F, Link> UnwrappedPacket<F, Link>
+where
+    F: PRP,
+    Link: HasLink + AbsorbExternalFallback<F> + Debug,
+    <Link as HasLink>::Rel: Eq + Default + fmt::Display + SkipFallback<F>,
+{
+    /// Unwrap a signed or tagged packet. The state of the message the packet is joined to comes
+    /// from `store` rather than the user, so that packets of a batch can be unwrapped on different
+    /// threads. Signatures are verified by `verify_batch` or else when packets are committed.
+    pub fn unwrap<Info: Clone>(
+        msg: &BinaryMessage<F, Link>,
+        store: &SingleLinkStore<F, <Link as HasLink>::Rel, Info>,
+    ) -> Result<Self> {
+        let preparsed = msg.parse_header()?;
+        let prev_link = Link::from_bytes(&preparsed.header.previous_msg_link.0);
+        let seq_no = preparsed.header.seq_num.0;
+        let content = match preparsed.header.content_type {
+            SIGNED_PACKET => {
+                let content = signed_packet::ContentUnwrapDeferred::default();
+                PacketUnwrap::Signed(preparsed.unwrap(store, content)?)
+            }
+            TAGGED_PACKET => PacketUnwrap::Tagged(preparsed.unwrap(store, tagged_packet::ContentUnwrap::new())?),
+            content_type => return err!(UnknownMsgType(content_type)),
+        };
+        let verified = matches!(content, PacketUnwrap::Tagged(_));
+        Ok(Self {
+            prev_link,
+            seq_no,
+            content,
+            verified,
+        })
+    }
+
+    pub fn is_signed(&self) -> bool {
+        matches!(self.content, PacketUnwrap::Signed(_))
+    }
+
+    /// Verify the signatures of signed packets with a single batch verification. If the batch
+    /// does not hold, packets are left to be verified one by one when committed.
+    pub fn verify_batch<'a, I>(packets: I) -> bool
+    where
+        I: IntoIterator<Item = &'a mut Self>,
+        Self: 'a,
+    {
+        let mut packets: Vec<&mut Self> = packets.into_iter().filter(|packet| !packet.verified).collect();
+        let batch: Vec<_> = packets
+            .iter()
+            .filter_map(|packet| match &packet.content {
+                PacketUnwrap::Signed(unwrapped) => Some((&unwrapped.pcf.content.sig_pk, &unwrapped.pcf.content.sig)),
+                PacketUnwrap::Tagged(_) => None,
+            })
+            .collect();
+        let verified = DeferredSig::verify_batch(&batch);
+        if verified {
+            for packet in packets.iter_mut() {
+                packet.verified = true;
+            }
+        }
+        verified
+    }
+}
+
+/// Reads the link a packet is joined to, leaving the rest of the packet untouched.
+struct JoinLink<Rel>(Rel);
+
+impl<F, Rel, Store> ContentUnwrap<F, Store> for JoinLink<Rel>
+where
+    F: PRP,
+    Rel: SkipFallback<F>,
+{
+    fn unwrap<'c, IS: io::IStream>(
+        &mut self,
+        _store: &Store,
+        ctx: &'c mut unwrap::Context<F, IS>,
+    ) -> Result<&'c mut unwrap::Context<F, IS>> {
+        self.0.unwrap_skip(ctx)?;
+        Ok(ctx)
+    }
+}
+
+/// Nonce and session key of a keyload. Keyloads for a large set of recipients are split into
+/// several messages sharing the same nonce and session key.
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+pub struct KeyloadKey {
+    pub nonce: NBytes<U16>,
+    pub key: NBytes<U32>,
+}
+
+impl KeyloadKey {
+    pub fn new() -> Self {
+        Self {
+            nonce: NBytes::from(prng::random_nonce()),
+            key: NBytes::from(prng::random_key()),
+        }
+    }
+}
+
+impl Default for KeyloadKey {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Split keyload recipients into parts of at most `max_recipients`, pre-shared keys first. There
+/// is always at least one, possibly empty, part.
+pub fn split_keyload_recipients<'a>(
+    psk_ids: &'a psk::PskIds,
+    ke_pks: &'a [ed25519::PublicKey],
+    max_recipients: usize,
+) -> Vec<(&'a psk::PskIds, &'a [ed25519::PublicKey])> {
+    let max_recipients = max_recipients.max(1);
+    let mut parts = Vec::new();
+    let (mut psk_ids, mut ke_pks) = (psk_ids, ke_pks);
+    loop {
+        let n_psks = psk_ids.len().min(max_recipients);
+        let n_pks = ke_pks.len().min(max_recipients - n_psks);
+        let (part_psk_ids, rest_psk_ids) = psk_ids.split_at(n_psks);
+        let (part_ke_pks, rest_ke_pks) = ke_pks.split_at(n_pks);
+        parts.push((part_psk_ids, part_ke_pks));
+        psk_ids = rest_psk_ids;
+        ke_pks = rest_ke_pks;
+        if psk_ids.is_empty() && ke_pks.is_empty() {
+            return parts;
+        }
+    }
+}
+
 pub struct User<F, Link, LG, LS, PKS, PSKS>
 where
     F: PRP,
@@ -130,6 +280,20 @@ where
     /// Own x25519 key pair corresponding to Ed25519 keypair.
     pub(crate) ke_kp: (x25519::StaticSecret, x25519::PublicKey),
 
+    /// How the keys shared with keyload recipients are derived.
+    pub(crate) key_exchange: KeyloadKeyExchange,
+
+    /// X25519 public key sent in keyload forks: `ke_kp.1`, or the ephemeral key of the keyload
+    /// being prepared.
+    pub(crate) ke_secrets_pk: x25519::PublicKey,
+
+    /// Keys shared with keyload recipients, derived from the secret key of `ke_secrets_pk` and
+    /// their x25519 public keys.
+    pub(crate) ke_secrets: HashMap<x25519::PublicKeyWrap, NBytes<U32>>,
+
+    /// Nonce and session key of the last keyload unwrapped.
+    pub(crate) keyload_key: Option<KeyloadKey>,
+
     /// User' pre-shared keys.
     pub(crate) psk_store: PSKS,
 
@@ -145,6 +309,9 @@ where
     /// Link store.
     pub(crate) link_store: RefCell<LS>,
 
+    /// Policy for the spongos states kept in the link store.
+    pub(crate) link_policy: LinkStorePolicy,
+
     /// Application instance - Link to the announce message.
     /// None if channel is not created or user is not subscribed.
     pub(crate) appinst: Option<Link>,
@@ -176,13 +343,18 @@ where
         Self {
             _phantom: core::marker::PhantomData,
             sig_kp,
+            ke_secrets_pk: ke_kp.1,
             ke_kp,
+            key_exchange: KeyloadKeyExchange::default(),
+            ke_secrets: HashMap::new(),
+            keyload_key: None,
 
             psk_store: PSKS::default(),
             pk_store: PKS::default(),
             author_sig_pk: None,
             link_gen: LG::default(),
             link_store: RefCell::new(LS::default()),
+            link_policy: LinkStorePolicy::default(),
             appinst: None,
             flags: 0,
             message_encoding: Vec::new(),
@@ -222,13 +394,18 @@ where
         Self {
             _phantom: core::marker::PhantomData,
             sig_kp,
+            ke_secrets_pk: ke_kp.1,
             ke_kp,
+            key_exchange: KeyloadKeyExchange::default(),
+            ke_secrets: HashMap::new(),
+            keyload_key: None,
 
             psk_store: PSKS::default(),
             pk_store: PKS::default(),
             author_sig_pk: None,
             link_gen: LG::default(),
             link_store: RefCell::new(LS::default()),
+            link_policy: LinkStorePolicy::default(),
             appinst: None,
             flags,
             message_encoding,
@@ -405,18 +582,18 @@ where
         link_to: &'a <Link as HasLink>::Rel,
         psks: Psks,
         ke_pks: KePks,
+        keyload_key: KeyloadKey,
     ) -> Result<PreparedMessage<'a, F, Link, LS, keyload::ContentWrap<'a, F, Link, Psks, KePks>>>
     where
         Psks: Clone + ExactSizeIterator<Item = psk::IPsk<'a>>,
-        KePks: Clone + ExactSizeIterator<Item = (ed25519::IPk<'a>, x25519::IPk<'a>)>,
+        KePks: Clone + ExactSizeIterator<Item = (ed25519::IPk<'a>, &'a NBytes<U32>)>,
     {
-        let nonce = NBytes::from(prng::random_nonce());
-        let key = NBytes::from(prng::random_key());
         let content = keyload::ContentWrap {
             link: link_to,
-            nonce,
-            key,
+            nonce: keyload_key.nonce,
+            key: keyload_key.key,
             psks,
+            ke_pk: &self.ke_secrets_pk,
             ke_pks,
             sig_kp: &self.sig_kp,
             _phantom: core::marker::PhantomData,
@@ -424,11 +601,53 @@ where
         Ok(PreparedMessage::new(self.link_store.borrow(), header, content))
     }
 
+    /// Derive the keys shared with keyload recipients for the next keyload. Under
+    /// `KeyloadKeyExchange::Static` only the keys not cached yet are derived, otherwise all of them
+    /// from a new ephemeral key.
+    fn cache_ke_secrets<'a>(&mut self, pks: impl Iterator<Item = &'a x25519::PublicKey>) {
+        let ephemeral_ke_sk;
+        let ke_sk = match self.key_exchange {
+            KeyloadKeyExchange::Static => {
+                if self.ke_secrets_pk != self.ke_kp.1 {
+                    self.ke_secrets.clear();
+                    self.ke_secrets_pk = self.ke_kp.1;
+                }
+                &self.ke_kp.0
+            }
+            KeyloadKeyExchange::Ephemeral => {
+                let mut bytes = [0_u8; 32];
+                bytes.copy_from_slice(prng::random_key().as_slice());
+                ephemeral_ke_sk = x25519::StaticSecret::from(bytes);
+                self.ke_secrets.clear();
+                self.ke_secrets_pk = x25519::PublicKey::from(&ephemeral_ke_sk);
+                &ephemeral_ke_sk
+            }
+        };
+        for xpk in pks {
+            self.ke_secrets.entry((*xpk).into()).or_insert_with(|| {
+                let shared = ke_sk.diffie_hellman(xpk);
+                NBytes(GenericArray::clone_from_slice(shared.as_bytes()))
+            });
+        }
+    }
+
+    /// Forget the keys derived from an ephemeral key once its keyload is wrapped.
+    fn forget_ephemeral_ke_secrets(&mut self) {
+        if self.key_exchange == KeyloadKeyExchange::Ephemeral {
+            self.ke_secrets.clear();
+        }
+    }
+
+    fn ke_secret(&self, xpk: &x25519::PublicKey) -> &NBytes<U32> {
+        &self.ke_secrets[<&x25519::PublicKeyWrap>::from(xpk)]
+    }
+
     pub fn prepare_keyload<'a>(
         &'a mut self,
         link_to: &'a Link,
         psk_ids: &psk::PskIds,
-        pks: &'a Vec<ed25519::PublicKey>,
+        pks: &'a [ed25519::PublicKey],
+        keyload_key: KeyloadKey,
     ) -> Result<
         PreparedMessage<
             'a,
@@ -440,7 +659,7 @@ where
                 F,
                 Link,
                 vec::IntoIter<psk::IPsk<'a>>,
-                vec::IntoIter<(ed25519::IPk<'a>, x25519::IPk<'a>)>,
+                vec::IntoIter<(ed25519::IPk<'a>, &'a NBytes<U32>)>,
             >,
         >,
     > {
@@ -455,9 +674,18 @@ where
                     .with_payload_length(1)?
                     .with_seq_num(seq_no)
                     .with_public_key(&self.sig_kp.public);
-                let psks = self.psk_store.filter(psk_ids);
-                let ke_pks = self.pk_store.filter(pks);
-                self.do_prepare_keyload(header, link_to.rel(), psks.into_iter(), ke_pks.into_iter())
+                let xpks: Vec<x25519::PublicKey> = self.pk_store.filter(pks).into_iter().map(|(_, x)| *x).collect();
+                self.cache_ke_secrets(xpks.iter());
+                let user = &*self;
+                let psks = user.psk_store.filter(psk_ids);
+                let mut ke_pks: Vec<_> = user
+                    .pk_store
+                    .filter(pks)
+                    .into_iter()
+                    .map(|(pk, xpk)| (pk, user.ke_secret(xpk)))
+                    .collect();
+                keyload::sort_ke_pks(&mut ke_pks);
+                user.do_prepare_keyload(header, link_to.rel(), psks.into_iter(), ke_pks.into_iter(), keyload_key)
             }
             None => err!(SeqNumRetrievalFailure),
         }
@@ -476,8 +704,8 @@ where
                 'a,
                 F,
                 Link,
-                vec::IntoIter<(&'a psk::PskId, &'a psk::Psk)>,
-                vec::IntoIter<(&'a ed25519::PublicKey, &'a x25519::PublicKey)>,
+                vec::IntoIter<psk::IPsk<'a>>,
+                vec::IntoIter<(&'a ed25519::PublicKey, &'a NBytes<U32>)>,
             >,
         >,
     > {
@@ -492,9 +720,18 @@ where
                     .with_payload_length(1)?
                     .with_seq_num(seq_no)
                     .with_public_key(&self.sig_kp.public);
-                let ipsks = self.psk_store.iter();
-                let ike_pks = self.pk_store.keys();
-                self.do_prepare_keyload(header, link_to.rel(), ipsks.into_iter(), ike_pks.into_iter())
+                let xpks: Vec<x25519::PublicKey> = self.pk_store.keys().map(|(_, x)| *x).collect();
+                self.cache_ke_secrets(xpks.iter());
+                let user = &*self;
+                let ipsks: Vec<_> = user.psk_store.iter().collect();
+                let mut ike_pks: Vec<_> = user
+                    .pk_store
+                    .keys()
+                    .map(|(pk, xpk)| (pk, user.ke_secret(xpk)))
+                    .collect();
+                keyload::sort_ke_pks(&mut ike_pks);
+                let keyload_key = KeyloadKey::new();
+                user.do_prepare_keyload(header, link_to.rel(), ipsks.into_iter(), ike_pks.into_iter(), keyload_key)
             }
             None => err!(SeqNumRetrievalFailure),
         }
@@ -506,15 +743,40 @@ where
         &mut self,
         link_to: &Link,
         psk_ids: &psk::PskIds,
-        ke_pks: &Vec<ed25519::PublicKey>,
+        ke_pks: &[ed25519::PublicKey],
     ) -> Result<WrappedMessage<F, Link>> {
-        self.prepare_keyload(link_to, psk_ids, ke_pks)?.wrap()
+        let keyload_key = KeyloadKey::new();
+        let wrapped = self.prepare_keyload(link_to, psk_ids, ke_pks, keyload_key)?.wrap();
+        self.forget_ephemeral_ke_secrets();
+        wrapped
+    }
+
+    /// Create one of the keyload messages sharing `keyload_key` with a part of the recipients.
+    pub fn share_keyload_part(
+        &mut self,
+        link_to: &Link,
+        psk_ids: &psk::PskIds,
+        ke_pks: &[ed25519::PublicKey],
+        keyload_key: KeyloadKey,
+    ) -> Result<WrappedMessage<F, Link>> {
+        let wrapped = self.prepare_keyload(link_to, psk_ids, ke_pks, keyload_key)?.wrap();
+        self.forget_ephemeral_ke_secrets();
+        wrapped
+    }
+
+    /// Pre-shared key ids and public keys of all the recipients of a keyload for everyone.
+    pub fn keyload_recipients(&self) -> (Vec<psk::PskId>, Vec<ed25519::PublicKey>) {
+        let psk_ids = self.psk_store.iter().map(|(id, _)| *id).collect();
+        let pks = self.pk_store.keys().map(|(pk, _)| *pk).collect();
+        (psk_ids, pks)
     }
 
     /// Create keyload message with a new session key shared with all Subscribers
     /// known to Author.
     pub fn share_keyload_for_everyone(&mut self, link_to: &Link) -> Result<WrappedMessage<F, Link>> {
-        self.prepare_keyload_for_everyone(link_to)?.wrap()
+        let wrapped = self.prepare_keyload_for_everyone(link_to)?.wrap();
+        self.forget_ephemeral_ke_secrets();
+        wrapped
     }
 
     fn lookup_psk<'b>(&'b self, pskid: &psk::PskId) -> Option<&'b psk::Psk> {
@@ -555,7 +817,9 @@ where
                 Self,
                 for<'c> fn(&'c Self, &psk::PskId) -> Option<&'c psk::Psk>,
                 for<'c> fn(&'c Self, &ed25519::PublicKey) -> Option<&'c x25519::StaticSecret>,
-            >::new(self, Self::lookup_psk, Self::lookup_ke_sk, author_sig_pk);
+            >::new(self, Self::lookup_psk, Self::lookup_ke_sk, author_sig_pk)
+            .with_known_key(self.keyload_key.map(|k| (k.nonce, k.key)))
+            .with_own_key(&self.sig_kp.public);
             let unwrapped = preparsed.unwrap(&*self.link_store.borrow(), content)?;
             Ok(unwrapped)
         } else {
@@ -575,8 +839,12 @@ where
         let unwrapped = self.unwrap_keyload(preparsed)?;
         let processed;
 
-        if unwrapped.pcf.content.key.is_some() {
+        if let Some(key) = unwrapped.pcf.content.key {
             // Do not commit if key not found hence spongos state is invalid
+            self.keyload_key = Some(KeyloadKey {
+                nonce: unwrapped.pcf.content.nonce,
+                key,
+            });
             let content = unwrapped.commit(self.link_store.borrow_mut(), info)?;
 
             // Presence of the key indicates the user is allowed
@@ -640,9 +908,20 @@ where
         link_to: &Link,
         public_payload: &Bytes,
         masked_payload: &Bytes,
+    ) -> Result<WrappedMessage<F, Link>> {
+        self.sign_packet_into(link_to, public_payload, masked_payload, Vec::new())
+    }
+
+    /// Same as `sign_packet` but the message is wrapped into `buf`, reusing its allocation.
+    pub fn sign_packet_into(
+        &mut self,
+        link_to: &Link,
+        public_payload: &Bytes,
+        masked_payload: &Bytes,
+        buf: Vec<u8>,
     ) -> Result<WrappedMessage<F, Link>> {
         self.prepare_signed_packet(link_to, public_payload, masked_payload)?
-            .wrap()
+            .wrap_into(buf)
     }
 
     pub fn unwrap_signed_packet<'a>(
@@ -712,11 +991,54 @@ where
         link_to: &Link,
         public_payload: &Bytes,
         masked_payload: &Bytes,
+    ) -> Result<WrappedMessage<F, Link>> {
+        self.tag_packet_into(link_to, public_payload, masked_payload, Vec::new())
+    }
+
+    /// Same as `tag_packet` but the message is wrapped into `buf`, reusing its allocation.
+    pub fn tag_packet_into(
+        &mut self,
+        link_to: &Link,
+        public_payload: &Bytes,
+        masked_payload: &Bytes,
+        buf: Vec<u8>,
     ) -> Result<WrappedMessage<F, Link>> {
         self.prepare_tagged_packet(link_to, public_payload, masked_payload)?
-            .wrap()
+            .wrap_into(buf)
+    }
+
+    pub fn unwrap_signed_packet_into<'a, 'b>(
+        &'a self,
+        preparsed: PreparsedMessage<'a, F, Link>,
+        public_buf: &'b mut [u8],
+        masked_buf: &'b mut [u8],
+    ) -> Result<UnwrappedMessage<F, Link, signed_packet::ContentUnwrapInto<'b, F, Link>>> {
+        self.ensure_appinst(&preparsed)?;
+        let content = signed_packet::ContentUnwrapInto::new(public_buf, masked_buf);
+        preparsed.unwrap(&*self.link_store.borrow(), content)
     }
+    /// Same as `handle_signed_packet` but payloads are decrypted directly into the provided buffers,
+    /// the message body holds the sender public key and the public and masked payload lengths.
+    pub fn handle_signed_packet_into(
+        &'_ mut self,
+        msg: BinaryMessage<F, Link>,
+        info: <LS as LinkStore<F, <Link as HasLink>::Rel>>::Info,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<GenericMessage<Link, (ed25519::PublicKey, usize, usize)>> {
+        let preparsed = msg.parse_header()?;
+        let prev_link = Link::from_bytes(&preparsed.header.previous_msg_link.0);
+        let seq_no = preparsed.header.seq_num;
+        let content = self
+            .unwrap_signed_packet_into(preparsed, public_buf, masked_buf)?
+            .commit(self.link_store.borrow_mut(), info)?;
+        if !self.is_multi_branching() {
+            self.store_state_for_all(msg.link.rel().clone(), seq_no.0 as u32 + 1)?;
+        }
 
+        let body = (content.sig_pk, content.public_payload.len, content.masked_payload.len);
+        Ok(GenericMessage::new(msg.link, prev_link, body))
+    }
     pub fn unwrap_tagged_packet(
         &self,
         preparsed: PreparsedMessage<'_, F, Link>,
@@ -746,6 +1068,91 @@ where
         Ok(GenericMessage::new(msg.link, prev_link, body))
     }
 
+    /// Look up the state of the message a signed or tagged packet is joined to. Along with
+    /// `UnwrappedPacket::unwrap` and `commit_packet` this splits packet handling so that only
+    /// the lookup and the commit need access to the user.
+    pub fn packet_join_store(
+        &self,
+        msg: &BinaryMessage<F, Link>,
+    ) -> Result<SingleLinkStore<F, <Link as HasLink>::Rel, <LS as LinkStore<F, <Link as HasLink>::Rel>>::Info>> {
+        let preparsed = msg.parse_header()?;
+        let content_type = preparsed.header.content_type;
+        try_or!(
+            content_type == SIGNED_PACKET || content_type == TAGGED_PACKET,
+            UnknownMsgType(content_type)
+        )?;
+        self.ensure_appinst(&preparsed)?;
+        let store = EmptyLinkStore::<F, <Link as HasLink>::Rel, ()>::default();
+        let joined = preparsed.unwrap(&store, JoinLink(<Link as HasLink>::Rel::default()))?;
+        let link = joined.pcf.content.0;
+        let (inner, info) = self.link_store.borrow().lookup_inner(&link)?;
+        Ok(SingleLinkStore::new(link, inner, info))
+    }
+
+    /// Commit a packet unwrapped with `UnwrappedPacket::unwrap`, verifying its signature unless
+    /// already verified in a batch. Packets must be committed in the order they would have been
+    /// handled in.
+    pub fn commit_packet(
+        &mut self,
+        packet: UnwrappedPacket<F, Link>,
+        info: <LS as LinkStore<F, <Link as HasLink>::Rel>>::Info,
+    ) -> Result<GenericMessage<Link, PacketContent>> {
+        let (link, content) = match packet.content {
+            PacketUnwrap::Signed(unwrapped) => {
+                if !packet.verified {
+                    unwrapped.pcf.content.sig.verify(&unwrapped.pcf.content.sig_pk)?;
+                }
+                let link = unwrapped.link.clone();
+                let content = unwrapped.commit(self.link_store.borrow_mut(), info)?;
+                let body = PacketContent::Signed(content.sig_pk, content.public_payload, content.masked_payload);
+                (link, body)
+            }
+            PacketUnwrap::Tagged(unwrapped) => {
+                let link = unwrapped.link.clone();
+                let content = unwrapped.commit(self.link_store.borrow_mut(), info)?;
+                let body = PacketContent::Tagged(content.public_payload, content.masked_payload);
+                (link, body)
+            }
+        };
+        if !self.is_multi_branching() {
+            self.store_state_for_all(link.rel().clone(), packet.seq_no as u32 + 1)?;
+        }
+
+        Ok(GenericMessage::new(link, packet.prev_link, content))
+    }
+    pub fn unwrap_tagged_packet_into<'b>(
+        &self,
+        preparsed: PreparsedMessage<'_, F, Link>,
+        public_buf: &'b mut [u8],
+        masked_buf: &'b mut [u8],
+    ) -> Result<UnwrappedMessage<F, Link, tagged_packet::ContentUnwrapInto<'b, F, Link>>> {
+        self.ensure_appinst(&preparsed)?;
+        let content = tagged_packet::ContentUnwrapInto::new(public_buf, masked_buf);
+        preparsed.unwrap(&*self.link_store.borrow(), content)
+    }
+    /// Same as `handle_tagged_packet` but payloads are decrypted directly into the provided buffers,
+    /// the message body holds the public and masked payload lengths.
+    pub fn handle_tagged_packet_into(
+        &mut self,
+        msg: BinaryMessage<F, Link>,
+        info: <LS as LinkStore<F, <Link as HasLink>::Rel>>::Info,
+        public_buf: &mut [u8],
+        masked_buf: &mut [u8],
+    ) -> Result<GenericMessage<Link, (usize, usize)>> {
+        let preparsed = msg.parse_header()?;
+        let prev_link = Link::from_bytes(&preparsed.header.previous_msg_link.0);
+        let seq_no = preparsed.header.seq_num;
+        let content = self
+            .unwrap_tagged_packet_into(preparsed, public_buf, masked_buf)?
+            .commit(self.link_store.borrow_mut(), info)?;
+        if !self.is_multi_branching() {
+            self.store_state_for_all(msg.link.rel().clone(), seq_no.0 as u32 + 1)?;
+        }
+
+        let body = (content.public_payload.len, content.masked_payload.len);
+        Ok(GenericMessage::new(msg.link, prev_link, body))
+    }
+
     pub fn prepare_sequence<'a>(
         &'a mut self,
         link_to: &'a Link,
@@ -827,6 +1234,7 @@ where
                 cursor.next_seq();
                 wrapped.commit(self.link_store.borrow_mut(), info)?;
                 self.pk_store.insert(self.sig_kp.public, cursor)?;
+                self.evict_links();
                 Ok(Some(link))
             }
             None => {
@@ -958,7 +1366,7 @@ where
 
     // TODO: Turn it into iterator.
     pub fn gen_next_msg_ids(&self, branching: bool) -> Vec<(ed25519::PublicKey, Cursor<Link>)> {
-        let mut ids = Vec::new();
+        let mut ids = Vec::with_capacity(self.pk_store.len());
 
         // TODO: Do the same for self.sig_kp.public
         for pk_info in self.pk_store.iter() {
@@ -973,6 +1381,7 @@ where
             cursor.link = link;
             cursor.next_seq();
             self.pk_store.insert(pk, cursor)?;
+            self.evict_links();
         }
         Ok(())
     }
@@ -985,12 +1394,95 @@ where
                 cursor.link = link.clone();
                 cursor.seq_no = seq_no;
             }
+            self.evict_links();
+        }
+        Ok(())
+    }
+
+    /// Set the policy for the spongos states kept in the link store, evicting the states it doesn't
+    /// keep right away.
+    pub fn set_link_store_policy(&mut self, policy: LinkStorePolicy) {
+        self.link_policy = policy;
+        if let LinkStorePolicy::Bounded(window) = policy {
+            self.evict_links_to(window);
+        }
+    }
+
+    /// Set how the keys shared with keyload recipients are derived, see `KeyloadKeyExchange`.
+    pub fn set_keyload_key_exchange(&mut self, key_exchange: KeyloadKeyExchange) {
+        self.key_exchange = key_exchange;
+        self.ke_secrets.clear();
+    }
+
+    /// Whether spongos state of the message at `link` is in the link store.
+    pub fn has_link(&self, link: &<Link as HasLink>::Rel) -> bool {
+        self.link_store.borrow().contains(link)
+    }
+
+    /// Apply the link store policy. States are evicted in bulk once the store outgrows twice the
+    /// states the policy keeps, so that eviction cost is amortized over the messages processed.
+    fn evict_links(&self) {
+        if let LinkStorePolicy::Bounded(window) = self.link_policy {
+            if self.link_store.borrow().len() > 2 * (window + self.pk_store.len() + 1) {
+                self.evict_links_to(window);
+            }
+        }
+    }
+
+    fn evict_links_to(&self, window: usize) {
+        let appinst = self.appinst.as_ref().map(|appinst| appinst.rel());
+        let pk_store = &self.pk_store;
+        let retain = |link: &<Link as HasLink>::Rel| {
+            appinst == Some(link) || pk_store.iter().any(|(_pk, cursor)| &cursor.link == link)
+        };
+        self.link_store.borrow_mut().evict(window, &retain);
+    }
+
+    /// Restore spongos state of a message evicted from the link store. Spongos state of the message
+    /// it is linked to must be in the store; no other user state is changed.
+    pub fn restore_link(
+        &self,
+        msg: BinaryMessage<F, Link>,
+        info: <LS as LinkStore<F, <Link as HasLink>::Rel>>::Info,
+    ) -> Result<()> {
+        let preparsed = msg.parse_header()?;
+        match preparsed.header.content_type {
+            ANNOUNCE => {
+                self.unwrap_announcement(preparsed)?
+                    .commit(self.link_store.borrow_mut(), info)?;
+            }
+            SUBSCRIBE => {
+                self.unwrap_subscribe(preparsed)?
+                    .commit(self.link_store.borrow_mut(), info)?;
+            }
+            KEYLOAD => {
+                let unwrapped = self.unwrap_keyload(preparsed)?;
+                // Spongos state is only valid if the session key was found
+                try_or!(
+                    unwrapped.pcf.content.key.is_some(),
+                    MessageUnwrapFailure(hex::encode(msg.link.to_bytes()))
+                )?;
+                unwrapped.commit(self.link_store.borrow_mut(), info)?;
+            }
+            SIGNED_PACKET => {
+                self.unwrap_signed_packet(preparsed)?
+                    .commit(self.link_store.borrow_mut(), info)?;
+            }
+            TAGGED_PACKET => {
+                self.unwrap_tagged_packet(preparsed)?
+                    .commit(self.link_store.borrow_mut(), info)?;
+            }
+            SEQUENCE => {
+                self.unwrap_sequence(preparsed)?
+                    .commit(self.link_store.borrow_mut(), info)?;
+            }
+            unknown_content => return err!(UnknownMsgType(unknown_content)),
         }
         Ok(())
     }
 
     pub fn fetch_state(&self) -> Result<Vec<(ed25519::PublicKey, Cursor<Link>)>> {
-        let mut state = Vec::new();
+        let mut state = Vec::with_capacity(self.pk_store.len());
         try_or!(self.appinst.is_some(), UserNotRegistered)?;
 
         for (
@@ -1007,6 +1499,15 @@ where
         }
         Ok(state)
     }
+
+    /// Latest state of a single publisher, looked up without walking the whole store.
+    pub fn fetch_state_of(&self, pk: &ed25519::PublicKey) -> Result<Option<Cursor<Link>>> {
+        try_or!(self.appinst.is_some(), UserNotRegistered)?;
+        Ok(self.pk_store.get(pk).map(|cursor| {
+            let link = Link::from_base_rel(self.appinst.as_ref().unwrap().base(), &cursor.link);
+            Cursor::new_at(link, cursor.branch_no, cursor.seq_no)
+        }))
+    }
 }
 
 impl<F, Link, LG, LS, PKS, PSKS> ContentSizeof<F> for User<F, Link, LG, LS, PKS, PSKS>
@@ -1043,9 +1544,9 @@ where
         let links = link_store.iter();
         let repeated_links = Size(links.len());
         let psks = self.psk_store.iter();
-        let repeated_psks = Size(psks.len());
+        let repeated_psks = Size(self.psk_store.len());
         let pks = self.pk_store.iter();
-        let repeated_pks = Size(pks.len());
+        let repeated_pks = Size(self.pk_store.len());
         ctx.absorb(repeated_links)?
             .repeated(links.into_iter(), |ctx, (link, (s, info))| {
                 ctx.absorb(<&Fallback<<Link as HasLink>::Rel>>::from(link))?
@@ -1114,9 +1615,9 @@ where
         let links = link_store.iter();
         let repeated_links = Size(links.len());
         let psks = self.psk_store.iter();
-        let repeated_psks = Size(psks.len());
+        let repeated_psks = Size(self.psk_store.len());
         let pks = self.pk_store.iter();
-        let repeated_pks = Size(pks.len());
+        let repeated_pks = Size(self.pk_store.len());
         ctx.absorb(repeated_links)?
             .repeated(links.into_iter(), |ctx, (link, (s, info))| {
                 ctx.absorb(<&Fallback<<Link as HasLink>::Rel>>::from(link))?
@@ -1248,6 +1749,8 @@ where
             public: sig_pk,
         };
         self.ke_kp = x25519::keypair_from_ed25519(&self.sig_kp);
+        self.ke_secrets.clear();
+        self.keyload_key = None;
         self.link_store = RefCell::new(link_store);
         self.psk_store = psk_store;
         self.pk_store = pk_store;
@@ -1276,29 +1779,38 @@ where
     PSKS: PresharedKeyStore,
 {
     pub fn export(&self, flag: u8, pwd: &str) -> Result<Vec<u8>> {
-        const VERSION: u8 = 0;
-        let buf_size = {
-            let mut ctx = sizeof::Context::<F>::new();
-            ctx.absorb(Uint8(VERSION))?.absorb(Uint8(flag))?;
-            self.sizeof(&mut ctx)?;
-            ctx.get_size()
-        };
+        self.export_into(flag, pwd, Vec::new())
+    }
 
-        let mut buf = vec![0; buf_size];
+    /// Same as `export`, handing the encrypted state over to `sink` in chunks of about
+    /// `chunk_size` bytes as it is serialized.
+    pub fn export_to<W>(&self, flag: u8, pwd: &str, chunk_size: usize, sink: W) -> Result<()>
+    where
+        W: FnMut(&[u8]) -> Result<()>,
+    {
+        self.export_into(flag, pwd, io::ChunkedOStream::new(chunk_size, sink))?
+            .finish()
+    }
 
-        {
-            let mut ctx = wrap::Context::new(&mut buf[..]);
-            let prng = prng::from_seed::<F>("IOTA Streams Channels app", pwd);
-            let key = NBytes::<U32>(prng.gen_arr("user export key"));
-            ctx.absorb(Uint8(VERSION))?
-                .absorb(Uint8(flag))?
-                .absorb(External(&key))?;
-            let store = EmptyLinkStore::<F, <Link as HasLink>::Rel, ()>::default();
-            self.wrap(&store, &mut ctx)?;
-            try_or!(ctx.stream.is_empty(), OutputStreamNotFullyConsumed(ctx.stream.len()))?;
-        }
+    fn export_into<OS: io::OStream>(&self, flag: u8, pwd: &str, stream: OS) -> Result<OS> {
+        // Version 1 appends the session key of the last keyload unwrapped
+        const VERSION: u8 = 1;
+        let mut ctx = wrap::Context::<F, OS>::new(stream);
+        let prng = prng::from_seed::<F>("IOTA Streams Channels app", pwd);
+        let key = NBytes::<U32>(prng.gen_arr("user export key"));
+        ctx.absorb(Uint8(VERSION))?
+            .absorb(Uint8(flag))?
+            .absorb(External(&key))?;
+        let store = EmptyLinkStore::<F, <Link as HasLink>::Rel, ()>::default();
+        self.wrap(&store, &mut ctx)?;
 
-        Ok(buf)
+        let oneof_keyload_key = Uint8(if self.keyload_key.is_some() { 1 } else { 0 });
+        ctx.absorb(&oneof_keyload_key)?;
+        if let Some(ref keyload_key) = self.keyload_key {
+            ctx.mask(&keyload_key.nonce)?.mask(&keyload_key.key)?;
+        }
+        ctx.commit()?.squeeze(Mac(32))?;
+        Ok(ctx.stream)
     }
 }
 
@@ -1315,15 +1827,33 @@ where
     PSKS: PresharedKeyStore + Default,
 {
     pub fn import(bytes: &[u8], flag: u8, pwd: &str) -> Result<Self> {
-        const VERSION: u8 = 0;
+        let (user, rest) = Self::import_from_stream(bytes, flag, pwd)?;
+        try_or!(rest.is_empty(), InputStreamNotFullyConsumed(rest.len()))?;
+        Ok(user)
+    }
+
+    /// Same as `import`, pulling the encrypted state from `source` in chunks of about `chunk_size`
+    /// bytes as it is deserialized. The source fills the buffer it is given and returns the number
+    /// of bytes written, 0 once the state has been read.
+    pub fn import_from<R>(flag: u8, pwd: &str, chunk_size: usize, source: R) -> Result<Self>
+    where
+        R: FnMut(&mut [u8]) -> Result<usize>,
+    {
+        let (user, rest) = Self::import_from_stream(io::ChunkedIStream::new(chunk_size, source), flag, pwd)?;
+        rest.finish()?;
+        Ok(user)
+    }
+
+    fn import_from_stream<IS: io::IStream>(stream: IS, flag: u8, pwd: &str) -> Result<(Self, IS)> {
+        const VERSION: u8 = 1;
 
-        let mut ctx = unwrap::Context::new(bytes);
+        let mut ctx = unwrap::Context::new(stream);
         let prng = prng::from_seed::<F>("IOTA Streams Channels app", pwd);
         let key = NBytes::<U32>(prng.gen_arr("user export key"));
         let mut version = Uint8(0);
         let mut flag2 = Uint8(0);
         ctx.absorb(&mut version)?
-            .guard(version.0 == VERSION, UserVersionRecoveryFailure(VERSION, version.0))?
+            .guard(version.0 <= VERSION, UserVersionRecoveryFailure(VERSION, version.0))?
             .absorb(&mut flag2)?
             .guard(flag2.0 == flag, UserFlagRecoveryFailure(flag, flag2.0))?
             .absorb(External(&key))?;
@@ -1331,7 +1861,18 @@ where
         let mut user = User::default();
         let store = EmptyLinkStore::<F, <Link as HasLink>::Rel, ()>::default();
         user.unwrap(&store, &mut ctx)?;
-        try_or!(ctx.stream.is_empty(), InputStreamNotFullyConsumed(ctx.stream.len()))?;
-        Ok(user)
+
+        if version.0 > 0 {
+            let mut oneof_keyload_key = Uint8(0);
+            ctx.absorb(&mut oneof_keyload_key)?
+                .guard(oneof_keyload_key.0 < 2, KeyloadKeyRecoveryFailure(oneof_keyload_key.0))?;
+            if oneof_keyload_key.0 == 1 {
+                let mut keyload_key = KeyloadKey::default();
+                ctx.mask(&mut keyload_key.nonce)?.mask(&mut keyload_key.key)?;
+                user.keyload_key = Some(keyload_key);
+            }
+            ctx.commit()?.squeeze(Mac(32))?;
+        }
+        Ok((user, ctx.stream))
     }
 }
@@ -35,13 +35,19 @@
 //!
 //! * `psk` -- Pre-shared key known to the author and to a legit recipient.
 //!
-//! * `xpk` -- Recipient's X25519 public key.
+//! * `xpk` -- Recipient's X25519 public key. Slots are sorted by recipient key so that a recipient
+//! finds its own by binary search, they have a fixed size and are not forked while looking up.
 //!
-//! * `eph_key` -- X25519 random ephemeral key.
+//! * `eph_key` -- X25519 public key of the sender, a random ephemeral key per keyload by default.
+//! Senders may opt in to their static X25519 key instead and reuse the common keys derived for it
+//! in following keyloads, a unique nonce keeps session keys apart; a leak of that key then exposes
+//! every past keyload.
 //!
 //! * `xkey` -- X25519 common key.
 //!
-//! * `key` -- Session key; a legit recipient gets it from corresponding fork.
+//! * `key` -- Session key; a legit recipient gets it from corresponding fork. A large set of recipients
+//! may be split across several keyloads with the same nonce and session key, a recipient of one of them
+//! can then unwrap the others.
 //!
 //! * `sig` -- Optional signature; allows to authenticate keyload.
 //!
@@ -50,6 +56,8 @@
 //! 2) Keyload is not authenticated (signed). It can later be implicitly authenticated
 //!     via `SignedPacket`.
 
+use core::cmp::Ordering;
+
 use iota_streams_app::message::{
     self,
     HasLink,
@@ -59,11 +67,13 @@ use iota_streams_core::{
         typenum::Unsigned as _,
         Vec,
     },
+    err,
     psk,
     sponge::{
         prp::PRP,
         spongos,
     },
+    Errors::PublicKeyGenerationFailure,
     Result,
 };
 use iota_streams_core_edsig::{
@@ -85,6 +95,7 @@ pub struct ContentWrap<'a, F, Link: HasLink, Psks, KePks> {
     pub nonce: NBytes<U16>,
     pub key: NBytes<U32>,
     pub(crate) psks: Psks,
+    pub(crate) ke_pk: &'a x25519::PublicKey,
     pub(crate) ke_pks: KePks,
     pub(crate) sig_kp: &'a ed25519::Keypair,
     pub(crate) _phantom: core::marker::PhantomData<(F, Link)>,
@@ -96,7 +107,7 @@ where
     Link: HasLink,
     <Link as HasLink>::Rel: 'a + Eq + SkipFallback<F>,
     Psks: Clone + ExactSizeIterator<Item = psk::IPsk<'a>>,
-    KePks: Clone + ExactSizeIterator<Item = (ed25519::IPk<'a>, x25519::IPk<'a>)>,
+    KePks: Clone + ExactSizeIterator<Item = (ed25519::IPk<'a>, &'a NBytes<U32>)>,
 {
     fn sizeof<'c>(&self, ctx: &'c mut sizeof::Context<F>) -> Result<&'c mut sizeof::Context<F>> {
         let store = EmptyLinkStore::<F, <Link as HasLink>::Rel, ()>::default();
@@ -114,8 +125,14 @@ where
                 })
             })?
             .skip(repeated_ke_pks)?
-            .repeated(self.ke_pks.clone(), |ctx, (sig_pk, ke_pk)| {
-                ctx.fork(|ctx| ctx.absorb(sig_pk)?.x25519(ke_pk, &self.key))
+            .repeated(self.ke_pks.clone(), |ctx, (sig_pk, secret)| {
+                ctx.fork(|ctx| {
+                    ctx.absorb(sig_pk)?
+                        .absorb(self.ke_pk)?
+                        .absorb(External(secret))?
+                        .commit()?
+                        .mask(&self.key)
+                })
             })?
             .absorb(External(&self.key))?
             .ed25519(self.sig_kp, HashSig)?
@@ -131,7 +148,7 @@ where
     <Link as HasLink>::Rel: 'a + Eq + SkipFallback<F>,
     Store: LinkStore<F, <Link as HasLink>::Rel>,
     Psks: Clone + ExactSizeIterator<Item = psk::IPsk<'a>>,
-    KePks: Clone + ExactSizeIterator<Item = (ed25519::IPk<'a>, x25519::IPk<'a>)>,
+    KePks: Clone + ExactSizeIterator<Item = (ed25519::IPk<'a>, &'a NBytes<U32>)>,
 {
     fn wrap<'c, OS: io::OStream>(
         &self,
@@ -152,8 +169,15 @@ where
                 })
             })?
             .skip(repeated_ke_pks)?
-            .repeated(self.ke_pks.clone().into_iter(), |ctx, (sig_pk, ke_pk)| {
-                ctx.fork(|ctx| ctx.absorb(sig_pk)?.x25519(ke_pk, &self.key))
+            .repeated(self.ke_pks.clone().into_iter(), |ctx, (sig_pk, secret)| {
+                // The common key is precomputed by the sender, see the x25519 command.
+                ctx.fork(|ctx| {
+                    ctx.absorb(sig_pk)?
+                        .absorb(self.ke_pk)?
+                        .absorb(External(secret))?
+                        .commit()?
+                        .mask(&self.key)
+                })
             })?
             .absorb(External(&self.key))?
             .ed25519(self.sig_kp, HashSig)?
@@ -175,6 +199,8 @@ pub struct ContentUnwrap<'a, F, Link: HasLink, LookupArg: 'a, LookupPsk, LookupK
     pub(crate) lookup_ke_sk: LookupKeSk,
     pub(crate) ke_pks: Vec<ed25519::PublicKey>,
     pub key: Option<NBytes<U32>>, // TODO: unify with spongos::Spongos::<F>::KEY_SIZE
+    pub(crate) known_key: Option<(NBytes<U16>, NBytes<U32>)>,
+    pub(crate) own_ke_pk: Option<&'a ed25519::PublicKey>,
     pub(crate) sig_pk: &'a ed25519::PublicKey,
     _phantom: core::marker::PhantomData<(F, Link)>,
 }
@@ -203,10 +229,57 @@ where
             lookup_ke_sk,
             ke_pks: Vec::new(),
             key: None,
+            known_key: None,
+            own_ke_pk: None,
             sig_pk,
             _phantom: core::marker::PhantomData,
         }
     }
+
+    /// Session key of a keyload with the same nonce, for keyloads split across several messages.
+    pub fn with_known_key(mut self, known_key: Option<(NBytes<U16>, NBytes<U32>)>) -> Self {
+        self.known_key = known_key;
+        self
+    }
+
+    /// Public key of the user, its slot is then looked up by binary search instead of trying
+    /// `lookup_ke_sk` on every recipient.
+    pub fn with_own_key(mut self, own_ke_pk: &'a ed25519::PublicKey) -> Self {
+        self.own_ke_pk = Some(own_ke_pk);
+        self
+    }
+
+    /// Index of the public key slot addressed to the user. Senders sort slots by recipient key
+    /// bytes, slots of keyloads that are not sorted are scanned.
+    fn find_slot(&self, slots: &[u8]) -> Option<usize> {
+        let n = slots.len() / KE_SLOT_SIZE;
+        match self.own_ke_pk {
+            Some(own_ke_pk) => {
+                let own = own_ke_pk.as_bytes();
+                let key = |i: usize| &slots[i * KE_SLOT_SIZE..i * KE_SLOT_SIZE + ed25519::PUBLIC_KEY_LENGTH];
+                let (mut lo, mut hi) = (0, n);
+                while lo < hi {
+                    let mid = lo + (hi - lo) / 2;
+                    match key(mid).cmp(&own[..]) {
+                        Ordering::Less => lo = mid + 1,
+                        Ordering::Greater => hi = mid,
+                        Ordering::Equal => return Some(mid),
+                    }
+                }
+                (0..n).find(|&i| key(i) == &own[..])
+            }
+            None => (0..n).find(|&i| (self.lookup_ke_sk)(self.lookup_arg, &self.ke_pks[i]).is_some()),
+        }
+    }
+}
+
+/// Size of a public key slot: recipient key and, in its fork, the X25519 key of the sender and the
+/// masked session key.
+const KE_SLOT_SIZE: usize = ed25519::PUBLIC_KEY_LENGTH + x25519::PUBLIC_KEY_LENGTH + 32;
+
+/// Sort public key recipients by key bytes, so that each of them finds its slot by binary search.
+pub(crate) fn sort_ke_pks<T>(ke_pks: &mut [(ed25519::IPk<'_>, T)]) {
+    ke_pks.sort_by(|(a, _), (b, _)| a.as_bytes().cmp(b.as_bytes()));
 }
 
 impl<'a, F, Link, Store, LookupArg, LookupPsk, LookupKeSk> message::ContentUnwrap<F, Store>
@@ -229,9 +302,14 @@ where
         let mut repeated_ke_pks = Size(0);
         let mut pskid = psk::PskId::default();
 
+        ctx.join(store, &mut self.link)?.absorb(&mut self.nonce)?;
+        if let Some((nonce, key)) = self.known_key {
+            if nonce == self.nonce {
+                self.key = Some(key);
+            }
+        }
+
         ctx
-            .join(store, &mut self.link)?
-            .absorb(&mut self.nonce)?
             .skip(&mut repeated_psks)?
             .repeated(repeated_psks, |ctx| {
                 if self.key.is_none() {
@@ -256,30 +334,38 @@ where
                     ctx.drop(n)
                 }
             })?
-            .skip(&mut repeated_ke_pks)?
-            .repeated(repeated_ke_pks, |ctx| {
-                ctx.fork(|ctx| {
-                    let mut ke_pk = ed25519::PublicKey::default();
-                    ctx.absorb(&mut ke_pk)?;
-                    if let Some(ke_sk) = (self.lookup_ke_sk)(self.lookup_arg, &ke_pk) {
-                        let mut key = NBytes::<U32>::default();
-                        ctx.x25519(ke_sk, &mut key)?;
-                        self.key = Some(key);
-                        // Save the relevant public key
-                        self.ke_pk = ke_pk;
-                        self.ke_pks.push(ke_pk);
-                        Ok(ctx)
-                    } else {
-                        self.ke_pks.push(ke_pk);
-                        // Just drop the rest of the forked message so not to waste Spongos operations
-                        // TODO: key length
-                        let n = Size(64);
-                        ctx.drop(n)
-                    }
-                })
-            })?
-            //.guard(self.key.is_some(), "Key not found")?
-        ;
+            .skip(&mut repeated_ke_pks)?;
+
+        // Public key slots have a fixed size and are read first, the fork addressed to the user
+        // is found without forking the others. They are read slot by slot so that a bogus count
+        // doesn't allocate more than the message holds.
+        let mut slots = Vec::new();
+        for _ in 0..repeated_ke_pks.0 {
+            let slot = ctx.stream.try_advance(KE_SLOT_SIZE)?;
+            match ed25519::PublicKey::from_bytes(&slot[..ed25519::PUBLIC_KEY_LENGTH]) {
+                Ok(ke_pk) => self.ke_pks.push(ke_pk),
+                Err(_) => return err!(PublicKeyGenerationFailure),
+            }
+            slots.extend_from_slice(slot);
+        }
+        if self.key.is_none() {
+            if let Some(i) = self.find_slot(&slots) {
+                let ke_pk = self.ke_pks[i];
+                if let Some(ke_sk) = (self.lookup_ke_sk)(self.lookup_arg, &ke_pk) {
+                    let slot = &slots[i * KE_SLOT_SIZE..(i + 1) * KE_SLOT_SIZE];
+                    let mut fork = unwrap::Context {
+                        spongos: ctx.spongos.fork(),
+                        stream: &slot[ed25519::PUBLIC_KEY_LENGTH..],
+                    };
+                    fork.spongos.absorb(&slot[..ed25519::PUBLIC_KEY_LENGTH]);
+                    let mut key = NBytes::<U32>::default();
+                    fork.x25519(ke_sk, &mut key)?;
+                    self.key = Some(key);
+                    // Save the relevant public key
+                    self.ke_pk = ke_pk;
+                }
+            }
+        }
         if let Some(ref key) = self.key {
             ctx.absorb(External(key))?.ed25519(self.sig_pk, HashSig)?.commit()?;
         }
@@ -142,3 +142,98 @@ where
         Ok(ctx)
     }
 }
+
+/// Unwraps a `SignedPacket` without verifying its signature, `sig` has to be verified before the
+/// content can be trusted.
+pub struct ContentUnwrapDeferred<F, Link: HasLink> {
+    pub(crate) link: <Link as HasLink>::Rel,
+    pub(crate) public_payload: Bytes,
+    pub(crate) masked_payload: Bytes,
+    pub(crate) sig_pk: ed25519::PublicKey,
+    pub(crate) sig: DeferredSig,
+    pub(crate) _phantom: core::marker::PhantomData<(F, Link)>,
+}
+
+impl<F, Link> Default for ContentUnwrapDeferred<F, Link>
+where
+    Link: HasLink,
+    <Link as HasLink>::Rel: Eq + Default + SkipFallback<F>,
+{
+    fn default() -> Self {
+        Self {
+            link: <<Link as HasLink>::Rel as Default>::default(),
+            public_payload: Bytes::default(),
+            masked_payload: Bytes::default(),
+            sig_pk: ed25519::PublicKey::default(),
+            sig: DeferredSig::default(),
+            _phantom: core::marker::PhantomData,
+        }
+    }
+}
+
+impl<F, Link, Store> message::ContentUnwrap<F, Store> for ContentUnwrapDeferred<F, Link>
+where
+    F: PRP,
+    Link: HasLink,
+    <Link as HasLink>::Rel: Eq + Default + SkipFallback<F>,
+    Store: LinkStore<F, <Link as HasLink>::Rel>,
+{
+    fn unwrap<'c, IS: io::IStream>(
+        &mut self,
+        store: &Store,
+        ctx: &'c mut unwrap::Context<F, IS>,
+    ) -> Result<&'c mut unwrap::Context<F, IS>> {
+        ctx.join(store, &mut self.link)?
+            .absorb(&mut self.sig_pk)?
+            .absorb(&mut self.public_payload)?
+            .mask(&mut self.masked_payload)?
+            .ed25519(&self.sig_pk, &mut self.sig)?;
+        Ok(ctx)
+    }
+}
+
+/// Unwraps a `SignedPacket` decrypting the payloads directly into caller-provided buffers.
+pub struct ContentUnwrapInto<'b, F, Link: HasLink> {
+    pub(crate) link: <Link as HasLink>::Rel,
+    pub(crate) public_payload: BytesBuf<'b>,
+    pub(crate) masked_payload: BytesBuf<'b>,
+    pub(crate) sig_pk: ed25519::PublicKey,
+    pub(crate) _phantom: core::marker::PhantomData<(F, Link)>,
+}
+
+impl<'b, F, Link> ContentUnwrapInto<'b, F, Link>
+where
+    Link: HasLink,
+    <Link as HasLink>::Rel: Eq + Default + SkipFallback<F>,
+{
+    pub fn new(public_buf: &'b mut [u8], masked_buf: &'b mut [u8]) -> Self {
+        Self {
+            link: <<Link as HasLink>::Rel as Default>::default(),
+            public_payload: BytesBuf::new(public_buf),
+            masked_payload: BytesBuf::new(masked_buf),
+            sig_pk: ed25519::PublicKey::default(),
+            _phantom: core::marker::PhantomData,
+        }
+    }
+}
+
+impl<'b, F, Link, Store> message::ContentUnwrap<F, Store> for ContentUnwrapInto<'b, F, Link>
+where
+    F: PRP,
+    Link: HasLink,
+    <Link as HasLink>::Rel: Eq + Default + SkipFallback<F>,
+    Store: LinkStore<F, <Link as HasLink>::Rel>,
+{
+    fn unwrap<'c, IS: io::IStream>(
+        &mut self,
+        store: &Store,
+        ctx: &'c mut unwrap::Context<F, IS>,
+    ) -> Result<&'c mut unwrap::Context<F, IS>> {
+        ctx.join(store, &mut self.link)?
+            .absorb(&mut self.sig_pk)?
+            .absorb(&mut self.public_payload)?
+            .mask(&mut self.masked_payload)?
+            .ed25519(&self.sig_pk, HashSig)?;
+        Ok(ctx)
+    }
+}
@@ -143,3 +143,48 @@ where
         Ok(ctx)
     }
 }
+
+/// Unwraps a `TaggedPacket` decrypting the payloads directly into caller-provided buffers.
+pub struct ContentUnwrapInto<'b, F, Link: HasLink> {
+    pub(crate) link: <Link as HasLink>::Rel,
+    pub(crate) public_payload: BytesBuf<'b>,
+    pub(crate) masked_payload: BytesBuf<'b>,
+    pub(crate) _phantom: core::marker::PhantomData<(F, Link)>,
+}
+
+impl<'b, F, Link> ContentUnwrapInto<'b, F, Link>
+where
+    Link: HasLink,
+    <Link as HasLink>::Rel: Eq + Default + SkipFallback<F>,
+{
+    pub fn new(public_buf: &'b mut [u8], masked_buf: &'b mut [u8]) -> Self {
+        Self {
+            link: <<Link as HasLink>::Rel as Default>::default(),
+            public_payload: BytesBuf::new(public_buf),
+            masked_payload: BytesBuf::new(masked_buf),
+            _phantom: core::marker::PhantomData,
+        }
+    }
+}
+
+impl<'b, F, Link, Store> message::ContentUnwrap<F, Store> for ContentUnwrapInto<'b, F, Link>
+where
+    F: PRP,
+    Link: HasLink,
+    <Link as HasLink>::Rel: Eq + Default + SkipFallback<F>,
+    Store: LinkStore<F, <Link as HasLink>::Rel>,
+{
+    fn unwrap<'c, IS: io::IStream>(
+        &mut self,
+        store: &Store,
+        ctx: &'c mut unwrap::Context<F, IS>,
+    ) -> Result<&'c mut unwrap::Context<F, IS>> {
+        let mac = Mac(spongos::MacSize::<F>::USIZE);
+        ctx.join(store, &mut self.link)?
+            .absorb(&mut self.public_payload)?
+            .mask(&mut self.masked_payload)?
+            .commit()?
+            .squeeze(&mac)?;
+        Ok(ctx)
+    }
+}
@@ -3,15 +3,12 @@ use iota_streams_core::Result;
 
 use super::*;
 use iota_streams_core::{
+    metrics_time,
+    prelude::Vec,
     sponge::prp::PRP,
-    try_or,
-    Errors::OutputStreamNotFullyConsumed,
 };
 use iota_streams_ddml::{
-    command::{
-        sizeof,
-        wrap,
-    },
+    command::wrap,
     link_store::LinkStore,
     types::*,
 };
@@ -50,22 +47,22 @@ where
     Content: ContentWrap<F, Store>,
 {
     pub fn wrap(&self) -> Result<WrappedMessage<F, Link>> {
-        let buf_size = {
-            let mut ctx = sizeof::Context::<F>::new();
-            self.header.sizeof(&mut ctx)?;
-            self.content.sizeof(&mut ctx)?;
-            ctx.get_size()
-        };
-
-        let mut buf = vec![0; buf_size];
+        self.wrap_into(Vec::new())
+    }
 
-        let spongos = {
-            let mut ctx = wrap::Context::new(&mut buf[..]);
+    /// Wrap the message into `buf` reusing its allocation, the buffer becomes the message body.
+    ///
+    /// The message is wrapped in a single pass, the buffer growing as needed, rather than being
+    /// sized with `sizeof` first. A buffer with enough capacity left over from a previous message
+    /// is not reallocated.
+    pub fn wrap_into(&self, mut buf: Vec<u8>) -> Result<WrappedMessage<F, Link>> {
+        buf.clear();
+        let (spongos, buf) = metrics_time!(Wrap, {
+            let mut ctx = wrap::Context::new(buf);
             self.header.wrap(&*self.store, &mut ctx)?;
             self.content.wrap(&*self.store, &mut ctx)?;
-            try_or!(ctx.stream.is_empty(), OutputStreamNotFullyConsumed(ctx.stream.len()))?;
-            ctx.spongos
-        };
+            (ctx.spongos, ctx.stream)
+        });
 
         Ok(WrappedMessage {
             wrapped: WrapState {
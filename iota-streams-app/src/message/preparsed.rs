@@ -3,7 +3,10 @@ use iota_streams_core::Result;
 use core::fmt;
 
 use super::*;
-use iota_streams_core::sponge::prp::PRP;
+use iota_streams_core::{
+    metrics_time,
+    sponge::prp::PRP,
+};
 use iota_streams_ddml::command::unwrap;
 
 /// Message context preparsed for unwrapping.
@@ -31,7 +34,7 @@ impl<'a, F, Link: Default + Clone> PreparsedMessage<'a, F, Link> {
         F: PRP,
     {
         let mut pcf = pcf::PCF::default_with_content(content);
-        pcf.unwrap(store, &mut self.ctx)?;
+        metrics_time!(Unwrap, pcf.unwrap(store, &mut self.ctx))?;
         // Discard what's left of `self.ctx.stream`
         Ok(UnwrappedMessage {
             link: self.header.link,
@@ -61,11 +61,15 @@ where
     Msg: LinkedMessage<Link> + Clone,
 {
     fn send_message(&mut self, msg: &Msg) -> Result<()> {
+        self.send_owned_message(msg.clone())
+    }
+
+    fn send_owned_message(&mut self, msg: Msg) -> Result<()> {
         if let Some(msgs) = self.bucket.get_mut(msg.link()) {
-            msgs.push(msg.clone());
+            msgs.push(msg);
             Ok(())
         } else {
-            self.bucket.insert(msg.link().clone(), vec![msg.clone()]);
+            self.bucket.insert(msg.link().clone(), vec![msg]);
             Ok(())
         }
     }
@@ -87,11 +91,15 @@ where
     Msg: LinkedMessage<Link> + Clone + core::marker::Send + core::marker::Sync,
 {
     async fn send_message(&mut self, msg: &Msg) -> Result<()> {
+        self.send_owned_message(msg.clone()).await
+    }
+
+    async fn send_owned_message(&mut self, msg: Msg) -> Result<()> {
         if let Some(msgs) = self.bucket.get_mut(msg.link()) {
-            msgs.push(msg.clone());
+            msgs.push(msg);
             Ok(())
         } else {
-            self.bucket.insert(msg.link().clone(), vec![msg.clone()]);
+            self.bucket.insert(msg.link().clone(), vec![msg]);
             Ok(())
         }
     }
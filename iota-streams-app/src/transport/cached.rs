@@ -0,0 +1,675 @@
+//! Transport keeping recently sent and received messages in a local cache.
+//!
+//! Streams messages are immutable once attached, so a message fetched once never has to be fetched again. The cache is
+//! bounded by the number of links it keeps and evicts the least recently used link first. Its contents can be saved
+//! to a backing file and loaded back in a later session.
+//!
+//! Links hinted with `prefetch` are retrieved in the background when the inner transport supports it, so that a later
+//! read finds them in the cache. A read of a link being prefetched waits for it rather than retrieving it twice.
+
+use super::*;
+use crate::message::LinkedMessage;
+use core::{
+    fmt::Display,
+    hash,
+};
+use std::{
+    collections::BTreeMap,
+    sync::Condvar,
+};
+
+use iota_streams_core::{
+    err,
+    metrics_add,
+    prelude::{
+        string::ToString,
+        sync::{
+            Mutex,
+            MutexGuard,
+        },
+        Arc,
+        HashMap,
+        HashSet,
+        String,
+    },
+    wrapped_err,
+    Errors::{
+        BadCacheFile,
+        CacheFileFailure,
+        MessageLinkNotFound,
+        MessageNotUnique,
+    },
+    WrappedError,
+};
+
+#[cfg(not(feature = "async"))]
+use core::fmt::Debug;
+#[cfg(not(feature = "async"))]
+use iota_streams_core::prelude::Box;
+
+#[cfg(feature = "async")]
+use iota_streams_core::prelude::Box;
+
+/// Messages indexed by link with least recently used eviction.
+pub struct MessageCache<Link, Msg> {
+    capacity: usize,
+    entries: HashMap<Link, (u64, Vec<Msg>)>,
+    usage: BTreeMap<u64, Link>,
+    tick: u64,
+}
+
+impl<Link, Msg> MessageCache<Link, Msg>
+where
+    Link: Eq + hash::Hash + Clone,
+    Msg: Clone,
+{
+    /// Create a cache keeping messages of at most `capacity` links, zero capacity disables caching.
+    pub fn new(capacity: usize) -> Self {
+        Self {
+            capacity,
+            entries: HashMap::new(),
+            usage: BTreeMap::new(),
+            tick: 0,
+        }
+    }
+
+    pub fn capacity(&self) -> usize {
+        self.capacity
+    }
+
+    /// Number of cached links.
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+
+    /// Whether messages are cached for `link`, without marking them as recently used.
+    pub fn contains(&self, link: &Link) -> bool {
+        self.entries.contains_key(link)
+    }
+
+    /// Get messages cached for `link` and mark them as recently used.
+    pub fn get(&mut self, link: &Link) -> Option<Vec<Msg>> {
+        self.touch(link).map(|msgs| msgs.clone())
+    }
+
+    /// Cache messages found at `link`, replacing previously cached ones.
+    pub fn insert(&mut self, link: Link, msgs: Vec<Msg>) {
+        if self.capacity == 0 || msgs.is_empty() {
+            return;
+        }
+        let tick = self.next_tick();
+        if let Some((used, _)) = self.entries.insert(link.clone(), (tick, msgs)) {
+            self.usage.remove(&used);
+        }
+        self.usage.insert(tick, link);
+        self.evict();
+    }
+
+    /// Cache a message sent to `link` along with the messages already cached for it.
+    pub fn push(&mut self, link: Link, msg: Msg) {
+        match self.touch(&link) {
+            Some(msgs) => msgs.push(msg),
+            None => self.insert(link, vec![msg]),
+        }
+    }
+
+    /// Iterate over cached messages, least recently used first.
+    pub fn messages(&self) -> impl Iterator<Item = &Msg> {
+        let entries = &self.entries;
+        self.usage
+            .values()
+            .filter_map(move |link| entries.get(link))
+            .flat_map(|(_, msgs)| msgs.iter())
+    }
+
+    pub fn clear(&mut self) {
+        self.entries.clear();
+        self.usage.clear();
+    }
+
+    fn touch(&mut self, link: &Link) -> Option<&mut Vec<Msg>> {
+        let tick = self.next_tick();
+        let (used, msgs) = self.entries.get_mut(link)?;
+        self.usage.remove(used);
+        self.usage.insert(tick, link.clone());
+        *used = tick;
+        Some(msgs)
+    }
+
+    fn next_tick(&mut self) -> u64 {
+        self.tick += 1;
+        self.tick
+    }
+
+    fn evict(&mut self) {
+        while self.entries.len() > self.capacity {
+            let oldest = match self.usage.keys().next() {
+                Some(used) => *used,
+                None => break,
+            };
+            if let Some(link) = self.usage.remove(&oldest) {
+                self.entries.remove(&link);
+            }
+        }
+    }
+}
+
+/// Message that can be stored in a cache backing file.
+pub trait CacheRecord: Sized {
+    /// Append encoded message to `buf`.
+    fn encode_record(&self, buf: &mut Vec<u8>);
+
+    /// Decode a message from the front of `bytes`, returns the message and the number of bytes consumed.
+    fn decode_record(bytes: &[u8]) -> Result<(Self, usize)>;
+}
+
+#[cfg(feature = "tangle")]
+impl<F> CacheRecord for tangle::TangleMessage<F> {
+    fn encode_record(&self, buf: &mut Vec<u8>) {
+        use crate::message::HasLink as _;
+        buf.extend_from_slice(&self.binary.link.to_bytes());
+        buf.extend_from_slice(&self.binary.prev_link.to_bytes());
+        buf.extend_from_slice(&self.timestamp.to_be_bytes());
+        buf.extend_from_slice(&(self.binary.body.bytes.len() as u64).to_be_bytes());
+        buf.extend_from_slice(&self.binary.body.bytes);
+    }
+
+    fn decode_record(bytes: &[u8]) -> Result<(Self, usize)> {
+        use crate::message::{
+            BinaryMessage,
+            HasLink as _,
+        };
+        use core::convert::TryInto as _;
+        use tangle::{
+            TangleAddress,
+            APPINST_SIZE,
+            MSGID_SIZE,
+        };
+
+        const LINK_SIZE: usize = APPINST_SIZE + MSGID_SIZE;
+        const HEADER_SIZE: usize = 2 * LINK_SIZE + 16;
+        try_or!(bytes.len() >= HEADER_SIZE, BadCacheFile)?;
+        let link = TangleAddress::from_bytes(&bytes[..LINK_SIZE]);
+        let prev_link = TangleAddress::from_bytes(&bytes[LINK_SIZE..2 * LINK_SIZE]);
+        let timestamp = u64::from_be_bytes(bytes[2 * LINK_SIZE..2 * LINK_SIZE + 8].try_into().unwrap());
+        let body_len = u64::from_be_bytes(bytes[2 * LINK_SIZE + 8..HEADER_SIZE].try_into().unwrap()) as usize;
+        try_or!(bytes.len() - HEADER_SIZE >= body_len, BadCacheFile)?;
+        let body = bytes[HEADER_SIZE..HEADER_SIZE + body_len].to_vec();
+        let msg = BinaryMessage::new(link, prev_link, body.into());
+        Ok((Self::with_timestamp(msg, timestamp), HEADER_SIZE + body_len))
+    }
+}
+
+/// Links being retrieved in the background.
+struct InFlight<Link> {
+    links: Mutex<HashSet<Link>>,
+    done: Condvar,
+}
+
+/// Links of a background retrieval. They are no longer in flight once the guard is dropped, whether
+/// the retrieval completed or was abandoned.
+#[cfg(not(feature = "async"))]
+struct InFlightGuard<Link: Eq + hash::Hash> {
+    in_flight: Arc<InFlight<Link>>,
+    links: Vec<Link>,
+}
+
+#[cfg(not(feature = "async"))]
+impl<Link: Eq + hash::Hash> Drop for InFlightGuard<Link> {
+    fn drop(&mut self) {
+        let mut links = self.in_flight.links.lock().unwrap_or_else(|err| err.into_inner());
+        for link in &self.links {
+            links.remove(link);
+        }
+        self.in_flight.done.notify_all();
+    }
+}
+
+/// Transport wrapper serving repeated reads from a message cache shared by all of its clones.
+///
+/// Sent messages are written through to the inner transport and cached on success.
+pub struct CachedTransport<Link, Msg, Tsp> {
+    transport: Tsp,
+    cache: Arc<Mutex<MessageCache<Link, Msg>>>,
+    backing_file: Option<String>,
+    in_flight: Arc<InFlight<Link>>,
+}
+
+impl<Link, Msg, Tsp> CachedTransport<Link, Msg, Tsp>
+where
+    Link: Eq + hash::Hash + Clone,
+    Msg: Clone,
+{
+    /// Wrap `transport` with a cache keeping messages of at most `capacity` links.
+    pub fn new(transport: Tsp, capacity: usize) -> Self {
+        Self {
+            transport,
+            cache: Arc::new(Mutex::new(MessageCache::new(capacity))),
+            backing_file: None,
+            in_flight: Arc::new(InFlight {
+                links: Mutex::new(HashSet::new()),
+                done: Condvar::new(),
+            }),
+        }
+    }
+
+    pub fn transport(&self) -> &Tsp {
+        &self.transport
+    }
+
+    pub fn transport_mut(&mut self) -> &mut Tsp {
+        &mut self.transport
+    }
+
+    pub fn into_transport(self) -> Tsp {
+        self.transport
+    }
+
+    pub fn capacity(&self) -> usize {
+        self.lock_cache().capacity()
+    }
+
+    /// Replace the cache with an empty one of the given capacity and drop the backing file.
+    /// Clones made before the call keep sharing the previous cache.
+    pub fn reset_cache(&mut self, capacity: usize) {
+        self.cache = Arc::new(Mutex::new(MessageCache::new(capacity)));
+        self.backing_file = None;
+    }
+
+    fn lock_cache(&self) -> MutexGuard<'_, MessageCache<Link, Msg>> {
+        self.cache.lock().unwrap_or_else(|err| err.into_inner())
+    }
+
+    fn cache_sent(&self, msgs: impl IntoIterator<Item = Msg>)
+    where
+        Msg: LinkedMessage<Link>,
+    {
+        let mut cache = self.lock_cache();
+        for msg in msgs {
+            cache.push(msg.link().clone(), msg);
+        }
+    }
+
+    fn cache_received(&self, link: &Link, msgs: &[Msg]) {
+        let mut cache = self.lock_cache();
+        if cache.capacity() > 0 {
+            cache.insert(link.clone(), msgs.to_vec());
+        }
+    }
+
+    fn is_caching(&self) -> bool {
+        self.capacity() > 0
+    }
+
+    /// Wait until none of `links` is being prefetched, returns whether any was.
+    #[cfg(not(feature = "async"))]
+    fn wait_in_flight(&self, links: &[Link]) -> bool {
+        let mut in_flight = self.in_flight.links.lock().unwrap_or_else(|err| err.into_inner());
+        let mut waited = false;
+        while links.iter().any(|link| in_flight.contains(link)) {
+            waited = true;
+            in_flight = self
+                .in_flight
+                .done
+                .wait(in_flight)
+                .unwrap_or_else(|err| err.into_inner());
+        }
+        waited
+    }
+
+    /// Look up cached messages for each of `links`, `None` marks a cache miss.
+    fn cached_batch(&self, links: &[Link]) -> Vec<Option<Result<Msg>>>
+    where
+        Link: Display,
+    {
+        let mut cache = self.lock_cache();
+        links
+            .iter()
+            .map(|link| {
+                cache.get(link).map(|mut msgs| match msgs.pop() {
+                    Some(msg) if msgs.is_empty() => Ok(msg),
+                    Some(_) => err!(MessageNotUnique(link.to_string())),
+                    None => err!(MessageLinkNotFound(link.to_string())),
+                })
+            })
+            .collect()
+    }
+
+    /// Fill cache misses in `hits` with `fetched` results for the `missing` links, in order.
+    fn merge_batch(
+        &self,
+        mut hits: Vec<Option<Result<Msg>>>,
+        missing: Vec<Link>,
+        fetched: Vec<Result<Msg>>,
+    ) -> Vec<Result<Msg>>
+    where
+        Link: Display,
+    {
+        let mut cache = self.lock_cache();
+        let mut fetched = missing.into_iter().zip(fetched);
+        for hit in hits.iter_mut().filter(|hit| hit.is_none()) {
+            if let Some((link, result)) = fetched.next() {
+                if cache.capacity() > 0 {
+                    if let Ok(msg) = &result {
+                        cache.insert(link, vec![msg.clone()]);
+                    }
+                }
+                *hit = Some(result);
+            }
+        }
+        hits.into_iter()
+            .map(|hit| hit.unwrap_or_else(|| err!(MessageLinkNotFound(String::new()))))
+            .collect()
+    }
+}
+
+fn missing_links<Link: Clone, Msg>(links: &[Link], hits: &[Option<Result<Msg>>]) -> Vec<Link> {
+    links
+        .iter()
+        .zip(hits)
+        .filter(|(_, hit)| hit.is_none())
+        .map(|(link, _)| link.clone())
+        .collect()
+}
+
+impl<Link, Msg, Tsp> CachedTransport<Link, Msg, Tsp>
+where
+    Link: Eq + hash::Hash + Clone,
+    Msg: LinkedMessage<Link> + CacheRecord + Clone,
+{
+    /// Load messages saved in `path` into the cache and use `path` as the backing file on `flush`.
+    /// A missing file is not an error and leaves the cache empty, a record cut short at the end of
+    /// the file (eg. by a crash during an older, non-atomic save) is dropped along with the rest.
+    pub fn load(&mut self, path: &str) -> Result<()> {
+        self.backing_file = Some(path.into());
+        let bytes = match std::fs::read(path) {
+            Ok(bytes) => bytes,
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => return Ok(()),
+            Err(e) => return Err(wrapped_err!(CacheFileFailure(path.into()), WrappedError(e))),
+        };
+
+        let mut msgs = Vec::new();
+        let mut rest = &bytes[..];
+        while !rest.is_empty() {
+            match Msg::decode_record(rest) {
+                Ok((msg, n)) => {
+                    msgs.push(msg);
+                    rest = &rest[n..];
+                }
+                Err(_) => break,
+            }
+        }
+        self.cache_sent(msgs);
+        Ok(())
+    }
+
+    /// Save cached messages into the backing file, does nothing if no file was loaded.
+    pub fn flush(&self) -> Result<()> {
+        if let Some(path) = &self.backing_file {
+            let mut bytes = Vec::new();
+            for msg in self.lock_cache().messages() {
+                msg.encode_record(&mut bytes);
+            }
+            // The new file replaces the old one only once it is complete.
+            let tmp_path = path.clone() + ".tmp";
+            std::fs::write(&tmp_path, bytes)
+                .map_err(|e| wrapped_err!(CacheFileFailure(tmp_path.clone()), WrappedError(e)))?;
+            std::fs::rename(&tmp_path, path)
+                .map_err(|e| wrapped_err!(CacheFileFailure(path.clone()), WrappedError(e)))?;
+        }
+        Ok(())
+    }
+}
+
+impl<Link, Msg, Tsp: Clone> Clone for CachedTransport<Link, Msg, Tsp> {
+    fn clone(&self) -> Self {
+        Self {
+            transport: self.transport.clone(),
+            cache: self.cache.clone(),
+            backing_file: self.backing_file.clone(),
+            in_flight: self.in_flight.clone(),
+        }
+    }
+}
+
+impl<Link, Msg, Tsp> Default for CachedTransport<Link, Msg, Tsp>
+where
+    Link: Eq + hash::Hash + Clone,
+    Msg: Clone,
+    Tsp: Default,
+{
+    /// Default transport with caching disabled.
+    fn default() -> Self {
+        Self::new(Tsp::default(), 0)
+    }
+}
+
+impl<Link, Msg, Tsp: TransportOptions> TransportOptions for CachedTransport<Link, Msg, Tsp> {
+    type SendOptions = <Tsp as TransportOptions>::SendOptions;
+    fn get_send_options(&self) -> Self::SendOptions {
+        self.transport.get_send_options()
+    }
+    fn set_send_options(&mut self, opt: Self::SendOptions) {
+        self.transport.set_send_options(opt)
+    }
+
+    type RecvOptions = <Tsp as TransportOptions>::RecvOptions;
+    fn get_recv_options(&self) -> Self::RecvOptions {
+        self.transport.get_recv_options()
+    }
+    fn set_recv_options(&mut self, opt: Self::RecvOptions) {
+        self.transport.set_recv_options(opt)
+    }
+}
+
+#[cfg(not(feature = "async"))]
+impl<Link, Msg, Tsp: TransportDetails<Link>> TransportDetails<Link> for CachedTransport<Link, Msg, Tsp> {
+    type Details = <Tsp as TransportDetails<Link>>::Details;
+    fn get_link_details(&mut self, link: &Link) -> Result<Self::Details> {
+        self.transport.get_link_details(link)
+    }
+}
+
+#[cfg(not(feature = "async"))]
+impl<Link, Msg, Tsp> Transport<Link, Msg> for CachedTransport<Link, Msg, Tsp>
+where
+    Link: 'static + Eq + hash::Hash + Clone + Debug + Display + Send + Sync,
+    Msg: 'static + LinkedMessage<Link> + Clone + Send,
+    Tsp: Transport<Link, Msg>,
+{
+    fn send_message(&mut self, msg: &Msg) -> Result<()> {
+        self.transport.send_message(msg)?;
+        if self.is_caching() {
+            self.cache_sent(Some(msg.clone()));
+        }
+        Ok(())
+    }
+
+    fn send_owned_message(&mut self, msg: Msg) -> Result<()> {
+        if self.is_caching() {
+            let copy = msg.clone();
+            self.transport.send_owned_message(msg)?;
+            self.cache_sent(Some(copy));
+            Ok(())
+        } else {
+            self.transport.send_owned_message(msg)
+        }
+    }
+
+    fn send_messages(&mut self, msgs: Vec<Msg>) -> Result<()> {
+        if self.is_caching() {
+            let copies = msgs.clone();
+            self.transport.send_messages(msgs)?;
+            self.cache_sent(copies);
+            Ok(())
+        } else {
+            self.transport.send_messages(msgs)
+        }
+    }
+
+    fn recv_messages(&mut self, link: &Link) -> Result<Vec<Msg>> {
+        if let Some(msgs) = self.lock_cache().get(link) {
+            metrics_add!(CacheHit, 1);
+            return Ok(msgs);
+        }
+        if self.wait_in_flight(core::slice::from_ref(link)) {
+            if let Some(msgs) = self.lock_cache().get(link) {
+                metrics_add!(CacheHit, 1);
+                return Ok(msgs);
+            }
+        }
+        metrics_add!(CacheMiss, 1);
+        let msgs = self.transport.recv_messages(link)?;
+        self.cache_received(link, &msgs);
+        Ok(msgs)
+    }
+
+    fn recv_message_batch(&mut self, links: &[Link]) -> Vec<Result<Msg>> {
+        let mut hits = self.cached_batch(links);
+        let mut missing = missing_links(links, &hits);
+        if !missing.is_empty() && self.wait_in_flight(&missing) {
+            hits = self.cached_batch(links);
+            missing = missing_links(links, &hits);
+        }
+        metrics_add!(CacheHit, links.len() - missing.len());
+        metrics_add!(CacheMiss, missing.len());
+        if missing.is_empty() {
+            return self.merge_batch(hits, missing, Vec::new());
+        }
+        let fetched = self.transport.recv_message_batch(&missing);
+        self.merge_batch(hits, missing, fetched)
+    }
+
+    fn spawn_recv_message_batch(&mut self, links: Vec<Link>, done: BatchCallback<Msg>) -> bool {
+        self.transport.spawn_recv_message_batch(links, done)
+    }
+
+    /// Retrieve the messages at `links` that are neither cached nor already being prefetched in the
+    /// background, and cache them. Links without a message are not remembered, they are retrieved
+    /// again by the next read.
+    fn prefetch(&mut self, links: &[Link]) {
+        if !self.is_caching() {
+            return;
+        }
+        let missing: Vec<Link> = {
+            let cache = self.lock_cache();
+            let mut in_flight = self.in_flight.links.lock().unwrap_or_else(|err| err.into_inner());
+            links
+                .iter()
+                .filter(|link| !cache.contains(link) && in_flight.insert((*link).clone()))
+                .cloned()
+                .collect()
+        };
+        if missing.is_empty() {
+            return;
+        }
+
+        let cache = self.cache.clone();
+        let guard = InFlightGuard {
+            in_flight: self.in_flight.clone(),
+            links: missing.clone(),
+        };
+        let done: BatchCallback<Msg> = Box::new(move |fetched| {
+            let mut cache = cache.lock().unwrap_or_else(|err| err.into_inner());
+            for (link, result) in guard.links.iter().zip(fetched) {
+                if let Ok(msg) = result {
+                    cache.insert(link.clone(), vec![msg]);
+                }
+            }
+            // Release the cache before waking up readers waiting for these links
+            drop(cache);
+            drop(guard);
+        });
+        // Links are released by the guard even if the retrieval could not be started
+        self.transport.spawn_recv_message_batch(missing, done);
+    }
+}
+
+#[cfg(feature = "async")]
+#[async_trait(?Send)]
+impl<Link, Msg, Tsp> TransportDetails<Link> for CachedTransport<Link, Msg, Tsp>
+where
+    Link: Send + Sync,
+    Tsp: TransportDetails<Link>,
+{
+    type Details = <Tsp as TransportDetails<Link>>::Details;
+    async fn get_link_details(&mut self, link: &Link) -> Result<Self::Details> {
+        self.transport.get_link_details(link).await
+    }
+}
+
+#[cfg(feature = "async")]
+#[async_trait(?Send)]
+impl<Link, Msg, Tsp> Transport<Link, Msg> for CachedTransport<Link, Msg, Tsp>
+where
+    Link: 'static + Eq + hash::Hash + Clone + Send + Sync + Display,
+    Msg: 'static + LinkedMessage<Link> + Clone + Send + Sync,
+    Tsp: Transport<Link, Msg>,
+{
+    async fn send_message(&mut self, msg: &Msg) -> Result<()> {
+        self.transport.send_message(msg).await?;
+        if self.is_caching() {
+            self.cache_sent(Some(msg.clone()));
+        }
+        Ok(())
+    }
+
+    async fn send_owned_message(&mut self, msg: Msg) -> Result<()> {
+        if self.is_caching() {
+            let copy = msg.clone();
+            self.transport.send_owned_message(msg).await?;
+            self.cache_sent(Some(copy));
+            Ok(())
+        } else {
+            self.transport.send_owned_message(msg).await
+        }
+    }
+
+    async fn send_messages(&mut self, msgs: Vec<Msg>) -> Result<()> {
+        if self.is_caching() {
+            let copies = msgs.clone();
+            self.transport.send_messages(msgs).await?;
+            self.cache_sent(copies);
+            Ok(())
+        } else {
+            self.transport.send_messages(msgs).await
+        }
+    }
+
+    async fn recv_messages(&mut self, link: &Link) -> Result<Vec<Msg>> {
+        if let Some(msgs) = self.lock_cache().get(link) {
+            metrics_add!(CacheHit, 1);
+            return Ok(msgs);
+        }
+        metrics_add!(CacheMiss, 1);
+        let msgs = self.transport.recv_messages(link).await?;
+        self.cache_received(link, &msgs);
+        Ok(msgs)
+    }
+
+    async fn recv_message(&mut self, link: &Link) -> Result<Msg> {
+        let mut msgs = self.recv_messages(link).await?;
+        if let Some(msg) = msgs.pop() {
+            try_or!(msgs.is_empty(), MessageNotUnique(link.to_string()))?;
+            Ok(msg)
+        } else {
+            err!(MessageLinkNotFound(link.to_string()))
+        }
+    }
+
+    async fn recv_message_batch(&mut self, links: &[Link]) -> Vec<Result<Msg>> {
+        let hits = self.cached_batch(links);
+        let missing = missing_links(links, &hits);
+        metrics_add!(CacheHit, links.len() - missing.len());
+        metrics_add!(CacheMiss, missing.len());
+        if missing.is_empty() {
+            return self.merge_batch(hits, missing, Vec::new());
+        }
+        let fetched = self.transport.recv_message_batch(&missing).await;
+        self.merge_batch(hits, missing, fetched)
+    }
+}
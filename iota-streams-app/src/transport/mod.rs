@@ -16,15 +16,31 @@ use iota_streams_core::prelude::{
     Arc,
     Box,
 };
+#[cfg(all(feature = "std", not(feature = "async")))]
+use iota_streams_core::prelude::{
+    sync::{
+        Mutex,
+        MutexGuard,
+    },
+    Arc,
+};
 
 #[cfg(not(feature = "async"))]
-use iota_streams_core::prelude::ToString;
+use iota_streams_core::prelude::{
+    Box,
+    ToString,
+};
 
 use iota_streams_core::prelude::{
     Rc,
     Vec,
 };
 
+/// Completion of a batch of messages retrieved in the background, called with the results in the
+/// order of the links.
+#[cfg(not(feature = "async"))]
+pub type BatchCallback<Msg> = Box<dyn FnOnce(Vec<Result<Msg>>) + Send>;
+
 #[cfg(not(feature = "async"))]
 pub trait TransportDetails<Link> {
     type Details;
@@ -59,6 +75,21 @@ pub trait Transport<Link: Debug + Display, Msg>: TransportOptions + TransportDet
     /// Send a message with default options.
     fn send_message(&mut self, msg: &Msg) -> Result<()>;
 
+    /// Send a message with default options, handing its ownership over to the transport.
+    /// Transports that keep or forward the message body should override the default to avoid a copy.
+    fn send_owned_message(&mut self, msg: Msg) -> Result<()> {
+        self.send_message(&msg)
+    }
+
+    /// Send a batch of messages with default options.
+    /// Transports able to submit several messages at once should override the sequential default.
+    fn send_messages(&mut self, msgs: Vec<Msg>) -> Result<()> {
+        for msg in msgs {
+            self.send_owned_message(msg)?;
+        }
+        Ok(())
+    }
+
     /// Receive messages with default options.
     fn recv_messages(&mut self, link: &Link) -> Result<Vec<Msg>>;
 
@@ -72,6 +103,23 @@ pub trait Transport<Link: Debug + Display, Msg>: TransportOptions + TransportDet
             err!(MessageLinkNotFound(link.to_string()))
         }
     }
+
+    /// Receive a message for each of the links with default options, results are in the order of `links`.
+    /// Transports able to retrieve several messages at once should override the sequential default.
+    fn recv_message_batch(&mut self, links: &[Link]) -> Vec<Result<Msg>> {
+        links.iter().map(|link| self.recv_message(link)).collect()
+    }
+
+    /// Receive a message for each of the links in the background and hand the results to `done`,
+    /// returns whether the retrieval was started. Transports unable to run requests in the
+    /// background drop `done` without calling it.
+    fn spawn_recv_message_batch(&mut self, _links: Vec<Link>, _done: BatchCallback<Msg>) -> bool {
+        false
+    }
+
+    /// Hint that the messages at `links` are likely to be received soon. Transports keeping
+    /// messages around may retrieve them ahead of time, by default nothing is done.
+    fn prefetch(&mut self, _links: &[Link]) {}
 }
 
 #[cfg(feature = "async")]
@@ -84,11 +132,45 @@ where
     /// Send a message with default options.
     async fn send_message(&mut self, msg: &Msg) -> Result<()>;
 
+    /// Send a message with default options, handing its ownership over to the transport.
+    /// Transports that keep or forward the message body should override the default to avoid a copy.
+    async fn send_owned_message(&mut self, msg: Msg) -> Result<()>
+    where
+        Msg: 'async_trait,
+    {
+        self.send_message(&msg).await
+    }
+
+    /// Send a batch of messages with default options.
+    /// Transports able to submit several messages at once should override the sequential default.
+    async fn send_messages(&mut self, msgs: Vec<Msg>) -> Result<()>
+    where
+        Msg: 'async_trait,
+    {
+        for msg in msgs {
+            self.send_owned_message(msg).await?;
+        }
+        Ok(())
+    }
+
     /// Receive messages with default options.
     async fn recv_messages(&mut self, link: &Link) -> Result<Vec<Msg>>;
 
     /// Receive a message with default options.
     async fn recv_message(&mut self, link: &Link) -> Result<Msg>;
+
+    /// Receive a message for each of the links with default options, results are in the order of `links`.
+    /// Transports able to retrieve several messages at once should override the sequential default.
+    async fn recv_message_batch(&mut self, links: &[Link]) -> Vec<Result<Msg>>
+    where
+        Msg: 'async_trait,
+    {
+        let mut msgs = Vec::with_capacity(links.len());
+        for link in links {
+            msgs.push(self.recv_message(link).await);
+        }
+        msgs
+    }
     // For some reason compiler requires (Msg: `async_trait) lifetime bound for this default implementation.
     // {
     // let mut msgs = self.recv_messages(link).await?;
@@ -137,6 +219,22 @@ impl<Link: Debug + Display, Msg, Tsp: Transport<Link, Msg>> Transport<Link, Msg>
         }
     }
 
+    /// Send a message, handing its ownership over to the transport.
+    fn send_owned_message(&mut self, msg: Msg) -> Result<()> {
+        match (&*self).try_borrow_mut() {
+            Ok(mut tsp) => tsp.send_owned_message(msg),
+            Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
+        }
+    }
+
+    /// Send a batch of messages.
+    fn send_messages(&mut self, msgs: Vec<Msg>) -> Result<()> {
+        match (&*self).try_borrow_mut() {
+            Ok(mut tsp) => tsp.send_messages(msgs),
+            Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
+        }
+    }
+
     /// Receive messages with default options.
     fn recv_messages(&mut self, link: &Link) -> Result<Vec<Msg>> {
         match (&*self).try_borrow_mut() {
@@ -152,6 +250,29 @@ impl<Link: Debug + Display, Msg, Tsp: Transport<Link, Msg>> Transport<Link, Msg>
             Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
         }
     }
+
+    /// Receive a message for each of the links with default options.
+    fn recv_message_batch(&mut self, links: &[Link]) -> Vec<Result<Msg>> {
+        match (&*self).try_borrow_mut() {
+            Ok(mut tsp) => tsp.recv_message_batch(links),
+            Err(_err) => links.iter().map(|_| err!(TransportNotAvailable)).collect(),
+        }
+    }
+
+    /// Receive a message for each of the links in the background.
+    fn spawn_recv_message_batch(&mut self, links: Vec<Link>, done: BatchCallback<Msg>) -> bool {
+        match (&*self).try_borrow_mut() {
+            Ok(mut tsp) => tsp.spawn_recv_message_batch(links, done),
+            Err(_err) => false,
+        }
+    }
+
+    /// Hint that the messages at `links` are likely to be received soon.
+    fn prefetch(&mut self, links: &[Link]) {
+        if let Ok(mut tsp) = (&*self).try_borrow_mut() {
+            tsp.prefetch(links)
+        }
+    }
 }
 
 #[cfg(not(feature = "async"))]
@@ -162,6 +283,118 @@ pub fn new_shared_transport<T>(tsp: T) -> Rc<RefCell<T>> {
     Rc::new(RefCell::new(tsp))
 }
 
+#[cfg(all(feature = "std", not(feature = "async")))]
+impl<Tsp: TransportOptions> TransportOptions for Arc<Mutex<Tsp>> {
+    type SendOptions = <Tsp as TransportOptions>::SendOptions;
+    fn get_send_options(&self) -> Self::SendOptions {
+        lock_transport(self).get_send_options()
+    }
+    fn set_send_options(&mut self, opt: Self::SendOptions) {
+        lock_transport(self).set_send_options(opt)
+    }
+
+    type RecvOptions = <Tsp as TransportOptions>::RecvOptions;
+    fn get_recv_options(&self) -> Self::RecvOptions {
+        lock_transport(self).get_recv_options()
+    }
+    fn set_recv_options(&mut self, opt: Self::RecvOptions) {
+        lock_transport(self).set_recv_options(opt)
+    }
+}
+
+#[cfg(all(feature = "std", not(feature = "async")))]
+impl<Tsp: TransportDetails<Link>, Link> TransportDetails<Link> for Arc<Mutex<Tsp>> {
+    type Details = <Tsp as TransportDetails<Link>>::Details;
+    fn get_link_details(&mut self, link: &Link) -> Result<Self::Details> {
+        match self.lock() {
+            Ok(mut tsp) => tsp.get_link_details(link),
+            Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
+        }
+    }
+}
+
+/// Transport shared between threads, concurrent users are serialized on the lock.
+#[cfg(all(feature = "std", not(feature = "async")))]
+impl<Link: Debug + Display, Msg, Tsp: Transport<Link, Msg>> Transport<Link, Msg> for Arc<Mutex<Tsp>> {
+    /// Send a message.
+    fn send_message(&mut self, msg: &Msg) -> Result<()> {
+        match self.lock() {
+            Ok(mut tsp) => tsp.send_message(msg),
+            Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
+        }
+    }
+
+    /// Send a message, handing its ownership over to the transport.
+    fn send_owned_message(&mut self, msg: Msg) -> Result<()> {
+        match self.lock() {
+            Ok(mut tsp) => tsp.send_owned_message(msg),
+            Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
+        }
+    }
+
+    /// Send a batch of messages.
+    fn send_messages(&mut self, msgs: Vec<Msg>) -> Result<()> {
+        match self.lock() {
+            Ok(mut tsp) => tsp.send_messages(msgs),
+            Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
+        }
+    }
+
+    /// Receive messages with default options.
+    fn recv_messages(&mut self, link: &Link) -> Result<Vec<Msg>> {
+        match self.lock() {
+            Ok(mut tsp) => tsp.recv_messages(link),
+            Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
+        }
+    }
+
+    /// Receive a message with default options.
+    fn recv_message(&mut self, link: &Link) -> Result<Msg> {
+        match self.lock() {
+            Ok(mut tsp) => tsp.recv_message(link),
+            Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
+        }
+    }
+
+    /// Receive a message for each of the links with default options.
+    fn recv_message_batch(&mut self, links: &[Link]) -> Vec<Result<Msg>> {
+        match self.lock() {
+            Ok(mut tsp) => tsp.recv_message_batch(links),
+            Err(_err) => links.iter().map(|_| err!(TransportNotAvailable)).collect(),
+        }
+    }
+
+    /// Receive a message for each of the links in the background.
+    fn spawn_recv_message_batch(&mut self, links: Vec<Link>, done: BatchCallback<Msg>) -> bool {
+        match self.lock() {
+            Ok(mut tsp) => tsp.spawn_recv_message_batch(links, done),
+            Err(_err) => false,
+        }
+    }
+
+    /// Hint that the messages at `links` are likely to be received soon.
+    fn prefetch(&mut self, links: &[Link]) {
+        if let Ok(mut tsp) = self.lock() {
+            tsp.prefetch(links)
+        }
+    }
+}
+
+/// Options are plain values, so a transport poisoned by a panicking user is still usable for them.
+#[cfg(all(feature = "std", not(feature = "async")))]
+fn lock_transport<Tsp>(tsp: &Mutex<Tsp>) -> MutexGuard<'_, Tsp> {
+    tsp.lock().unwrap_or_else(|err| err.into_inner())
+}
+
+/// Transport that can be shared between threads, eg. by users living on different threads.
+#[cfg(all(feature = "std", not(feature = "async")))]
+pub type ThreadSafeTransport<T> = Arc<Mutex<T>>;
+
+#[cfg(all(feature = "std", not(feature = "async")))]
+pub fn new_thread_safe_transport<T>(tsp: T) -> Arc<Mutex<T>> {
+    Arc::new(Mutex::new(tsp))
+}
+
 #[cfg(feature = "async")]
 impl<Tsp: TransportOptions> TransportOptions for Arc<AtomicRefCell<Tsp>> {
     type SendOptions = <Tsp as TransportOptions>::SendOptions;
@@ -216,6 +449,20 @@ pub fn new_shared_transport<T>(tsp: T) -> Arc<AtomicRefCell<T>> {
 mod bucket;
 pub use bucket::BucketTransport;
 
+#[cfg(feature = "std")]
+mod cached;
+#[cfg(feature = "std")]
+pub use cached::{
+    CacheRecord,
+    CachedTransport,
+    MessageCache,
+};
+
+#[cfg(feature = "std")]
+mod sharded;
+#[cfg(feature = "std")]
+pub use sharded::ShardedBucketTransport;
+
 #[cfg(not(feature = "async"))]
 use core::fmt::{
     Debug,
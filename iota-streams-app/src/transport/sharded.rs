@@ -0,0 +1,281 @@
+//! In-memory transport that can be shared between threads without a global lock.
+//!
+//! Links are spread over a fixed number of shards by their hash, each shard behind its own read-write lock, so that
+//! users on different threads only contend when they touch the same shard, and readers of a shard never block each
+//! other. Messages are kept refcounted: `recv_shared` hands them out without copying, reads through `Transport` copy
+//! only the messages returned. The transport can be bounded by the number of links it keeps, in which case each shard
+//! evicts its oldest link first.
+
+use super::*;
+use crate::message::LinkedMessage;
+use core::hash::{
+    self,
+    Hasher,
+};
+use std::collections::hash_map::DefaultHasher;
+
+use iota_streams_core::{
+    err,
+    prelude::{
+        string::ToString,
+        sync::{
+            RwLock,
+            RwLockReadGuard,
+            RwLockWriteGuard,
+        },
+        Arc,
+        HashMap,
+        VecDeque,
+    },
+    Errors::{
+        MessageLinkNotFound,
+        MessageNotUnique,
+    },
+};
+
+const DEFAULT_SHARDS: usize = 16;
+
+struct Shard<Link, Msg> {
+    entries: HashMap<Link, Vec<Arc<Msg>>>,
+    /// Links in order of insertion, only kept when the shard is bounded
+    order: VecDeque<Link>,
+}
+
+pub struct ShardedBucketTransport<Link, Msg> {
+    shards: Arc<Vec<RwLock<Shard<Link, Msg>>>>,
+    /// Maximum number of links kept per shard, 0 if unbounded
+    shard_capacity: usize,
+}
+
+impl<Link, Msg> Clone for ShardedBucketTransport<Link, Msg> {
+    /// Clones share the messages of the transport.
+    fn clone(&self) -> Self {
+        Self {
+            shards: self.shards.clone(),
+            shard_capacity: self.shard_capacity,
+        }
+    }
+}
+
+impl<Link, Msg> Default for ShardedBucketTransport<Link, Msg>
+where
+    Link: Eq + hash::Hash,
+{
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl<Link, Msg> ShardedBucketTransport<Link, Msg>
+where
+    Link: Eq + hash::Hash,
+{
+    pub fn new() -> Self {
+        Self::with_shards(DEFAULT_SHARDS)
+    }
+
+    /// Unbounded transport spread over `shards` shards, at least one.
+    pub fn with_shards(shards: usize) -> Self {
+        Self::with_capacity(shards, 0)
+    }
+
+    /// Transport spread over `shards` shards keeping about `max_links` links, 0 for no limit. The limit is split
+    /// evenly between the shards, each shard keeping at least one link.
+    pub fn with_capacity(shards: usize, max_links: usize) -> Self {
+        let shards = shards.max(1);
+        let shard_capacity = if max_links == 0 { 0 } else { (max_links / shards).max(1) };
+        Self {
+            shards: Arc::new(
+                (0..shards)
+                    .map(|_| {
+                        RwLock::new(Shard {
+                            entries: HashMap::new(),
+                            order: VecDeque::new(),
+                        })
+                    })
+                    .collect(),
+            ),
+            shard_capacity,
+        }
+    }
+
+    fn shard(&self, link: &Link) -> &RwLock<Shard<Link, Msg>> {
+        let mut hasher = DefaultHasher::new();
+        link.hash(&mut hasher);
+        &self.shards[hasher.finish() as usize % self.shards.len()]
+    }
+
+    // A shard is only modified by inserting complete messages, so one poisoned by a panicking user is still consistent.
+    fn read(&self, link: &Link) -> RwLockReadGuard<'_, Shard<Link, Msg>> {
+        self.shard(link).read().unwrap_or_else(|err| err.into_inner())
+    }
+
+    fn write(&self, link: &Link) -> RwLockWriteGuard<'_, Shard<Link, Msg>> {
+        self.shard(link).write().unwrap_or_else(|err| err.into_inner())
+    }
+
+    /// Number of links with messages.
+    pub fn len(&self) -> usize {
+        self.shards
+            .iter()
+            .map(|shard| shard.read().unwrap_or_else(|err| err.into_inner()).entries.len())
+            .sum()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+}
+
+impl<Link, Msg> ShardedBucketTransport<Link, Msg>
+where
+    Link: Eq + hash::Hash + Clone + core::fmt::Display,
+    Msg: LinkedMessage<Link>,
+{
+    /// Store a message, evicting the oldest link of its shard if the shard is full.
+    pub fn insert(&self, msg: Msg) {
+        let link = msg.link().clone();
+        let mut shard = self.write(&link);
+        if let Some(msgs) = shard.entries.get_mut(&link) {
+            msgs.push(Arc::new(msg));
+            return;
+        }
+        if self.shard_capacity != 0 {
+            while shard.entries.len() >= self.shard_capacity {
+                match shard.order.pop_front() {
+                    Some(oldest) => {
+                        shard.entries.remove(&oldest);
+                    }
+                    None => break,
+                }
+            }
+            shard.order.push_back(link.clone());
+        }
+        shard.entries.insert(link, vec![Arc::new(msg)]);
+    }
+
+    /// Messages at `link`, shared with the transport rather than copied.
+    pub fn recv_shared(&self, link: &Link) -> Result<Vec<Arc<Msg>>> {
+        match self.read(link).entries.get(link) {
+            Some(msgs) => Ok(msgs.clone()),
+            None => err!(MessageLinkNotFound(link.to_string())),
+        }
+    }
+
+    /// Unique message at `link`, shared with the transport rather than copied.
+    pub fn recv_shared_message(&self, link: &Link) -> Result<Arc<Msg>> {
+        match self.read(link).entries.get(link).map(Vec::as_slice) {
+            Some([msg]) => Ok(msg.clone()),
+            Some([_, _, ..]) => err!(MessageNotUnique(link.to_string())),
+            _ => err!(MessageLinkNotFound(link.to_string())),
+        }
+    }
+}
+
+impl<Link, Msg> TransportOptions for ShardedBucketTransport<Link, Msg> {
+    type SendOptions = ();
+    fn get_send_options(&self) {}
+    fn set_send_options(&mut self, _opt: ()) {}
+
+    type RecvOptions = ();
+    fn get_recv_options(&self) {}
+    fn set_recv_options(&mut self, _opt: ()) {}
+}
+
+#[cfg(not(feature = "async"))]
+impl<Link, Msg> TransportDetails<Link> for ShardedBucketTransport<Link, Msg> {
+    type Details = ();
+    fn get_link_details(&mut self, _opt: &Link) -> Result<Self::Details> {
+        Ok(())
+    }
+}
+
+#[cfg(not(feature = "async"))]
+impl<Link, Msg> Transport<Link, Msg> for ShardedBucketTransport<Link, Msg>
+where
+    Link: Eq + hash::Hash + Clone + core::fmt::Debug + core::fmt::Display,
+    Msg: LinkedMessage<Link> + Clone,
+{
+    fn send_message(&mut self, msg: &Msg) -> Result<()> {
+        self.insert(msg.clone());
+        Ok(())
+    }
+
+    fn send_owned_message(&mut self, msg: Msg) -> Result<()> {
+        self.insert(msg);
+        Ok(())
+    }
+
+    fn recv_messages(&mut self, link: &Link) -> Result<Vec<Msg>> {
+        match self.read(link).entries.get(link) {
+            Some(msgs) => Ok(msgs.iter().map(|msg| Msg::clone(msg)).collect()),
+            None => err!(MessageLinkNotFound(link.to_string())),
+        }
+    }
+
+    fn recv_message(&mut self, link: &Link) -> Result<Msg> {
+        self.recv_shared_message(link).map(|msg| Msg::clone(&msg))
+    }
+
+    fn recv_message_batch(&mut self, links: &[Link]) -> Vec<Result<Msg>> {
+        links
+            .iter()
+            .map(|link| self.recv_shared_message(link).map(|msg| Msg::clone(&msg)))
+            .collect()
+    }
+}
+
+#[cfg(feature = "async")]
+#[async_trait(?Send)]
+impl<Link, Msg> Transport<Link, Msg> for ShardedBucketTransport<Link, Msg>
+where
+    Link: Eq + hash::Hash + Clone + core::marker::Send + core::marker::Sync + core::fmt::Display,
+    Msg: LinkedMessage<Link> + Clone + core::marker::Send + core::marker::Sync,
+{
+    async fn send_message(&mut self, msg: &Msg) -> Result<()> {
+        self.insert(msg.clone());
+        Ok(())
+    }
+
+    async fn send_owned_message(&mut self, msg: Msg) -> Result<()> {
+        self.insert(msg);
+        Ok(())
+    }
+
+    async fn send_messages(&mut self, msgs: Vec<Msg>) -> Result<()> {
+        for msg in msgs {
+            self.insert(msg);
+        }
+        Ok(())
+    }
+
+    async fn recv_messages(&mut self, link: &Link) -> Result<Vec<Msg>> {
+        match self.read(link).entries.get(link) {
+            Some(msgs) => Ok(msgs.iter().map(|msg| Msg::clone(msg)).collect()),
+            None => err!(MessageLinkNotFound(link.to_string())),
+        }
+    }
+
+    async fn recv_message(&mut self, link: &Link) -> Result<Msg> {
+        self.recv_shared_message(link).map(|msg| Msg::clone(&msg))
+    }
+
+    async fn recv_message_batch(&mut self, links: &[Link]) -> Vec<Result<Msg>> {
+        links
+            .iter()
+            .map(|link| self.recv_shared_message(link).map(|msg| Msg::clone(&msg)))
+            .collect()
+    }
+}
+
+#[cfg(feature = "async")]
+#[async_trait(?Send)]
+impl<Link, Msg> TransportDetails<Link> for ShardedBucketTransport<Link, Msg>
+where
+    Link: Eq + hash::Hash + Clone + core::marker::Send + core::marker::Sync + core::fmt::Display,
+{
+    type Details = ();
+    async fn get_link_details(&mut self, _opt: &Link) -> Result<Self::Details> {
+        Ok(())
+    }
+}
@@ -1,8 +1,21 @@
 use futures::executor::block_on;
+#[cfg(not(feature = "async"))]
+use futures::{
+    channel::oneshot,
+    executor::ThreadPool,
+};
+
+use core::future::Future;
 
 #[cfg(feature = "async")]
 use core::cell::RefCell;
-use core::fmt;
+use core::{
+    fmt,
+    sync::atomic::{
+        AtomicUsize,
+        Ordering,
+    },
+};
 #[cfg(feature = "async")]
 use iota_streams_core::prelude::Rc;
 
@@ -20,7 +33,13 @@ use iota_client::bee_message::{
 
 use iota_streams_core::{
     err,
-    prelude::Vec,
+    metrics_add,
+    metrics_time,
+    prelude::{
+        sync::Mutex,
+        Arc,
+        Vec,
+    },
     try_or,
     wrapped_err,
     Errors::*,
@@ -36,10 +55,35 @@ use crate::{
     },
 };
 
-use futures::future::join_all;
+use futures::{
+    future::join_all,
+    stream::{
+        self,
+        StreamExt,
+    },
+};
 
 use iota_streams_core::prelude::String;
 
+#[cfg(feature = "mqtt")]
+use iota_client::{
+    Topic,
+    TopicEvent,
+};
+#[cfg(feature = "mqtt")]
+use iota_streams_core::prelude::HashMap;
+#[cfg(any(feature = "mqtt", not(feature = "async")))]
+use iota_streams_core::prelude::sync::Condvar;
+#[cfg(not(feature = "async"))]
+use iota_streams_core::prelude::{
+    sync::MutexGuard,
+    VecDeque,
+};
+#[cfg(feature = "mqtt")]
+use std::time::Duration;
+#[cfg(any(feature = "mqtt", not(feature = "async")))]
+use std::time::Instant;
+
 /// Options for the user Client
 #[derive(Clone)]
 pub struct SendOptions {
@@ -56,6 +100,21 @@ impl Default for SendOptions {
     }
 }
 
+/// Receive options for the user Client
+#[derive(Clone)]
+pub struct RecvOptions {
+    /// Maximum number of node requests in flight when several messages are retrieved at once
+    pub max_concurrent_fetches: usize,
+}
+
+impl Default for RecvOptions {
+    fn default() -> Self {
+        Self {
+            max_concurrent_fetches: 16,
+        }
+    }
+}
+
 #[derive(Clone, Debug)]
 pub struct Details {
     pub metadata: MessageMetadataResponse,
@@ -80,12 +139,8 @@ use super::get_hash;
 /// Checked bundles are returned by `client.get_message().index`.
 pub fn msg_from_tangle_message<F>(message: &Message, link: &TangleAddress) -> Result<TangleMessage<F>> {
     if let Some(Payload::Indexation(i)) = message.payload().as_ref() {
-        let mut bytes = Vec::<u8>::new();
-        for b in i.data() {
-            bytes.push(*b);
-        }
-
-        let binary = BinaryMessage::new(link.clone(), TangleAddress::default(), bytes.into());
+        metrics_add!(BytesIn, i.data().len());
+        let binary = BinaryMessage::new(link.clone(), TangleAddress::default(), i.data().to_vec().into());
         // TODO get timestamp
         let timestamp: u64 = 0;
 
@@ -95,17 +150,26 @@ pub fn msg_from_tangle_message<F>(message: &Message, link: &TangleAddress) -> Re
     }
 }
 
+/// Messages indexed by `tx_address` and `tx_tag`, empty if there are none. Errors are node failures.
 async fn get_messages(client: &iota_client::Client, tx_address: &[u8], tx_tag: &[u8]) -> Result<Vec<Message>> {
     let hash = get_hash(tx_address, tx_tag)?;
-    let msg_ids = handle_client_result(client.get_message().index(&hash.to_string()).await)?;
-    try_or!(!msg_ids.is_empty(), IndexNotFound)?;
+    let msg_ids = metrics_time!(
+        IndexLookup,
+        handle_client_result(client.get_message().index(&hash.to_string()).await)
+    )?;
+    if msg_ids.is_empty() {
+        return Ok(Vec::new());
+    }
 
-    let msgs = join_all(
-        msg_ids
-            .iter()
-            .map(|msg| async move { handle_client_result(client.get_message().data(msg).await) }),
+    let msgs = metrics_time!(
+        Fetch,
+        join_all(
+            msg_ids
+                .iter()
+                .map(|msg| async move { handle_client_result(client.get_message().data(msg).await) }),
+        )
+        .await
     )
-    .await
     .into_iter()
     .filter_map(|msg| msg.ok())
     .collect::<Vec<_>>();
@@ -115,21 +179,47 @@ async fn get_messages(client: &iota_client::Client, tx_address: &[u8], tx_tag: &
 
 /// Send a message to the Tangle using a node client
 pub async fn async_send_message_with_options<F>(client: &iota_client::Client, msg: &TangleMessage<F>) -> Result<()> {
-    let hash = get_hash(msg.binary.link.appinst.as_ref(), msg.binary.link.msgid.as_ref())?;
-    let binary = &msg.binary;
+    async_send_bytes(client, &msg.binary.link, msg.binary.body.bytes.clone()).await
+}
 
-    let mut bytes = Vec::<u8>::new();
-    for b in &binary.body.bytes {
-        bytes.push(*b);
-    }
+/// Send a message to the Tangle using a node client, moving the message body into the request
+pub async fn async_send_owned_message_with_options<F>(
+    client: &iota_client::Client,
+    msg: TangleMessage<F>,
+) -> Result<()> {
+    let binary = msg.binary;
+    async_send_bytes(client, &binary.link, binary.body.bytes).await
+}
+
+async fn async_send_bytes(client: &iota_client::Client, link: &TangleAddress, bytes: Vec<u8>) -> Result<()> {
+    let hash = get_hash(link.appinst.as_ref(), link.msgid.as_ref())?;
+    metrics_add!(BytesOut, bytes.len());
+    metrics_time!(
+        Send,
+        client
+            .message()
+            .with_index(&hash.to_string())
+            .with_data(bytes)
+            .finish()
+            .await
+    )?;
+    Ok(())
+}
 
-    // TODO: Get rid of copy caused by to_owned
-    client
-        .message()
-        .with_index(&hash.to_string())
-        .with_data(bytes)
-        .finish()
-        .await?;
+/// Send a batch of messages to the Tangle using a node client
+///
+/// Messages are submitted to the node concurrently with the async client. Requests of the sync
+/// client block, they are then submitted one after the other and the batch only saves calls; the
+/// `Client` transport runs them on its executor instead. Indexation messages carry no ordering on
+/// the Tangle, so readers are unaffected by the order in which the submissions complete.
+pub async fn async_send_messages_with_options<F>(
+    client: &iota_client::Client,
+    msgs: Vec<TangleMessage<F>>,
+) -> Result<()> {
+    let sends = msgs
+        .into_iter()
+        .map(|msg| async_send_owned_message_with_options(client, msg));
+    join_all(sends).await.into_iter().collect::<Result<Vec<()>>>()?;
     Ok(())
 }
 
@@ -138,26 +228,68 @@ pub async fn async_recv_messages<F>(
     client: &iota_client::Client,
     link: &TangleAddress,
 ) -> Result<Vec<TangleMessage<F>>> {
+    // Just ignore the error?
+    Ok(try_recv_messages(client, link).await.unwrap_or_default())
+}
+
+/// Retrieve messages from the tangle using a node client, errors are node failures
+async fn try_recv_messages<F>(client: &iota_client::Client, link: &TangleAddress) -> Result<Vec<TangleMessage<F>>> {
     let tx_address = link.appinst.as_ref();
     let tx_tag = link.msgid.as_ref();
-    match get_messages(client, tx_address, tx_tag).await {
-        Ok(txs) => Ok(txs
-            .iter()
-            .filter_map(|b| msg_from_tangle_message(b, link).ok()) // Ignore errors
-            .collect()),
-        Err(_) => Ok(Vec::new()), // Just ignore the error?
+    let txs = get_messages(client, tx_address, tx_tag).await?;
+    Ok(txs
+        .iter()
+        .filter_map(|b| msg_from_tangle_message(b, link).ok()) // Ignore errors
+        .collect())
+}
+
+/// Retrieve a unique message from the tangle using a node client
+pub async fn async_recv_message<F>(client: &iota_client::Client, link: &TangleAddress) -> Result<TangleMessage<F>> {
+    let mut msgs = async_recv_messages(client, link).await?;
+    if let Some(msg) = msgs.pop() {
+        try_or!(msgs.is_empty(), MessageNotUnique(link.to_string()))?;
+        Ok(msg)
+    } else {
+        err!(MessageLinkNotFound(link.to_string()))
     }
 }
 
+/// Retrieve a unique message for each of the links from the tangle using a node client
+///
+/// At most `max_concurrent` requests are in flight at any time, results are in the order of `links`.
+/// Requests of the sync client block, they then run one after the other; the `Client` transport
+/// runs them on its executor instead.
+pub async fn async_recv_message_batch<F>(
+    client: &iota_client::Client,
+    links: &[TangleAddress],
+    max_concurrent: usize,
+) -> Vec<Result<TangleMessage<F>>> {
+    stream::iter(links)
+        .map(|link| async_recv_message(client, link))
+        .buffered(core::cmp::max(max_concurrent, 1))
+        .collect()
+        .await
+}
+
 /// Retrieve details of a link from the tangle using a node client
 pub async fn async_get_link_details(client: &iota_client::Client, link: &TangleAddress) -> Result<Details> {
+    try_get_link_details(client, link)
+        .await?
+        .map_or_else(|| err!(IndexNotFound), Ok)
+}
+
+/// Retrieve details of a link using a node client, `None` if the link is not indexed. Errors are
+/// node failures.
+async fn try_get_link_details(client: &iota_client::Client, link: &TangleAddress) -> Result<Option<Details>> {
     let tx_address = link.appinst.as_ref();
     let tx_tag = link.msgid.as_ref();
 
     let hash = get_hash(tx_address, tx_tag)?;
 
     let msg_ids = handle_client_result(client.get_message().index(&hash.to_string()).await)?;
-    try_or!(!msg_ids.is_empty(), IndexNotFound)?;
+    if msg_ids.is_empty() {
+        return Ok(None);
+    }
 
     let metadata = handle_client_result(client.get_message().metadata(&msg_ids[0]).await)?;
 
@@ -166,7 +298,7 @@ pub async fn async_get_link_details(client: &iota_client::Client, link: &TangleA
         milestone = Some(handle_client_result(client.get_milestone(ms_index).await)?);
     }
 
-    Ok(Details { metadata, milestone })
+    Ok(Some(Details { metadata, milestone }))
 }
 
 /// Synchronised - Send message to the tangle using a node client
@@ -175,22 +307,740 @@ pub fn sync_send_message_with_options<F>(client: &iota_client::Client, msg: &Tan
     block_on(async_send_message_with_options(client, msg))
 }
 
+/// Synchronised - Send a message to the tangle using a node client, moving the message body into the request
+#[cfg(not(feature = "async"))]
+pub fn sync_send_owned_message_with_options<F>(client: &iota_client::Client, msg: TangleMessage<F>) -> Result<()> {
+    block_on(async_send_owned_message_with_options(client, msg))
+}
+
+/// Synchronised - Send a batch of messages to the tangle using a node client
+#[cfg(not(feature = "async"))]
+pub fn sync_send_messages_with_options<F>(client: &iota_client::Client, msgs: Vec<TangleMessage<F>>) -> Result<()> {
+    block_on(async_send_messages_with_options(client, msgs))
+}
+
 /// Synchronised - Retrieve a message from the tangle using a node client
 #[cfg(not(feature = "async"))]
 pub fn sync_recv_messages<F>(client: &iota_client::Client, link: &TangleAddress) -> Result<Vec<TangleMessage<F>>> {
     block_on(async_recv_messages(client, link))
 }
 
+/// Synchronised - Retrieve a unique message for each of the links from the tangle using a node client
+#[cfg(not(feature = "async"))]
+pub fn sync_recv_message_batch<F>(
+    client: &iota_client::Client,
+    links: &[TangleAddress],
+    max_concurrent: usize,
+) -> Vec<Result<TangleMessage<F>>> {
+    block_on(async_recv_message_batch(client, links, max_concurrent))
+}
+
 /// Synchronised - Retrieve details of a link from the tangle using a node client
 #[cfg(not(feature = "async"))]
 pub fn sync_get_link_details(client: &iota_client::Client, link: &TangleAddress) -> Result<Details> {
     block_on(async_get_link_details(client, link))
 }
 
+/// Request statistics of a node of a `Client`.
+#[derive(Clone, Copy, Debug, Default)]
+pub struct NodeStats {
+    /// Moving average of the latency of successful requests, in microseconds
+    pub latency_us: u64,
+    /// Number of requests sent to the node
+    pub requests: u64,
+    /// Number of failed requests
+    pub failures: u64,
+    /// Number of failed requests since the last successful one
+    pub consecutive_failures: u32,
+}
+
+impl NodeStats {
+    /// Lower is better. Every consecutive failure doubles the score of a node, which is at least
+    /// `FAILURE_PENALTY_US` while failing, so that quickly refused requests don't make it look fast.
+    fn score(&self) -> u64 {
+        const FAILURE_PENALTY_US: u64 = 1_000_000;
+        if self.consecutive_failures == 0 {
+            self.latency_us
+        } else {
+            core::cmp::max(self.latency_us, FAILURE_PENALTY_US) << core::cmp::min(self.consecutive_failures, 16)
+        }
+    }
+
+    fn record(&mut self, latency_us: u64, succeeded: bool) {
+        self.requests += 1;
+        if succeeded {
+            self.latency_us = if self.latency_us == 0 {
+                latency_us
+            } else {
+                (7 * self.latency_us + latency_us) / 8
+            };
+            self.consecutive_failures = 0;
+        } else {
+            self.failures += 1;
+            self.consecutive_failures = self.consecutive_failures.saturating_add(1);
+        }
+    }
+}
+
+struct Node {
+    url: String,
+    client: iota_client::Client,
+    stats: Mutex<NodeStats>,
+}
+
+impl Node {
+    fn new(url: String, client: iota_client::Client) -> Self {
+        Self {
+            url,
+            client,
+            stats: Mutex::new(NodeStats::default()),
+        }
+    }
+
+    fn stats(&self) -> NodeStats {
+        *self.stats.lock().unwrap_or_else(|err| err.into_inner())
+    }
+
+    async fn run<T>(&self, request: impl Future<Output = Result<T>>) -> Result<T> {
+        let start = chrono::Utc::now();
+        let result = request.await;
+        let elapsed = chrono::Utc::now().signed_duration_since(start);
+        let latency_us = elapsed
+            .num_microseconds()
+            .map_or(u64::MAX, |us| core::cmp::max(us, 0) as u64);
+        self.stats
+            .lock()
+            .unwrap_or_else(|err| err.into_inner())
+            .record(latency_us, result.is_ok());
+        result
+    }
+}
+
+/// Nodes of a `Client`. Requests are spread over the nodes, preferring the faster of two
+/// candidates, and reads failing on a node are retried on the next ones.
+struct NodePool {
+    nodes: Vec<Node>,
+    turn: AtomicUsize,
+    /// Executor for background requests, the one shared by the process unless replaced
+    #[cfg(not(feature = "async"))]
+    executor: Mutex<ThreadPool>,
+}
+
+impl NodePool {
+    /// Every `PROBE_INTERVAL` turns the round-robin candidate is taken regardless of its score, so
+    /// that recovered nodes get a chance to show it.
+    const PROBE_INTERVAL: usize = 32;
+    const MAX_READ_ATTEMPTS: usize = 3;
+
+    fn new(nodes: Vec<Node>) -> Self {
+        Self {
+            nodes,
+            turn: AtomicUsize::new(0),
+            #[cfg(not(feature = "async"))]
+            executor: Mutex::new(SHARED_EXECUTOR.clone()),
+        }
+    }
+
+    #[cfg(not(feature = "async"))]
+    fn executor(&self) -> ThreadPool {
+        self.executor.lock().unwrap_or_else(|err| err.into_inner()).clone()
+    }
+
+    #[cfg(not(feature = "async"))]
+    fn set_executor(&self, executor: ThreadPool) {
+        *self.executor.lock().unwrap_or_else(|err| err.into_inner()) = executor;
+    }
+
+    fn select(&self) -> usize {
+        let n = self.nodes.len();
+        let turn = self.turn.fetch_add(1, Ordering::Relaxed);
+        let first = turn % n;
+        if n == 1 || turn % Self::PROBE_INTERVAL == 0 {
+            return first;
+        }
+        let second = (first + 1 + (turn / n) % (n - 1)) % n;
+        if self.nodes[second].stats().score() < self.nodes[first].stats().score() {
+            second
+        } else {
+            first
+        }
+    }
+
+    /// Run a request on a single node. Used for sends, which are not idempotent: a message
+    /// resubmitted on another node would be attached twice.
+    async fn send<'a, T, Fut>(&'a self, request: impl FnOnce(&'a iota_client::Client) -> Fut) -> Result<T>
+    where
+        Fut: Future<Output = Result<T>> + 'a,
+    {
+        let node = &self.nodes[self.select()];
+        node.run(request(&node.client)).await
+    }
+
+    /// Run a request, failing over to the next nodes on error.
+    async fn read<'a, T, Fut>(&'a self, request: impl Fn(&'a iota_client::Client) -> Fut) -> Result<T>
+    where
+        Fut: Future<Output = Result<T>> + 'a,
+    {
+        let first = self.select();
+        let attempts = core::cmp::min(self.nodes.len(), Self::MAX_READ_ATTEMPTS);
+        let mut result = err!(EmptyNodeList);
+        for i in 0..attempts {
+            let node = &self.nodes[(first + i) % self.nodes.len()];
+            result = node.run(request(&node.client)).await;
+            if result.is_ok() {
+                break;
+            }
+        }
+        result
+    }
+
+    fn stats(&self) -> Vec<(String, NodeStats)> {
+        self.nodes.iter().map(|node| (node.url.clone(), node.stats())).collect()
+    }
+}
+
+/// Run a node request on the executor of `pool`. Requests of the sync client block the thread
+/// polling them, the returned future waits for the request without blocking so that several of
+/// them run at once.
+#[cfg(not(feature = "async"))]
+fn run_detached<T, Fut>(pool: &NodePool, request: Fut) -> impl Future<Output = Result<T>>
+where
+    T: 'static + Send,
+    Fut: 'static + Future<Output = Result<T>> + Send,
+{
+    let (sender, receiver) = oneshot::channel();
+    pool.executor().spawn_ok(async move {
+        // Nobody is waiting for the result if the batch has been dropped.
+        let _ = sender.send(request.await);
+    });
+    async move { receiver.await.unwrap_or_else(|_canceled| err!(TransportNotAvailable)) }
+}
+
+/// Run node requests on the executor of `pool` with at most `max_concurrent` of them in flight,
+/// results are in the order of the requests.
+#[cfg(not(feature = "async"))]
+async fn detached_batch<T, Fut, I>(pool: &NodePool, requests: I, max_concurrent: usize) -> Vec<Result<T>>
+where
+    I: IntoIterator<Item = Fut>,
+    T: 'static + Send,
+    Fut: 'static + Future<Output = Result<T>> + Send,
+{
+    stream::iter(requests)
+        .map(|request| run_detached(pool, request))
+        .buffered(core::cmp::max(max_concurrent, 1))
+        .collect()
+        .await
+}
+
+/// Run node requests in place with at most `max_concurrent` of them in flight, results are in the
+/// order of the requests.
+#[cfg(feature = "async")]
+async fn detached_batch<T, Fut, I>(_pool: &NodePool, requests: I, max_concurrent: usize) -> Vec<Result<T>>
+where
+    I: IntoIterator<Item = Fut>,
+    Fut: Future<Output = Result<T>>,
+{
+    stream::iter(requests)
+        .buffered(core::cmp::max(max_concurrent, 1))
+        .collect()
+        .await
+}
+
+/// Run a node request in place, requests of the async client do not block.
+#[cfg(feature = "async")]
+fn run_detached<T, Fut>(_pool: &NodePool, request: Fut) -> Fut
+where
+    Fut: Future<Output = Result<T>>,
+{
+    request
+}
+
+async fn pool_send_message<F>(pool: &NodePool, msg: &TangleMessage<F>) -> Result<()> {
+    pool.send(|client| async_send_message_with_options(client, msg)).await
+}
+
+async fn pool_send_owned_message<F>(pool: &NodePool, msg: TangleMessage<F>) -> Result<()> {
+    pool.send(move |client| async_send_owned_message_with_options(client, msg))
+        .await
+}
+
+async fn pool_send_messages<F>(pool: &Arc<NodePool>, msgs: Vec<TangleMessage<F>>) -> Result<()>
+where
+    F: 'static + core::marker::Send + core::marker::Sync,
+{
+    let sends = msgs.into_iter().map(|msg| {
+        let nodes = pool.clone();
+        run_detached(pool, async move { pool_send_owned_message(&nodes, msg).await })
+    });
+    join_all(sends).await.into_iter().collect::<Result<Vec<()>>>()?;
+    Ok(())
+}
+
+async fn pool_recv_messages<F>(pool: &NodePool, link: &TangleAddress) -> Result<Vec<TangleMessage<F>>> {
+    // Just ignore the error?
+    Ok(pool
+        .read(|client| try_recv_messages(client, link))
+        .await
+        .unwrap_or_default())
+}
+
+async fn pool_recv_message<F>(pool: &NodePool, link: &TangleAddress) -> Result<TangleMessage<F>> {
+    let mut msgs = pool_recv_messages(pool, link).await?;
+    if let Some(msg) = msgs.pop() {
+        try_or!(msgs.is_empty(), MessageNotUnique(link.to_string()))?;
+        Ok(msg)
+    } else {
+        err!(MessageLinkNotFound(link.to_string()))
+    }
+}
+
+async fn pool_recv_message_batch<F>(
+    pool: &Arc<NodePool>,
+    links: &[TangleAddress],
+    max_concurrent: usize,
+) -> Vec<Result<TangleMessage<F>>>
+where
+    F: 'static + core::marker::Send + core::marker::Sync,
+{
+    let requests = links.iter().cloned().map(|link| {
+        let pool = pool.clone();
+        async move { pool_recv_message(&pool, &link).await }
+    });
+    detached_batch(pool, requests, max_concurrent).await
+}
+
+async fn pool_get_link_details(pool: &NodePool, link: &TangleAddress) -> Result<Details> {
+    pool.read(|client| try_get_link_details(client, link))
+        .await?
+        .map_or_else(|| err!(IndexNotFound), Ok)
+}
+
+/// Links watched through node events, see `Client::enable_events`.
+#[cfg(feature = "mqtt")]
+struct Events {
+    /// Topic of every watched link, along with whether a message was announced on it since the link
+    /// was last retrieved
+    watched: Mutex<HashMap<String, bool>>,
+    /// Time of the last retrieval of all the watched links regardless of events
+    last_fallback: Mutex<Instant>,
+    fallback_interval: Duration,
+    arrival: Condvar,
+}
+
+#[cfg(feature = "mqtt")]
+impl Events {
+    fn new(fallback_interval: Duration) -> Self {
+        Self {
+            watched: Mutex::new(HashMap::new()),
+            last_fallback: Mutex::new(Instant::now()),
+            fallback_interval,
+            arrival: Condvar::new(),
+        }
+    }
+
+    /// Topic of the messages indexed by `link`. The index of a message is the hex encoded hash of
+    /// its link, topics carry it hex encoded once more.
+    fn topic(link: &TangleAddress) -> Result<String> {
+        let hash = get_hash(link.appinst.as_ref(), link.msgid.as_ref())?;
+        Ok(format!("messages/indexation/{}", hex::encode(hash)))
+    }
+
+    fn notify(&self, event: &TopicEvent) {
+        let mut watched = self.watched.lock().unwrap_or_else(|err| err.into_inner());
+        if let Some(arrived) = watched.get_mut(&event.topic) {
+            *arrived = true;
+            self.arrival.notify_all();
+        }
+    }
+
+    /// Whether the fallback retrieval of all the watched links is due, restarting its interval if so.
+    fn fallback_due(&self) -> bool {
+        let mut last_fallback = self.last_fallback.lock().unwrap_or_else(|err| err.into_inner());
+        if last_fallback.elapsed() < self.fallback_interval {
+            return false;
+        }
+        *last_fallback = Instant::now();
+        true
+    }
+}
+
+/// Retrieve a message for each of the links, skipping the watched links on which no message was
+/// announced. Links without a message are watched from then on, links retrieved no longer are.
+#[cfg(feature = "mqtt")]
+async fn events_recv_message_batch<F>(
+    pool: &Arc<NodePool>,
+    events: &Arc<Events>,
+    links: &[TangleAddress],
+    max_concurrent: usize,
+) -> Vec<Result<TangleMessage<F>>> {
+    let topics: Vec<Option<String>> = links.iter().map(|link| Events::topic(link).ok()).collect();
+    let fallback = events.fallback_due();
+    let wanted: Vec<bool> = {
+        let watched = events.watched.lock().unwrap_or_else(|err| err.into_inner());
+        topics
+            .iter()
+            .map(|topic| match topic.as_ref().and_then(|topic| watched.get(topic)) {
+                Some(arrived) => fallback || *arrived,
+                None => true,
+            })
+            .collect()
+    };
+    let to_fetch: Vec<TangleAddress> = links
+        .iter()
+        .zip(&wanted)
+        .filter(|(_link, wanted)| **wanted)
+        .map(|(link, _wanted)| link.clone())
+        .collect();
+    let mut fetched = pool_recv_message_batch(pool, &to_fetch, max_concurrent)
+        .await
+        .into_iter();
+
+    let mut results = Vec::with_capacity(links.len());
+    let mut subscribe = Vec::new();
+    let mut unsubscribe = Vec::new();
+    {
+        let mut watched = events.watched.lock().unwrap_or_else(|err| err.into_inner());
+        for ((link, topic), wanted) in links.iter().zip(topics).zip(wanted) {
+            if !wanted {
+                results.push(err!(MessageLinkNotFound(link.to_string())));
+                continue;
+            }
+            let result = fetched
+                .next()
+                .unwrap_or_else(|| err!(MessageLinkNotFound(link.to_string())));
+            if let Some(topic) = topic {
+                match (&result, watched.get_mut(&topic)) {
+                    (Ok(_), Some(_)) => {
+                        watched.remove(&topic);
+                        unsubscribe.push(topic);
+                    }
+                    (Ok(_), None) => {}
+                    (Err(_), Some(arrived)) => *arrived = false,
+                    (Err(_), None) => {
+                        watched.insert(topic.clone(), false);
+                        subscribe.push(topic);
+                    }
+                }
+            }
+            results.push(result);
+        }
+    }
+
+    // Topics are handled by the first node, links failing to be subscribed to are polled again
+    let mut client = pool.nodes[0].client.clone();
+    if !unsubscribe.is_empty() {
+        let topics: Vec<Topic> = unsubscribe
+            .into_iter()
+            .filter_map(|topic| Topic::new(topic).ok())
+            .collect();
+        let _ = client.subscriber().with_topics(topics).unsubscribe().await;
+    }
+    if !subscribe.is_empty() {
+        let topics: Vec<Topic> = subscribe
+            .iter()
+            .filter_map(|topic| Topic::new(topic.clone()).ok())
+            .collect();
+        let notified = events.clone();
+        let subscribed = client
+            .subscriber()
+            .with_topics(topics)
+            .subscribe(move |event| notified.notify(event))
+            .await;
+        if subscribed.is_err() {
+            let mut watched = events.watched.lock().unwrap_or_else(|err| err.into_inner());
+            for topic in subscribe {
+                watched.remove(&topic);
+            }
+        }
+    }
+    results
+}
+
+/// Handle to a request running in the background on the executor of a `Client`.
+#[cfg(not(feature = "async"))]
+pub struct Request<T> {
+    receiver: oneshot::Receiver<Result<T>>,
+    result: Option<Result<T>>,
+}
+
+#[cfg(not(feature = "async"))]
+impl<T: 'static + Send> Request<T> {
+    fn spawn<Fut>(executor: &ThreadPool, fut: Fut) -> Self
+    where
+        Fut: 'static + Future<Output = Result<T>> + Send,
+    {
+        let (sender, receiver) = oneshot::channel();
+        executor.spawn_ok(async move {
+            // Nobody is waiting for the result if the request handle has been dropped.
+            let _ = sender.send(fut.await);
+        });
+        Self { receiver, result: None }
+    }
+}
+
+#[cfg(not(feature = "async"))]
+impl<T> Request<T> {
+    /// Check whether the request has completed, without blocking.
+    pub fn poll(&mut self) -> bool {
+        if self.result.is_none() {
+            match self.receiver.try_recv() {
+                Ok(Some(result)) => self.result = Some(result),
+                Ok(None) => {}
+                Err(_canceled) => self.result = Some(err!(TransportNotAvailable)),
+            }
+        }
+        self.result.is_some()
+    }
+
+    /// Block until the request has completed.
+    pub fn wait(&mut self) {
+        if self.result.is_none() {
+            self.result = Some(block_on(&mut self.receiver).unwrap_or_else(|_canceled| err!(TransportNotAvailable)));
+        }
+    }
+
+    /// Whether a completed request has succeeded, `None` while still in flight.
+    pub fn succeeded(&mut self) -> Option<bool> {
+        if self.poll() {
+            self.result.as_ref().map(|result| result.is_ok())
+        } else {
+            None
+        }
+    }
+
+    /// Take the result of a completed request, `None` while still in flight. The result can only
+    /// be taken once.
+    pub fn take(&mut self) -> Option<Result<T>> {
+        if self.poll() {
+            self.result.take()
+        } else {
+            None
+        }
+    }
+}
+
+/// Options of the send queue of a `Client`, see `Client::enable_send_queue`.
+#[cfg(not(feature = "async"))]
+#[derive(Clone, Copy, Debug)]
+pub struct SendQueueOptions {
+    /// Maximum number of messages queued or in flight, sends block while it is reached
+    pub depth: usize,
+    /// Maximum number of submissions in flight
+    pub max_concurrent_sends: usize,
+}
+
+#[cfg(not(feature = "async"))]
+impl Default for SendQueueOptions {
+    fn default() -> Self {
+        Self {
+            depth: 256,
+            max_concurrent_sends: 16,
+        }
+    }
+}
+
+/// State of the send queue of a `Client` at one point in time.
+#[cfg(not(feature = "async"))]
+#[derive(Clone, Debug, Default)]
+pub struct SendQueueStats {
+    /// Messages waiting for submission
+    pub queued: usize,
+    /// Submissions in flight
+    pub in_flight: usize,
+    /// Current limit of submissions in flight
+    pub concurrency: usize,
+    /// Messages queued or in flight at which sends block
+    pub depth: usize,
+    /// Submissions failed since the last flush
+    pub failed: usize,
+    /// Links of the messages whose submission failed since the last flush
+    pub failed_links: Vec<TangleAddress>,
+}
+
+#[cfg(not(feature = "async"))]
+struct SendQueueState {
+    pending: VecDeque<(TangleAddress, Vec<u8>)>,
+    /// Messages being submitted, kept until their submission completes so that reads find them
+    in_flight: Vec<(TangleAddress, Vec<u8>)>,
+    limit: usize,
+    /// Submissions completed since the limit last changed
+    completed: usize,
+    /// Latency of the fastest recent submissions, in microseconds
+    base_latency_us: u64,
+    /// Links of the submissions failed since the last flush
+    failed: Vec<TangleAddress>,
+}
+
+/// Messages sent through a `Client` with a send queue, submitted in the background. Messages are
+/// served to reads of the client from the queue until their submission completes.
+///
+/// Submissions in flight are limited by an additive-increase/multiplicative-decrease scheme
+/// following the latency observed: the limit grows by one after a full round of submissions
+/// completing within twice the base latency, and halves after a round with slower or failed ones.
+/// The base latency follows the fastest submissions, drifting up slowly so that it adjusts to a
+/// node becoming slower for good.
+#[cfg(not(feature = "async"))]
+struct SendQueue {
+    depth: usize,
+    max_concurrent_sends: usize,
+    nodes: Arc<NodePool>,
+    state: Mutex<SendQueueState>,
+    /// Notified when a submission completes
+    completion: Condvar,
+}
+
+#[cfg(not(feature = "async"))]
+impl SendQueue {
+    fn new(options: SendQueueOptions, nodes: Arc<NodePool>, failed: Vec<TangleAddress>) -> Self {
+        let max_concurrent_sends = core::cmp::max(options.max_concurrent_sends, 1);
+        Self {
+            depth: core::cmp::max(options.depth, 1),
+            max_concurrent_sends,
+            nodes,
+            state: Mutex::new(SendQueueState {
+                pending: VecDeque::new(),
+                in_flight: Vec::new(),
+                // Start low and let the limit grow to what the node sustains
+                limit: core::cmp::min(2, max_concurrent_sends),
+                completed: 0,
+                base_latency_us: 0,
+                failed,
+            }),
+            completion: Condvar::new(),
+        }
+    }
+
+    fn lock(&self) -> MutexGuard<'_, SendQueueState> {
+        self.state.lock().unwrap_or_else(|err| err.into_inner())
+    }
+
+    fn wait<'a>(&self, state: MutexGuard<'a, SendQueueState>) -> MutexGuard<'a, SendQueueState> {
+        self.completion.wait(state).unwrap_or_else(|err| err.into_inner())
+    }
+
+    /// Queue a message, blocking while the queue is full.
+    fn push(self: &Arc<Self>, link: TangleAddress, bytes: Vec<u8>) {
+        let mut state = self.lock();
+        while state.pending.len() + state.in_flight.len() >= self.depth {
+            state = self.wait(state);
+        }
+        state.pending.push_back((link, bytes));
+        drop(state);
+        self.dispatch();
+    }
+
+    /// Submit as many queued messages as the limit allows, each on its own, as requests block a
+    /// thread of the executor with the sync client.
+    fn dispatch(self: &Arc<Self>) {
+        let batch: Vec<_> = {
+            let mut state = self.lock();
+            let n = core::cmp::min(state.limit.saturating_sub(state.in_flight.len()), state.pending.len());
+            let batch: Vec<_> = state.pending.drain(..n).collect();
+            state.in_flight.extend(batch.iter().cloned());
+            batch
+        };
+        let executor = self.nodes.executor();
+        for (link, bytes) in batch {
+            let queue = self.clone();
+            executor.spawn_ok(async move {
+                let start = Instant::now();
+                let result = queue.nodes.send(|client| async_send_bytes(client, &link, bytes)).await;
+                queue.complete(link, result.is_ok(), start.elapsed().as_micros() as u64);
+            });
+        }
+    }
+
+    fn complete(self: &Arc<Self>, link: TangleAddress, succeeded: bool, latency_us: u64) {
+        let mut state = self.lock();
+        if let Some(i) = state.in_flight.iter().position(|(l, _)| *l == link) {
+            state.in_flight.swap_remove(i);
+        }
+        state.completed += 1;
+        let slow = if succeeded {
+            state.base_latency_us = match state.base_latency_us {
+                0 => latency_us,
+                base => core::cmp::min(latency_us, base + base / 16 + 1),
+            };
+            latency_us > 2 * state.base_latency_us
+        } else {
+            state.failed.push(link);
+            true
+        };
+        if slow && state.completed >= state.limit / 2 {
+            state.limit = core::cmp::max(state.limit / 2, 1);
+            state.completed = 0;
+        } else if !slow && state.completed >= state.limit {
+            state.limit = core::cmp::min(state.limit + 1, self.max_concurrent_sends);
+            state.completed = 0;
+        }
+        drop(state);
+        self.completion.notify_all();
+        self.dispatch();
+    }
+
+    /// Block until all queued messages have been submitted, returns the links of the submissions
+    /// failed since the last flush.
+    fn flush(&self) -> Vec<TangleAddress> {
+        let mut state = self.lock();
+        while !state.pending.is_empty() || !state.in_flight.is_empty() {
+            state = self.wait(state);
+        }
+        core::mem::take(&mut state.failed)
+    }
+
+    /// Body of a message queued or in flight on `link`.
+    fn message(&self, link: &TangleAddress) -> Option<Vec<u8>> {
+        let state = self.lock();
+        state
+            .pending
+            .iter()
+            .chain(state.in_flight.iter())
+            .find(|(l, _)| l == link)
+            .map(|(_, bytes)| bytes.clone())
+    }
+
+    fn stats(&self) -> SendQueueStats {
+        let state = self.lock();
+        SendQueueStats {
+            queued: state.pending.len(),
+            in_flight: state.in_flight.len(),
+            concurrency: state.limit,
+            depth: self.depth,
+            failed: state.failed.len(),
+            failed_links: state.failed.clone(),
+        }
+    }
+}
+
+/// Executor of `threads` threads for background node requests.
+#[cfg(not(feature = "async"))]
+fn new_executor(threads: usize) -> ThreadPool {
+    ThreadPool::builder()
+        .pool_size(threads)
+        .name_prefix("streams-client-")
+        .create()
+        .unwrap()
+}
+
+#[cfg(not(feature = "async"))]
+lazy_static::lazy_static! {
+    /// Executor shared by the clients of the process without one of their own, created on first use.
+    /// Node requests are blocking with the sync client, so each request in flight occupies a thread.
+    static ref SHARED_EXECUTOR: ThreadPool = new_executor(4 * num_cpus::get());
+}
+
 /// Stub type for iota_client::Client.  Removed: Copy, Default, Clone
 pub struct Client {
     send_opt: SendOptions,
-    client: iota_client::Client,
+    recv_opt: RecvOptions,
+    /// Nodes the requests are routed to, shared by all the clones of this client
+    nodes: Arc<NodePool>,
+    /// Links watched through node events, shared by all the clones of this client
+    #[cfg(feature = "mqtt")]
+    events: Option<Arc<Events>>,
+    /// Queue of sent messages, shared by the clones made after it has been enabled
+    #[cfg(not(feature = "async"))]
+    send_queue: Option<Arc<SendQueue>>,
 }
 
 impl Default for Client {
@@ -198,13 +1048,21 @@ impl Default for Client {
     fn default() -> Self {
         Self {
             send_opt: SendOptions::default(),
-            client: block_on(
-                iota_client::ClientBuilder::new()
-                    .with_node("http://localhost:14265")
-                    .unwrap()
-                    .finish(),
-            )
-            .unwrap(),
+            recv_opt: RecvOptions::default(),
+            nodes: Arc::new(NodePool::new(vec![Node::new(
+                "http://localhost:14265".to_string(),
+                block_on(
+                    iota_client::ClientBuilder::new()
+                        .with_node("http://localhost:14265")
+                        .unwrap()
+                        .finish(),
+                )
+                .unwrap(),
+            )])),
+            #[cfg(feature = "mqtt")]
+            events: None,
+            #[cfg(not(feature = "async"))]
+            send_queue: None,
         }
     }
 }
@@ -212,9 +1070,15 @@ impl Default for Client {
 impl Client {
     // Create an instance of Client with a ready client and its send options
     pub fn new(options: SendOptions, client: iota_client::Client) -> Self {
+        let node = Node::new(options.url.clone(), client);
         Self {
             send_opt: options,
-            client,
+            recv_opt: RecvOptions::default(),
+            nodes: Arc::new(NodePool::new(vec![node])),
+            #[cfg(feature = "mqtt")]
+            events: None,
+            #[cfg(not(feature = "async"))]
+            send_queue: None,
         }
     }
 
@@ -225,30 +1089,197 @@ impl Client {
                 url: url.to_string(),
                 ..Default::default()
             },
-            client: block_on(
-                iota_client::ClientBuilder::new()
-                    .with_node(url)
-                    .unwrap()
-                    .with_local_pow(false)
-                    .finish(),
-            )
-            .unwrap(),
+            recv_opt: RecvOptions::default(),
+            nodes: Arc::new(NodePool::new(vec![Node::new(
+                url.to_string(),
+                block_on(
+                    iota_client::ClientBuilder::new()
+                        .with_node(url)
+                        .unwrap()
+                        .with_local_pow(false)
+                        .finish(),
+                )
+                .unwrap(),
+            )])),
+            #[cfg(feature = "mqtt")]
+            events: None,
+            #[cfg(not(feature = "async"))]
+            send_queue: None,
         }
     }
+
+    /// Create an instance of Client with a pool of nodes pointing to the given URLs. Requests are
+    /// routed to the fastest healthy nodes and reads fail over to the other nodes.
+    pub fn new_from_urls(urls: &[&str]) -> Result<Self> {
+        try_or!(!urls.is_empty(), EmptyNodeList)?;
+        let mut nodes = Vec::with_capacity(urls.len());
+        for url in urls {
+            let builder = handle_client_result(iota_client::ClientBuilder::new().with_node(url))?;
+            let client = handle_client_result(block_on(builder.with_local_pow(false).finish()))?;
+            nodes.push(Node::new(url.to_string(), client));
+        }
+        Ok(Self {
+            send_opt: SendOptions {
+                url: urls[0].to_string(),
+                ..Default::default()
+            },
+            recv_opt: RecvOptions::default(),
+            nodes: Arc::new(NodePool::new(nodes)),
+            #[cfg(feature = "mqtt")]
+            events: None,
+            #[cfg(not(feature = "async"))]
+            send_queue: None,
+        })
+    }
+
+    /// URLs and request statistics of the nodes of this client.
+    pub fn node_stats(&self) -> Vec<(String, NodeStats)> {
+        self.nodes.stats()
+    }
+
+    /// Receive a message for each of the links, fetching them concurrently.
+    async fn recv_batch<F>(&self, links: &[TangleAddress]) -> Vec<Result<TangleMessage<F>>> {
+        #[cfg(feature = "mqtt")]
+        if let Some(events) = &self.events {
+            return events_recv_message_batch(&self.nodes, events, links, self.recv_opt.max_concurrent_fetches).await;
+        }
+        pool_recv_message_batch(&self.nodes, links, self.recv_opt.max_concurrent_fetches).await
+    }
+}
+
+#[cfg(feature = "mqtt")]
+impl Client {
+    /// Switch to push delivery of new messages. Links found without a message when retrieving a
+    /// batch of messages, as done when fetching the next messages of a user, are subscribed to
+    /// through node events. They are retrieved again only once a message is announced on them, and
+    /// every `fallback_interval` regardless in case an event was missed. Clones made afterwards
+    /// share the subscriptions.
+    pub fn enable_events(&mut self, fallback_interval: Duration) {
+        self.events = Some(Arc::new(Events::new(fallback_interval)));
+    }
+
+    /// Block until a message is announced on one of the watched links or the timeout has passed,
+    /// returns whether one was. Returns immediately if events are not enabled.
+    pub fn wait_for_arrival(&self, timeout: Duration) -> bool {
+        match &self.events {
+            Some(events) => {
+                let watched = events.watched.lock().unwrap_or_else(|err| err.into_inner());
+                if watched.values().any(|arrived| *arrived) {
+                    return true;
+                }
+                let (watched, _timeout) = events
+                    .arrival
+                    .wait_timeout(watched, timeout)
+                    .unwrap_or_else(|err| err.into_inner());
+                watched.values().any(|arrived| *arrived)
+            }
+            None => false,
+        }
+    }
+}
+
+#[cfg(not(feature = "async"))]
+impl Client {
+    /// Send messages to the Tangle in the background. Returns immediately with a handle to poll
+    /// for completion of the request.
+    pub fn spawn_send_messages<F>(&self, msgs: Vec<TangleMessage<F>>) -> Request<()>
+    where
+        F: 'static + core::marker::Send + core::marker::Sync,
+    {
+        let nodes = self.nodes.clone();
+        Request::spawn(&nodes.executor(), async move { pool_send_messages(&nodes, msgs).await })
+    }
+
+    /// Retrieve a message from the Tangle in the background. Returns immediately with a handle to
+    /// poll for completion of the request.
+    pub fn spawn_recv_message<F>(&self, link: TangleAddress) -> Request<TangleMessage<F>>
+    where
+        F: 'static + core::marker::Send + core::marker::Sync,
+    {
+        let nodes = self.nodes.clone();
+        let queued = self.queued_message(&link);
+        Request::spawn(&self.nodes.executor(), async move {
+            match queued {
+                Some(msg) => Ok(msg),
+                None => pool_recv_message(&nodes, &link).await,
+            }
+        })
+    }
+
+    /// Run the background requests of this client and its clones on an executor of `threads`
+    /// threads of their own, zero goes back to the executor shared by the process. Node requests
+    /// block with the sync client, so each request in flight occupies a thread: the number of
+    /// threads bounds the sends and fetches in flight, whatever their concurrency options.
+    pub fn set_executor_threads(&self, threads: usize) {
+        let executor = match threads {
+            0 => SHARED_EXECUTOR.clone(),
+            threads => new_executor(threads),
+        };
+        self.nodes.set_executor(executor);
+    }
+
+    /// Queue sent messages and submit them in the background. Sends return as soon as the message
+    /// is queued, blocking while `options.depth` messages are queued or in flight, and the links of
+    /// failed submissions are returned by `flush_sends`. Reads of this client and its clones serve
+    /// queued messages until their submission completes, reads through other clients only see them
+    /// once submitted. Messages queued before are flushed first, their failures are kept.
+    pub fn enable_send_queue(&mut self, options: SendQueueOptions) -> Result<()> {
+        let failed = self.flush_sends();
+        self.send_queue = Some(Arc::new(SendQueue::new(options, self.nodes.clone(), failed)));
+        Ok(())
+    }
+
+    /// Block until all queued messages have been submitted, returns the links of the messages
+    /// whose submission has failed since the last flush. Failed messages are not sent again: they
+    /// are not idempotent, a node may have attached a message whose submission timed out.
+    pub fn flush_sends(&self) -> Vec<TangleAddress> {
+        self.send_queue.as_ref().map_or(Vec::new(), |queue| queue.flush())
+    }
+
+    /// Message queued for sending on `link`, not yet submitted.
+    fn queued_message<F>(&self, link: &TangleAddress) -> Option<TangleMessage<F>> {
+        let bytes = self.send_queue.as_ref()?.message(link)?;
+        let binary = BinaryMessage::new(link.clone(), TangleAddress::default(), bytes.into());
+        Some(TangleMessage { binary, timestamp: 0 })
+    }
+
+    /// Receive a message for each of the links, serving the messages queued for sending from the
+    /// queue and fetching the others concurrently.
+    async fn recv_batch_queued<F>(&self, links: &[TangleAddress]) -> Vec<Result<TangleMessage<F>>> {
+        let queued: Vec<Option<TangleMessage<F>>> = links.iter().map(|link| self.queued_message(link)).collect();
+        if queued.iter().all(Option::is_none) {
+            return self.recv_batch(links).await;
+        }
+        let missing: Vec<TangleAddress> = links
+            .iter()
+            .zip(&queued)
+            .filter(|(_, msg)| msg.is_none())
+            .map(|(link, _)| link.clone())
+            .collect();
+        let mut fetched = self.recv_batch(&missing).await.into_iter();
+        queued
+            .into_iter()
+            .map(|msg| msg.map_or_else(|| fetched.next().unwrap(), Ok))
+            .collect()
+    }
+
+    /// State of the send queue, `None` unless it is enabled.
+    pub fn send_queue_stats(&self) -> Option<SendQueueStats> {
+        self.send_queue.as_ref().map(|queue| queue.stats())
+    }
 }
 
+/// Clones share the nodes and their connections, options are copied.
 impl Clone for Client {
     fn clone(&self) -> Self {
         Self {
             send_opt: self.send_opt.clone(),
-            client: block_on(
-                iota_client::ClientBuilder::new()
-                    .with_node(&self.send_opt.url)
-                    .unwrap()
-                    .with_local_pow(self.send_opt.local_pow)
-                    .finish(),
-            )
-            .unwrap(),
+            recv_opt: self.recv_opt.clone(),
+            nodes: self.nodes.clone(),
+            #[cfg(feature = "mqtt")]
+            events: self.events.clone(),
+            #[cfg(not(feature = "async"))]
+            send_queue: self.send_queue.clone(),
         }
     }
 }
@@ -265,29 +1296,85 @@ impl TransportOptions for Client {
         // self.client.set_send_options()
     }
 
-    type RecvOptions = ();
-    fn get_recv_options(&self) {}
-    fn set_recv_options(&mut self, _opt: ()) {}
+    type RecvOptions = RecvOptions;
+    fn get_recv_options(&self) -> RecvOptions {
+        self.recv_opt.clone()
+    }
+    fn set_recv_options(&mut self, opt: RecvOptions) {
+        self.recv_opt = opt;
+    }
 }
 
 #[cfg(not(feature = "async"))]
 impl TransportDetails<TangleAddress> for Client {
     type Details = Details;
     fn get_link_details(&mut self, link: &TangleAddress) -> Result<Self::Details> {
-        sync_get_link_details(&self.client, link)
+        block_on(pool_get_link_details(&self.nodes, link))
     }
 }
 
 #[cfg(not(feature = "async"))]
-impl<F> Transport<TangleAddress, TangleMessage<F>> for Client {
+impl<F> Transport<TangleAddress, TangleMessage<F>> for Client
+where
+    F: 'static + core::marker::Send + core::marker::Sync,
+{
     /// Send a Streams message over the Tangle with the current timestamp and default SendOptions.
     fn send_message(&mut self, msg: &TangleMessage<F>) -> Result<()> {
-        sync_send_message_with_options(&self.client, msg)
+        match &self.send_queue {
+            Some(queue) => {
+                queue.push(msg.binary.link.clone(), msg.binary.body.bytes.clone());
+                Ok(())
+            }
+            None => block_on(pool_send_message(&self.nodes, msg)),
+        }
     }
 
-    /// Receive a message.
+    /// Send a Streams message over the Tangle, moving its body into the node request.
+    fn send_owned_message(&mut self, msg: TangleMessage<F>) -> Result<()> {
+        match &self.send_queue {
+            Some(queue) => {
+                queue.push(msg.binary.link, msg.binary.body.bytes);
+                Ok(())
+            }
+            None => block_on(pool_send_owned_message(&self.nodes, msg)),
+        }
+    }
+
+    /// Send a batch of Streams messages over the Tangle, submitting them concurrently on the
+    /// executor of the client.
+    fn send_messages(&mut self, msgs: Vec<TangleMessage<F>>) -> Result<()> {
+        match &self.send_queue {
+            Some(queue) => {
+                for msg in msgs {
+                    queue.push(msg.binary.link, msg.binary.body.bytes);
+                }
+                Ok(())
+            }
+            None => block_on(pool_send_messages(&self.nodes, msgs)),
+        }
+    }
+
+    /// Receive a message, a message still queued for sending is served from the queue.
     fn recv_messages(&mut self, link: &TangleAddress) -> Result<Vec<TangleMessage<F>>> {
-        sync_recv_messages(&self.client, link)
+        match self.queued_message(link) {
+            Some(msg) => Ok(vec![msg]),
+            None => block_on(pool_recv_messages(&self.nodes, link)),
+        }
+    }
+
+    /// Receive a message for each of the links, fetching them concurrently.
+    fn recv_message_batch(&mut self, links: &[TangleAddress]) -> Vec<Result<TangleMessage<F>>> {
+        block_on(self.recv_batch_queued(links))
+    }
+
+    /// Receive a message for each of the links on the executor of the client.
+    fn spawn_recv_message_batch(&mut self, links: Vec<TangleAddress>, done: BatchCallback<TangleMessage<F>>) -> bool {
+        let client = self.clone();
+        self.nodes.executor().spawn_ok(async move {
+            let msgs = client.recv_batch_queued(&links).await;
+            done(msgs);
+        });
+        true
     }
 }
 
@@ -299,12 +1386,22 @@ where
 {
     /// Send a Streams message over the Tangle with the current timestamp and default SendOptions.
     async fn send_message(&mut self, msg: &TangleMessage<F>) -> Result<()> {
-        async_send_message_with_options(&self.client, msg).await
+        pool_send_message(&self.nodes, msg).await
+    }
+
+    /// Send a Streams message over the Tangle, moving its body into the node request.
+    async fn send_owned_message(&mut self, msg: TangleMessage<F>) -> Result<()> {
+        pool_send_owned_message(&self.nodes, msg).await
+    }
+
+    /// Send a batch of Streams messages over the Tangle, submitting them concurrently.
+    async fn send_messages(&mut self, msgs: Vec<TangleMessage<F>>) -> Result<()> {
+        pool_send_messages(&self.nodes, msgs).await
     }
 
     /// Receive a message.
     async fn recv_messages(&mut self, link: &TangleAddress) -> Result<Vec<TangleMessage<F>>> {
-        async_recv_messages(&self.client, link).await
+        pool_recv_messages(&self.nodes, link).await
     }
 
     async fn recv_message(&mut self, link: &TangleAddress) -> Result<TangleMessage<F>> {
@@ -316,6 +1413,11 @@ where
             err!(MessageLinkNotFound(link.to_string()))
         }
     }
+
+    /// Receive a message for each of the links, fetching them concurrently.
+    async fn recv_message_batch(&mut self, links: &[TangleAddress]) -> Vec<Result<TangleMessage<F>>> {
+        self.recv_batch(links).await
+    }
 }
 
 #[cfg(feature = "async")]
@@ -323,7 +1425,7 @@ where
 impl TransportDetails<TangleAddress> for Client {
     type Details = Details;
     async fn get_link_details(&mut self, link: &TangleAddress) -> Result<Self::Details> {
-        async_get_link_details(&self.client, link).await
+        pool_get_link_details(&self.nodes, link).await
     }
 }
 
@@ -333,7 +1435,7 @@ impl TransportDetails<TangleAddress> for Rc<RefCell<Client>> {
     type Details = Details;
     async fn get_link_details(&mut self, link: &TangleAddress) -> Result<Self::Details> {
         match (&*self).try_borrow_mut() {
-            Ok(tsp) => async_get_link_details(&tsp.client, link).await,
+            Ok(tsp) => pool_get_link_details(&tsp.nodes, link).await,
             Err(err) => Err(wrapped_err!(TransportNotAvailable, WrappedError(err))),
         }
     }
@@ -349,7 +1451,23 @@ where
     /// Send a Streams message over the Tangle with the current timestamp and default SendOptions.
     async fn send_message(&mut self, msg: &TangleMessage<F>) -> Result<()> {
         match (&*self).try_borrow_mut() {
-            Ok(tsp) => async_send_message_with_options(&tsp.client, msg).await,
+            Ok(tsp) => pool_send_message(&tsp.nodes, msg).await,
+            Err(_err) => err!(TransportNotAvailable),
+        }
+    }
+
+    /// Send a Streams message over the Tangle, moving its body into the node request.
+    async fn send_owned_message(&mut self, msg: TangleMessage<F>) -> Result<()> {
+        match (&*self).try_borrow_mut() {
+            Ok(tsp) => pool_send_owned_message(&tsp.nodes, msg).await,
+            Err(_err) => err!(TransportNotAvailable),
+        }
+    }
+
+    /// Send a batch of Streams messages over the Tangle, submitting them concurrently.
+    async fn send_messages(&mut self, msgs: Vec<TangleMessage<F>>) -> Result<()> {
+        match (&*self).try_borrow_mut() {
+            Ok(tsp) => pool_send_messages(&tsp.nodes, msgs).await,
             Err(_err) => err!(TransportNotAvailable),
         }
     }
@@ -357,7 +1475,7 @@ where
     /// Receive a message.
     async fn recv_messages(&mut self, link: &TangleAddress) -> Result<Vec<TangleMessage<F>>> {
         match (&*self).try_borrow_mut() {
-            Ok(tsp) => async_recv_messages(&tsp.client, link).await,
+            Ok(tsp) => pool_recv_messages(&tsp.nodes, link).await,
             Err(_err) => err!(TransportNotAvailable),
         }
     }
@@ -365,7 +1483,7 @@ where
     async fn recv_message(&mut self, link: &TangleAddress) -> Result<TangleMessage<F>> {
         match (&*self).try_borrow_mut() {
             Ok(tsp) => {
-                let mut msgs = async_recv_messages(&tsp.client, link).await?;
+                let mut msgs = pool_recv_messages(&tsp.nodes, link).await?;
                 if let Some(msg) = msgs.pop() {
                     try_or!(msgs.is_empty(), MessageNotUnique(link.msgid.to_string()))?;
                     Ok(msg)
@@ -376,4 +1494,37 @@ where
             Err(_err) => err!(TransportNotAvailable),
         }
     }
+
+    /// Receive a message for each of the links, fetching them concurrently.
+    async fn recv_message_batch(&mut self, links: &[TangleAddress]) -> Vec<Result<TangleMessage<F>>> {
+        match (&*self).try_borrow_mut() {
+            Ok(tsp) => tsp.recv_batch(links).await,
+            Err(_err) => links.iter().map(|_| err!(TransportNotAvailable)).collect(),
+        }
+    }
+}
+
+#[cfg(all(test, not(feature = "async")))]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn detached_batch_overlaps_blocking_requests() {
+        // Requests block the thread polling them, as those of the sync client do
+        let delay = std::time::Duration::from_millis(100);
+        let requests = (0..8_usize).map(|i| async move {
+            std::thread::sleep(delay);
+            Ok(i)
+        });
+        let start = Instant::now();
+        let results: Vec<usize> = block_on(detached_batch(&NodePool::new(Vec::new()), requests, 4))
+            .into_iter()
+            .collect::<Result<_>>()
+            .unwrap();
+        let elapsed = start.elapsed();
+        assert_eq!(results, (0..8).collect::<Vec<_>>());
+        // Eight requests four at a time take two delays, one after the other would take eight
+        assert!(elapsed >= 2 * delay);
+        assert!(elapsed < 4 * delay, "requests did not overlap: {:?}", elapsed);
+    }
 }
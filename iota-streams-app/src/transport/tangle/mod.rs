@@ -186,6 +186,38 @@ pub fn get_hash(tx_address: &[u8], tx_tag: &[u8]) -> Result<String> {
     Ok(hex::encode(&hash))
 }
 
+/// Size of a link in binary form: application instance followed by message id.
+pub const ADDRESS_SIZE: usize = APPINST_SIZE + MSGID_SIZE;
+
+/// Size of the hex encoded Tangle index of a link.
+pub const INDEX_HEX_SIZE: usize = 64;
+
+impl TangleAddress {
+    /// Write the binary form of the link into the first `ADDRESS_SIZE` bytes of `buf`.
+    pub fn write_bytes(&self, buf: &mut [u8; ADDRESS_SIZE]) {
+        buf[..APPINST_SIZE].copy_from_slice(self.appinst.as_ref());
+        buf[APPINST_SIZE..].copy_from_slice(self.msgid.as_ref());
+    }
+
+    /// Read a link from its binary form.
+    pub fn read_bytes(bytes: &[u8; ADDRESS_SIZE]) -> Self {
+        Self::new(
+            AppInst::from(&bytes[..APPINST_SIZE]),
+            MsgId::from(&bytes[APPINST_SIZE..]),
+        )
+    }
+
+    /// Write the hex encoded Tangle index of the link, as returned by `get_hash`, without allocating.
+    pub fn write_index_hex(&self, buf: &mut [u8; INDEX_HEX_SIZE]) {
+        let hash = blake2b::Blake2b256::new()
+            .chain(self.appinst.as_ref())
+            .chain(self.msgid.as_ref())
+            .finalize();
+        // Cannot fail, the buffer is exactly twice the size of the hash
+        let _ = hex::encode_to_slice(&hash, buf);
+    }
+}
+
 impl fmt::Display for TangleAddress {
     fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
         let hash = get_hash(self.appinst.as_ref(), self.msgid.as_ref()).unwrap_or_default();
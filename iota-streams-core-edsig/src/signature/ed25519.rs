@@ -13,6 +13,24 @@ use core::hash::{
     Hasher,
 };
 
+use curve25519_dalek::{
+    constants,
+    edwards::{
+        CompressedEdwardsY,
+        EdwardsPoint,
+    },
+    scalar::Scalar,
+    traits::{
+        IsIdentity,
+        VartimeMultiscalarMul,
+    },
+};
+use iota_streams_core::prelude::{
+    digest::Digest,
+    Vec,
+};
+use sha2::Sha512;
+
 pub type IPk<'a> = &'a PublicKey;
 
 #[derive(Copy, Clone, Default, Eq)]
@@ -51,3 +69,139 @@ impl<'a> From<&'a mut PublicKey> for &'a mut PublicKeyWrap {
         unsafe { &mut *(ptr as *mut PublicKeyWrap) }
     }
 }
+
+/// Verify a batch of Ed25519ph signatures over 64-byte prehashed messages with the same
+/// `context`. Returns `true` only if all the signatures are valid; on `false` signatures
+/// should be checked one by one with `PublicKey::verify_prehashed` to find the invalid ones.
+///
+/// Batch coefficients are derived from the whole batch instead of a random generator, so a
+/// signer can not choose signatures that cancel each other out.
+///
+/// The batch equation is cofactored while `verify_prehashed` is not, they only agree on points
+/// without a small order component. Batches with a non-canonical `R` or with an `R` or a public
+/// key having such a component are not checked and yield `false`.
+pub fn verify_prehashed_batch(context: &[u8], batch: &[(&PublicKey, &[u8; 64], &Signature)]) -> bool {
+    if batch.is_empty() {
+        return true;
+    }
+    if context.len() > 255 {
+        return false;
+    }
+
+    let mut points = Vec::with_capacity(2 * batch.len() + 1);
+    let mut hrams = Vec::with_capacity(batch.len());
+    let mut ss = Vec::with_capacity(batch.len());
+    let mut transcript = Sha512::new();
+    points.push(Some(constants::ED25519_BASEPOINT_POINT));
+    for (pk, prehashed, signature) in batch {
+        let bytes = signature.to_bytes();
+        let mut r_bytes = [0_u8; 32];
+        let mut s_bytes = [0_u8; 32];
+        r_bytes.copy_from_slice(&bytes[..32]);
+        s_bytes.copy_from_slice(&bytes[32..]);
+        let s = match Scalar::from_canonical_bytes(s_bytes) {
+            Some(s) => s,
+            None => return false,
+        };
+
+        let r = match CompressedEdwardsY(r_bytes).decompress() {
+            Some(r) if r.compress().0 == r_bytes && r.is_torsion_free() => r,
+            _ => return false,
+        };
+
+        hrams.push(hram(context, &r_bytes, pk, prehashed));
+        ss.push(s);
+
+        transcript.update(&bytes[..]);
+        transcript.update(pk.as_bytes());
+        transcript.update(&prehashed[..]);
+        points.push(r);
+    }
+    for (pk, _, _) in batch {
+        match CompressedEdwardsY(*pk.as_bytes()).decompress() {
+            Some(a) if a.is_torsion_free() => points.push(a),
+            _ => return false,
+        }
+    }
+
+    let seed = transcript.finalize();
+    let zs: Vec<Scalar> = (0..batch.len() as u64)
+        .map(|i| {
+            let mut z = [0_u8; 32];
+            let hash = Sha512::new().chain(&seed).chain(&i.to_be_bytes()).finalize();
+            z[..16].copy_from_slice(&hash[..16]);
+            Scalar::from_bits(z)
+        })
+        .collect();
+
+    let b: Scalar = zs.iter().zip(ss.iter()).map(|(z, s)| z * s).sum();
+    let scalars = core::iter::once(-b)
+        .chain(zs.iter().cloned())
+        .chain(zs.iter().zip(hrams.iter()).map(|(z, hram)| z * hram));
+    EdwardsPoint::vartime_multiscalar_mul(scalars, points)
+        .mul_by_cofactor()
+        .is_identity()
+}
+
+/// Challenge of an Ed25519ph signature, as computed by `PublicKey::verify_prehashed`.
+fn hram(context: &[u8], r_bytes: &[u8; 32], pk: &PublicKey, prehashed: &[u8; 64]) -> Scalar {
+    let mut h = Sha512::new();
+    h.update(b"SigEd25519 no Ed25519 collisions");
+    h.update(&[1_u8]);
+    h.update(&[context.len() as u8]);
+    h.update(context);
+    h.update(r_bytes);
+    h.update(pk.as_bytes());
+    h.update(&prehashed[..]);
+    Scalar::from_hash(h)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const CONTEXT: &[u8] = b"IOTAStreams";
+
+    /// Sign with secret scalar `a` and nonce `r`, adding `torsion` to the nonce point.
+    fn sign(a: &Scalar, r: &Scalar, torsion: &EdwardsPoint, prehashed: &[u8; 64]) -> (PublicKey, Signature) {
+        let pk = PublicKey::from_bytes((a * constants::ED25519_BASEPOINT_POINT).compress().as_bytes()).unwrap();
+        let r_bytes = (r * constants::ED25519_BASEPOINT_POINT + torsion).compress().0;
+        let s = r + hram(CONTEXT, &r_bytes, &pk, prehashed) * a;
+        let mut bytes = [0_u8; SIGNATURE_LENGTH];
+        bytes[..32].copy_from_slice(&r_bytes);
+        bytes[32..].copy_from_slice(s.as_bytes());
+        (pk, Signature::new(bytes))
+    }
+
+    fn verify_single(pk: &PublicKey, message: &[u8], signature: &Signature) -> bool {
+        let prehashed = Sha512::new().chain(message);
+        pk.verify_prehashed(prehashed, Some(CONTEXT), signature).is_ok()
+    }
+
+    fn verify_batch(pk: &PublicKey, message: &[u8], signature: &Signature) -> bool {
+        let mut prehashed = [0_u8; 64];
+        prehashed.copy_from_slice(&Sha512::new().chain(message).finalize());
+        verify_prehashed_batch(CONTEXT, &[(pk, &prehashed, signature)])
+    }
+
+    #[test]
+    fn test_batch_agrees_with_single() {
+        let message = b"batch";
+        let mut prehashed = [0_u8; 64];
+        prehashed.copy_from_slice(&Sha512::new().chain(&message[..]).finalize());
+        let a = Scalar::from_bytes_mod_order([7_u8; 32]);
+        let r = Scalar::from_bytes_mod_order([11_u8; 32]);
+
+        let (pk, signature) = sign(&a, &r, &constants::EIGHT_TORSION[0], &prehashed);
+        assert!(verify_single(&pk, message, &signature));
+        assert!(verify_batch(&pk, message, &signature));
+
+        // A small order component in R is cancelled by the cofactor, the batch must not accept
+        // what a single verification rejects.
+        for torsion in &constants::EIGHT_TORSION[1..] {
+            let (pk, signature) = sign(&a, &r, torsion, &prehashed);
+            assert!(!verify_single(&pk, message, &signature));
+            assert!(!verify_batch(&pk, message, &signature));
+        }
+    }
+}
@@ -2,15 +2,27 @@
 extern crate criterion;
 
 use criterion::Criterion;
-use iota_streams_core_keccak::sponge::prp::keccak::KeccakF1600B;
+use iota_streams_core_keccak::sponge::prp::keccak::KeccakF1600;
 
 fn keccakf1600_benchmark(c: &mut Criterion) {
-    let mut keccak = KeccakF1600B::default();
+    let mut keccak = KeccakF1600::default();
     c.bench_function("Run KeccakF1600 transform", move |b| {
         b.iter(|| {
             keccak.permutation();
         })
     });
+
+    let mut keccak4 = [
+        KeccakF1600::default(),
+        KeccakF1600::default(),
+        KeccakF1600::default(),
+        KeccakF1600::default(),
+    ];
+    c.bench_function("Run KeccakF1600 transform x4", move |b| {
+        b.iter(|| {
+            KeccakF1600::permutation_x4(&mut keccak4);
+        })
+    });
 }
 
 criterion_group!(benches, keccakf1600_benchmark);
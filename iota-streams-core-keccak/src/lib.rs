@@ -1,3 +1,6 @@
 #![no_std]
 
+#[cfg(feature = "std")]
+extern crate std;
+
 pub mod sponge;
@@ -24,6 +24,137 @@ impl KeccakF1600 {
     pub fn permutation(&mut self) {
         keccak::f1600(&mut self.state);
     }
+
+    /// Apply the permutation to four independent states in one pass. The AVX2 backend is picked at
+    /// runtime with `std`, or at compile time with the `avx2` target feature; otherwise each state is
+    /// permuted in turn.
+    pub fn permutation_x4(states: &mut [Self; 4]) {
+        #[cfg(target_arch = "x86_64")]
+        {
+            if avx2::is_available() {
+                let [s0, s1, s2, s3] = states;
+                unsafe {
+                    avx2::f1600_x4([&mut s0.state, &mut s1.state, &mut s2.state, &mut s3.state]);
+                }
+                return;
+            }
+        }
+        for s in states.iter_mut() {
+            s.permutation();
+        }
+    }
+}
+
+/// Multi-buffer Keccak-f[1600]: lane `i` of four states is held in one 256-bit register.
+#[cfg(target_arch = "x86_64")]
+mod avx2 {
+    use core::arch::x86_64::*;
+
+    const ROUND_CONSTANTS: [u64; 24] = [
+        0x0000000000000001,
+        0x0000000000008082,
+        0x800000000000808a,
+        0x8000000080008000,
+        0x000000000000808b,
+        0x0000000080000001,
+        0x8000000080008081,
+        0x8000000000008009,
+        0x000000000000008a,
+        0x0000000000000088,
+        0x0000000080008009,
+        0x000000008000000a,
+        0x000000008000808b,
+        0x800000000000008b,
+        0x8000000000008089,
+        0x8000000000008003,
+        0x8000000000008002,
+        0x8000000000000080,
+        0x000000000000800a,
+        0x800000008000000a,
+        0x8000000080008081,
+        0x8000000000008080,
+        0x0000000080000001,
+        0x8000000080008008,
+    ];
+
+    // Rotation offsets of lane `x + 5 * y`.
+    const RHO: [i64; 25] = [
+        0, 1, 62, 28, 27, 36, 44, 6, 55, 20, 3, 10, 43, 25, 39, 41, 45, 15, 21, 8, 18, 2, 61, 56, 14,
+    ];
+
+    #[cfg(feature = "std")]
+    pub fn is_available() -> bool {
+        std::is_x86_feature_detected!("avx2")
+    }
+
+    #[cfg(not(feature = "std"))]
+    pub fn is_available() -> bool {
+        cfg!(target_feature = "avx2")
+    }
+
+    #[inline(always)]
+    unsafe fn rol(x: __m256i, n: i64) -> __m256i {
+        _mm256_or_si256(
+            _mm256_sll_epi64(x, _mm_cvtsi64_si128(n)),
+            _mm256_srl_epi64(x, _mm_cvtsi64_si128(64 - n)),
+        )
+    }
+
+    #[target_feature(enable = "avx2")]
+    pub unsafe fn f1600_x4(mut states: [&mut [u64; 25]; 4]) {
+        let mut a = [_mm256_setzero_si256(); 25];
+        for (i, ai) in a.iter_mut().enumerate() {
+            *ai = _mm256_set_epi64x(
+                states[3][i] as i64,
+                states[2][i] as i64,
+                states[1][i] as i64,
+                states[0][i] as i64,
+            );
+        }
+
+        let mut b = [_mm256_setzero_si256(); 25];
+        for rc in ROUND_CONSTANTS.iter() {
+            // theta
+            let mut c = [_mm256_setzero_si256(); 5];
+            for (x, cx) in c.iter_mut().enumerate() {
+                *cx = _mm256_xor_si256(
+                    _mm256_xor_si256(_mm256_xor_si256(a[x], a[x + 5]), _mm256_xor_si256(a[x + 10], a[x + 15])),
+                    a[x + 20],
+                );
+            }
+            for x in 0..5 {
+                let d = _mm256_xor_si256(c[(x + 4) % 5], rol(c[(x + 1) % 5], 1));
+                for y in 0..5 {
+                    a[x + 5 * y] = _mm256_xor_si256(a[x + 5 * y], d);
+                }
+            }
+            // rho and pi
+            for x in 0..5 {
+                for y in 0..5 {
+                    b[y + 5 * ((2 * x + 3 * y) % 5)] = rol(a[x + 5 * y], RHO[x + 5 * y]);
+                }
+            }
+            // chi
+            for y in 0..5 {
+                for x in 0..5 {
+                    a[x + 5 * y] = _mm256_xor_si256(
+                        b[x + 5 * y],
+                        _mm256_andnot_si256(b[(x + 1) % 5 + 5 * y], b[(x + 2) % 5 + 5 * y]),
+                    );
+                }
+            }
+            // iota
+            a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x(*rc as i64));
+        }
+
+        let mut lanes = [0_u64; 4];
+        for (i, ai) in a.iter().enumerate() {
+            _mm256_storeu_si256(lanes.as_mut_ptr() as *mut __m256i, *ai);
+            for (s, l) in states.iter_mut().zip(lanes.iter()) {
+                s[i] = *l;
+            }
+        }
+    }
 }
 
 impl PRP for KeccakF1600 {
@@ -26,3 +26,27 @@ fn encrypt_decrypt_keccak_byte() {
     encrypt_decrypt_n::<KeccakF1600>(rate + 28);
     encrypt_decrypt_n::<KeccakF1600>(2 * rate);
 }
+
+#[test]
+fn permutation_x4_matches_permutation() {
+    let mut states = [
+        KeccakF1600::default(),
+        KeccakF1600::default(),
+        KeccakF1600::default(),
+        KeccakF1600::default(),
+    ];
+    for (i, s) in states.iter_mut().enumerate() {
+        for (j, b) in s.outer_mut().iter_mut().enumerate() {
+            *b = (i * 31 + j) as u8;
+        }
+    }
+    let mut expected = states.clone();
+    for s in expected.iter_mut() {
+        s.permutation();
+    }
+    KeccakF1600::permutation_x4(&mut states);
+    for (s, e) in states.iter().zip(expected.iter()) {
+        assert_eq!(s.outer(), e.outer());
+        assert_eq!(s.inner(), e.inner());
+    }
+}
@@ -58,6 +58,10 @@ pub enum Errors {
     OutputStreamNotFullyConsumed(usize),
     /// Input stream has not been exhausted. Remaining: {0}
     InputStreamNotFullyConsumed(usize),
+    /// Output stream sink failed to take {0} bytes
+    StreamSinkFailure(usize),
+    /// Input stream source failed to provide bytes
+    StreamSourceFailure,
 
     //////////
     // Generic Transport
@@ -70,6 +74,10 @@ pub enum Errors {
     MessageLinkNotFoundInTangle(String),
     /// Transport object is already borrowed
     TransportNotAvailable,
+    /// Message cache file {0} could not be accessed
+    CacheFileFailure(String),
+    /// Message cache file is corrupted
+    BadCacheFile,
 
     //////////
     // Iota Client
@@ -94,6 +102,8 @@ pub enum Errors {
     MessageBuildFailure,
     /// Iota Client failed to perform operation.
     ClientOperationFailure,
+    /// Client requires at least one node
+    EmptyNodeList,
 
     //////////
     // Messages
@@ -134,6 +144,8 @@ pub enum Errors {
     StateStoreFailure,
     /// Cannot generate new channel, it may already exists. please try using a different seed
     ChannelDuplication,
+    /// A thread unwrapping a batch of packets has panicked
+    UnwrapWorkerPanicked,
 
     //////////
     // User Recovery
@@ -142,10 +154,20 @@ pub enum Errors {
     AppInstRecoveryFailure(u8),
     /// Author signature pubkey recovery failed (expected: 0 | 1, found: {0})
     AuthorSigPkRecoveryFailure(u8),
+    /// Keyload key recovery failed (expected: 0 | 1, found: {0})
+    KeyloadKeyRecoveryFailure(u8),
     /// User Version does not match (expected: {0}, found: {1}
     UserVersionRecoveryFailure(u8, u8),
     /// Recovered flag does not match expected: flag (expected: {0}, found: {1})
     UserFlagRecoveryFailure(u8, u8),
+    /// Checkpoint does not belong to the user generated from the seed
+    UserCheckpointMismatch,
+    /// User state journal file {0} could not be accessed
+    StateJournalFailure(String),
+    /// User state journal file {0} is corrupted
+    BadStateJournal(String),
+    /// User state journal record is out of order (expected: {0}, found: {1})
+    StateJournalRecordMismatch(u64, u64),
 
     //////////
     // Examples
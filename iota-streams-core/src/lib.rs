@@ -46,6 +46,41 @@ pub const LOCATION_LOG: bool = false;
 #[cfg(feature = "err-location-log")]
 pub const LOCATION_LOG: bool = true;
 
+/// Time the evaluation of `$e` as a run of phase `metrics::Phase::$phase`.
+#[cfg(feature = "metrics")]
+#[macro_export]
+macro_rules! metrics_time {
+    ($phase:ident, $e:expr) => {{
+        let _timer = $crate::metrics::Timer::start($crate::metrics::Phase::$phase);
+        $e
+    }};
+}
+
+#[cfg(not(feature = "metrics"))]
+#[macro_export]
+macro_rules! metrics_time {
+    ($phase:ident, $e:expr) => {
+        $e
+    };
+}
+
+/// Add `$n` to counter `metrics::Counter::$counter`, `$n` is not evaluated without `metrics`.
+#[cfg(feature = "metrics")]
+#[macro_export]
+macro_rules! metrics_add {
+    ($counter:ident, $n:expr) => {
+        $crate::metrics::add($crate::metrics::Counter::$counter, ($n) as u64)
+    };
+}
+
+#[cfg(not(feature = "metrics"))]
+#[macro_export]
+macro_rules! metrics_add {
+    ($counter:ident, $n:expr) => {
+        ()
+    };
+}
+
 pub use anyhow::{
     anyhow,
     bail,
@@ -55,6 +90,8 @@ pub use anyhow::{
 };
 
 pub mod errors;
+#[cfg(feature = "metrics")]
+pub mod metrics;
 pub mod prelude;
 pub mod prng;
 pub mod psk;
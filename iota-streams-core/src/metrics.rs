@@ -0,0 +1,158 @@
+//! Timers and counters of the hot paths, compiled in with the `metrics` feature.
+//!
+//! Phases are timed with `metrics_time!` and events are counted with `metrics_add!`. Without the feature both macros
+//! expand to the bare expression, resp. to nothing, so instrumented code carries no cost. Figures are process wide
+//! and kept in relaxed atomics; phases may nest, eg. unwrapping a signed packet includes its verification.
+
+use core::sync::atomic::{
+    AtomicU64,
+    Ordering,
+};
+use std::time::Instant;
+
+/// Timed phase of message processing.
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+pub enum Phase {
+    /// Wrapping of a message, including signing
+    Wrap,
+    /// Ed25519 signing
+    Sign,
+    /// Submission of a message to a node
+    Send,
+    /// Lookup of the message ids at an index
+    IndexLookup,
+    /// Retrieval of message data from a node
+    Fetch,
+    /// Unwrapping of a message, including verification of a signature checked inline
+    Unwrap,
+    /// Ed25519 verification, single or batched
+    Verify,
+}
+
+/// Counted event.
+#[derive(Clone, Copy, PartialEq, Eq, Debug)]
+pub enum Counter {
+    CacheHit,
+    CacheMiss,
+    BytesIn,
+    BytesOut,
+}
+
+const PHASES: usize = 7;
+const COUNTERS: usize = 4;
+
+struct PhaseCell {
+    calls: AtomicU64,
+    total_ns: AtomicU64,
+    max_ns: AtomicU64,
+}
+
+impl PhaseCell {
+    const fn new() -> Self {
+        Self {
+            calls: AtomicU64::new(0),
+            total_ns: AtomicU64::new(0),
+            max_ns: AtomicU64::new(0),
+        }
+    }
+}
+
+static PHASE_CELLS: [PhaseCell; PHASES] = [
+    PhaseCell::new(),
+    PhaseCell::new(),
+    PhaseCell::new(),
+    PhaseCell::new(),
+    PhaseCell::new(),
+    PhaseCell::new(),
+    PhaseCell::new(),
+];
+
+static COUNTER_CELLS: [AtomicU64; COUNTERS] = [
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+];
+
+/// Figures of a phase since the last reset.
+#[derive(Clone, Copy, Default, PartialEq, Eq, Debug)]
+pub struct PhaseStats {
+    pub calls: u64,
+    pub total_ns: u64,
+    pub max_ns: u64,
+}
+
+/// Figures of all phases and counters at one point in time.
+#[derive(Clone, Copy, Default, PartialEq, Eq, Debug)]
+pub struct Snapshot {
+    phases: [PhaseStats; PHASES],
+    counters: [u64; COUNTERS],
+}
+
+impl Snapshot {
+    pub fn phase(&self, phase: Phase) -> PhaseStats {
+        self.phases[phase as usize]
+    }
+
+    pub fn counter(&self, counter: Counter) -> u64 {
+        self.counters[counter as usize]
+    }
+}
+
+/// Record a run of `phase` taking `ns` nanoseconds.
+pub fn record(phase: Phase, ns: u64) {
+    let cell = &PHASE_CELLS[phase as usize];
+    cell.calls.fetch_add(1, Ordering::Relaxed);
+    cell.total_ns.fetch_add(ns, Ordering::Relaxed);
+    cell.max_ns.fetch_max(ns, Ordering::Relaxed);
+}
+
+pub fn add(counter: Counter, n: u64) {
+    COUNTER_CELLS[counter as usize].fetch_add(n, Ordering::Relaxed);
+}
+
+/// Read all figures. Figures recorded concurrently may or may not be included.
+pub fn snapshot() -> Snapshot {
+    let mut snapshot = Snapshot::default();
+    for (stats, cell) in snapshot.phases.iter_mut().zip(PHASE_CELLS.iter()) {
+        stats.calls = cell.calls.load(Ordering::Relaxed);
+        stats.total_ns = cell.total_ns.load(Ordering::Relaxed);
+        stats.max_ns = cell.max_ns.load(Ordering::Relaxed);
+    }
+    for (value, cell) in snapshot.counters.iter_mut().zip(COUNTER_CELLS.iter()) {
+        *value = cell.load(Ordering::Relaxed);
+    }
+    snapshot
+}
+
+pub fn reset() {
+    for cell in PHASE_CELLS.iter() {
+        cell.calls.store(0, Ordering::Relaxed);
+        cell.total_ns.store(0, Ordering::Relaxed);
+        cell.max_ns.store(0, Ordering::Relaxed);
+    }
+    for cell in COUNTER_CELLS.iter() {
+        cell.store(0, Ordering::Relaxed);
+    }
+}
+
+/// Times a phase until dropped, see `metrics_time!`.
+pub struct Timer {
+    phase: Phase,
+    start: Instant,
+}
+
+impl Timer {
+    pub fn start(phase: Phase) -> Self {
+        Self {
+            phase,
+            start: Instant::now(),
+        }
+    }
+}
+
+impl Drop for Timer {
+    fn drop(&mut self) {
+        record(self.phase, self.start.elapsed().as_nanos() as u64);
+    }
+}
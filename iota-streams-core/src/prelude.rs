@@ -4,6 +4,7 @@ pub use alloc::{
         self,
         Box,
     },
+    collections::VecDeque,
     rc::{
         self,
         Rc,
@@ -29,6 +30,7 @@ pub use std::{
         self,
         Box,
     },
+    collections::VecDeque,
     rc::{
         self,
         Rc,
@@ -28,35 +28,86 @@ use crate::{
     Result,
 };
 
+// The outer state is processed word by word, byte-wise loops are left for the tails shorter than a word.
+const WORD_SIZE: usize = core::mem::size_of::<u64>();
+
+#[inline(always)]
+fn load(b: &[u8]) -> u64 {
+    let mut w = [0_u8; WORD_SIZE];
+    w.copy_from_slice(b);
+    u64::from_ne_bytes(w)
+}
+
+#[inline(always)]
+fn store(b: &mut [u8], w: u64) {
+    b.copy_from_slice(&w.to_ne_bytes());
+}
+
 fn xor(s: &mut [u8], x: &[u8]) {
-    for (si, xi) in s.iter_mut().zip(x.iter()) {
+    let mut sw = s.chunks_exact_mut(WORD_SIZE);
+    let mut xw = x.chunks_exact(WORD_SIZE);
+    for (si, xi) in (&mut sw).zip(&mut xw) {
+        store(si, load(si) ^ load(xi));
+    }
+    for (si, xi) in sw.into_remainder().iter_mut().zip(xw.remainder()) {
         *si ^= *xi;
     }
 }
 
 fn encrypt_xor(s: &mut [u8], x: &[u8], y: &mut [u8]) {
-    for (si, (xi, yi)) in s.iter_mut().zip(x.iter().zip(y.iter_mut())) {
+    let mut sw = s.chunks_exact_mut(WORD_SIZE);
+    let mut xw = x.chunks_exact(WORD_SIZE);
+    let mut yw = y.chunks_exact_mut(WORD_SIZE);
+    for (si, (xi, yi)) in (&mut sw).zip((&mut xw).zip(&mut yw)) {
+        let w = load(si) ^ load(xi);
+        store(yi, w);
+        store(si, w);
+    }
+    let tail = xw.remainder().iter().zip(yw.into_remainder());
+    for (si, (xi, yi)) in sw.into_remainder().iter_mut().zip(tail) {
         *yi = *si ^ *xi;
         *si = *yi;
     }
 }
 
 fn decrypt_xor(s: &mut [u8], y: &[u8], x: &mut [u8]) {
-    for (si, (yi, xi)) in s.iter_mut().zip(y.iter().zip(x.iter_mut())) {
+    let mut sw = s.chunks_exact_mut(WORD_SIZE);
+    let mut yw = y.chunks_exact(WORD_SIZE);
+    let mut xw = x.chunks_exact_mut(WORD_SIZE);
+    for (si, (yi, xi)) in (&mut sw).zip((&mut yw).zip(&mut xw)) {
+        store(xi, load(si) ^ load(yi));
+        si.copy_from_slice(yi);
+    }
+    let tail = yw.remainder().iter().zip(xw.into_remainder());
+    for (si, (yi, xi)) in sw.into_remainder().iter_mut().zip(tail) {
         *xi = *si ^ *yi;
         *si = *yi;
     }
 }
 
 fn encrypt_xor_mut(s: &mut [u8], x: &mut [u8]) {
-    for (si, xi) in s.iter_mut().zip(x.iter_mut()) {
+    let mut sw = s.chunks_exact_mut(WORD_SIZE);
+    let mut xw = x.chunks_exact_mut(WORD_SIZE);
+    for (si, xi) in (&mut sw).zip(&mut xw) {
+        let w = load(si) ^ load(xi);
+        store(xi, w);
+        store(si, w);
+    }
+    for (si, xi) in sw.into_remainder().iter_mut().zip(xw.into_remainder()) {
         *xi ^= *si;
         *si = *xi;
     }
 }
 
 fn decrypt_xor_mut(s: &mut [u8], y: &mut [u8]) {
-    for (si, yi) in s.iter_mut().zip(y.iter_mut()) {
+    let mut sw = s.chunks_exact_mut(WORD_SIZE);
+    let mut yw = y.chunks_exact_mut(WORD_SIZE);
+    for (si, yi) in (&mut sw).zip(&mut yw) {
+        let t = load(yi);
+        store(yi, load(si) ^ t);
+        store(si, t);
+    }
+    for (si, yi) in sw.into_remainder().iter_mut().zip(yw.into_remainder()) {
         let t = *yi;
         *yi ^= *si;
         *si = t;
@@ -64,17 +115,20 @@ fn decrypt_xor_mut(s: &mut [u8], y: &mut [u8]) {
 }
 
 fn copy(s: &[u8], y: &mut [u8]) {
-    for (si, yi) in s.iter().zip(y.iter_mut()) {
-        *yi = *si;
-    }
+    y.copy_from_slice(s);
 }
 
 fn equals(s: &[u8], x: &[u8]) -> bool {
-    let mut eq = true;
-    for (si, xi) in s.iter().zip(x.iter()) {
-        eq = (*si == *xi) && eq;
+    let mut diff = 0_u64;
+    let mut sw = s.chunks_exact(WORD_SIZE);
+    let mut xw = x.chunks_exact(WORD_SIZE);
+    for (si, xi) in (&mut sw).zip(&mut xw) {
+        diff |= load(si) ^ load(xi);
+    }
+    for (si, xi) in sw.remainder().iter().zip(xw.remainder()) {
+        diff |= u64::from(*si ^ *xi);
     }
-    eq
+    diff == 0
 }
 
 /// Sponge fixed key size in buf.
@@ -170,6 +224,8 @@ impl<F: PRP> Spongos<F> {
     }
 
     /// Squeeze vector, length is known at runtime.
+    ///
+    /// Allocates the output, message processing squeezes into its buffers with `squeeze` instead.
     pub fn squeeze_n(&mut self, n: usize) -> Vec<u8> {
         let mut v = vec![0; n];
         self.squeeze(&mut v);
@@ -212,9 +268,10 @@ impl<F: PRP> Spongos<F> {
         Ok(y)
     }
 
+    /// Encrypt into a new vector, see `squeeze_n`.
     pub fn encrypt_n(&mut self, x: impl AsRef<[u8]>) -> Result<Vec<u8>> {
-        let mut y = vec![0; x.as_ref().len()];
-        self.encrypt(x, &mut y)?;
+        let mut y = x.as_ref().to_vec();
+        self.encrypt_mut(&mut y);
         Ok(y)
     }
 
@@ -254,9 +311,10 @@ impl<F: PRP> Spongos<F> {
         Ok(x)
     }
 
+    /// Decrypt into a new vector, see `squeeze_n`.
     pub fn decrypt_n(&mut self, y: impl AsRef<[u8]>) -> Result<Vec<u8>> {
-        let mut x = vec![0; y.as_ref().len()];
-        self.decrypt(y, &mut x)?;
+        let mut x = y.as_ref().to_vec();
+        self.decrypt_mut(&mut x);
         Ok(x)
     }
 
@@ -26,6 +26,7 @@ use iota_streams_core_keccak::sponge::prp::keccak::KeccakF1600;
 
 use crate::{
     command::*,
+    io,
     types::*,
 };
 
@@ -224,6 +225,95 @@ fn bytes() {
     assert!(dbg!(absorb_mask_squeeze_bytes_mac::<KeccakF1600>()).is_ok());
 }
 
+fn wrap_growing_stream<F: PRP>() -> Result<()> {
+    let ta = Bytes([3_u8; 17].to_vec());
+    let tm = Bytes([5_u8; 33].to_vec());
+    let mut tag_sized = External(NBytes::<U32>::default());
+    let mut tag_grown = External(NBytes::<U32>::default());
+
+    let buf_size = {
+        let mut ctx = sizeof::Context::<F>::new();
+        ctx.absorb(&ta)?.mask(&tm)?.commit()?.squeeze(&tag_sized)?;
+        ctx.get_size()
+    };
+    let mut sized = vec![0_u8; buf_size];
+    {
+        let mut ctx = wrap::Context::<F, &mut [u8]>::new(&mut sized[..]);
+        ctx.absorb(&ta)?.mask(&tm)?.commit()?.squeeze(&mut tag_sized)?;
+        try_or!(ctx.stream.is_empty(), OutputStreamNotFullyConsumed(ctx.stream.len()))?;
+    }
+
+    let grown = {
+        let mut ctx = wrap::Context::<F, Vec<u8>>::new(Vec::new());
+        ctx.absorb(&ta)?.mask(&tm)?.commit()?.squeeze(&mut tag_grown)?;
+        ctx.stream
+    };
+
+    try_or!(sized.len() == grown.len(), ValueMismatch(sized.len(), grown.len()))?;
+    try_or!(
+        sized == grown,
+        InvalidBytes(Bytes(sized.clone()).to_string(), Bytes(grown.clone()).to_string())
+    )?;
+    try_or!(
+        tag_sized == tag_grown,
+        InvalidTagSqueeze(tag_sized.to_string(), tag_grown.to_string())
+    )?;
+    Ok(())
+}
+
+#[test]
+fn growing_stream() {
+    assert!(dbg!(wrap_growing_stream::<KeccakF1600>()).is_ok());
+}
+
+fn wrap_unwrap_chunked_stream<F: PRP>() -> Result<()> {
+    let ta = Bytes([3_u8; 17].to_vec());
+    let tm = Bytes([5_u8; 33].to_vec());
+    let mut uta = Bytes(Vec::new());
+    let mut utm = Bytes(Vec::new());
+    let mut tag_wrap = External(NBytes::<U32>::default());
+    let mut tag_unwrap = External(NBytes::<U32>::default());
+
+    let mut chunks = Vec::new();
+    {
+        let mut ctx = wrap::Context::<F, _>::new(io::ChunkedOStream::new(8, |chunk: &[u8]| {
+            chunks.push(chunk.to_vec());
+            Ok(())
+        }));
+        ctx.absorb(&ta)?.mask(&tm)?.commit()?.squeeze(&mut tag_wrap)?;
+        ctx.stream.finish()?;
+    }
+    try_or!(chunks.len() > 1, ValueMismatch(2, chunks.len()))?;
+
+    // Hand the bytes over 5 at a time, regardless of chunk boundaries
+    let bytes = chunks.concat();
+    let mut rest = &bytes[..];
+    let mut ctx = unwrap::Context::<F, _>::new(io::ChunkedIStream::new(8, |buf: &mut [u8]| {
+        let n = buf.len().min(rest.len()).min(5);
+        buf[..n].copy_from_slice(&rest[..n]);
+        rest = &rest[n..];
+        Ok(n)
+    }));
+    ctx.absorb(&mut uta)?
+        .mask(&mut utm)?
+        .commit()?
+        .squeeze(&mut tag_unwrap)?;
+    ctx.stream.finish()?;
+
+    try_or!(ta == uta, InvalidBytes(ta.to_string(), uta.to_string()))?;
+    try_or!(tm == utm, InvalidBytes(tm.to_string(), utm.to_string()))?;
+    try_or!(
+        tag_wrap == tag_unwrap,
+        InvalidTagSqueeze(tag_wrap.to_string(), tag_unwrap.to_string())
+    )?;
+    Ok(())
+}
+
+#[test]
+fn chunked_stream() {
+    assert!(dbg!(wrap_unwrap_chunked_stream::<KeccakF1600>()).is_ok());
+}
+
 fn absorb_ed25519<F: PRP>() -> Result<()> {
     type N = U64;
     let secret = ed25519::SecretKey::from_bytes(&[7; ed25519::SECRET_KEY_LENGTH]).unwrap();
@@ -280,6 +370,58 @@ fn test_ed25519() {
     assert!(dbg!(absorb_ed25519::<KeccakF1600>()).is_ok());
 }
 
+fn deferred_ed25519<F: PRP>() -> Result<()> {
+    let mut keys = Vec::new();
+    let mut bufs = Vec::new();
+    for i in 1..4_u8 {
+        let secret = ed25519::SecretKey::from_bytes(&[i; ed25519::SECRET_KEY_LENGTH]).unwrap();
+        let public = ed25519::PublicKey::from(&secret);
+        let kp = ed25519::Keypair { secret, public };
+        let ta = Bytes([i; 17].to_vec());
+
+        let buf_size = {
+            let mut ctx = sizeof::Context::<F>::new();
+            ctx.absorb(&ta)?.ed25519(&kp, HashSig)?;
+            ctx.get_size()
+        };
+        let mut buf = vec![0_u8; buf_size];
+        {
+            let mut ctx = wrap::Context::<F, &mut [u8]>::new(&mut buf[..]);
+            ctx.absorb(&ta)?.ed25519(&kp, HashSig)?;
+        }
+        keys.push(public);
+        bufs.push(buf);
+    }
+
+    let mut sigs = Vec::new();
+    for (pk, buf) in keys.iter().zip(bufs.iter()) {
+        let mut uta = Bytes(Vec::new());
+        let mut sig = DeferredSig::default();
+        let mut ctx = unwrap::Context::<F, &[u8]>::new(&buf[..]);
+        ctx.absorb(&mut uta)?.ed25519(pk, &mut sig)?;
+        try_or!(ctx.stream.is_empty(), InputStreamNotFullyConsumed(ctx.stream.len()))?;
+        sigs.push(sig);
+    }
+
+    let batch: Vec<_> = keys.iter().zip(sigs.iter()).collect();
+    try_or!(DeferredSig::verify_batch(&batch), SignatureMismatch)?;
+    for (pk, sig) in &batch {
+        sig.verify(pk)?;
+    }
+
+    // Swapped keys fail the batch as well as the signatures one by one.
+    let batch: Vec<_> = keys.iter().rev().zip(sigs.iter()).collect();
+    try_or!(!DeferredSig::verify_batch(&batch), SignatureMismatch)?;
+    try_or!(batch[0].1.verify(batch[0].0).is_err(), SignatureMismatch)?;
+    try_or!(batch[1].1.verify(batch[1].0).is_ok(), SignatureMismatch)?;
+    Ok(())
+}
+
+#[test]
+fn test_deferred_ed25519() {
+    assert!(dbg!(deferred_ed25519::<KeccakF1600>()).is_ok());
+}
+
 fn x25519_static<F: PRP>() -> Result<()> {
     let secret_a = x25519::StaticSecret::from([11; 32]);
     let secret_b = x25519::StaticSecret::from([13; 32]);
@@ -11,6 +11,7 @@ use crate::{
         AbsorbFallback,
         ArrayLength,
         Bytes,
+        BytesBuf,
         Fallback,
         NBytes,
         Size,
@@ -23,7 +24,11 @@ use crate::{
 use iota_streams_core::{
     err,
     sponge::prp::PRP,
-    Errors::PublicKeyGenerationFailure,
+    try_or,
+    Errors::{
+        MaxSizeExceeded,
+        PublicKeyGenerationFailure,
+    },
     Result,
 };
 use iota_streams_core_edsig::{
@@ -142,6 +147,17 @@ impl<'a, F: PRP, IS: io::IStream> Absorb<&'a mut Bytes> for Context<F, IS> {
     }
 }
 
+impl<'a, 'b, F: PRP, IS: io::IStream> Absorb<&'a mut BytesBuf<'b>> for Context<F, IS> {
+    fn absorb(&mut self, bytes: &'a mut BytesBuf<'b>) -> Result<&mut Self> {
+        let mut size = Size(0);
+        self.absorb(&mut size)?;
+        try_or!(size.0 <= bytes.buf.len(), MaxSizeExceeded(bytes.buf.len(), size.0))?;
+        unwrap_absorb_bytes(self.as_mut(), &mut bytes.buf[..size.0])?;
+        bytes.len = size.0;
+        Ok(self)
+    }
+}
+
 impl<'a, F: PRP, IS: io::IStream> Absorb<&'a mut ed25519::PublicKey> for Context<F, IS> {
     fn absorb(&mut self, pk: &'a mut ed25519::PublicKey) -> Result<&mut Self> {
         let mut pk_bytes = [0_u8; 32];
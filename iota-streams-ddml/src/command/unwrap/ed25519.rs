@@ -9,6 +9,7 @@ use crate::{
     },
     io,
     types::{
+        DeferredSig,
         External,
         HashSig,
         NBytes,
@@ -17,6 +18,8 @@ use crate::{
     },
 };
 use iota_streams_core::{
+    metrics_time,
+    prelude::Vec,
     sponge::prp::PRP,
     wrapped_err,
     Errors::SignatureMismatch,
@@ -24,20 +27,16 @@ use iota_streams_core::{
 };
 use iota_streams_core_edsig::signature::ed25519;
 
+const SIGNATURE_CONTEXT: &[u8] = b"IOTAStreams";
+
 /// Recover public key.
 impl<'a, F: PRP, IS: io::IStream> Ed25519<&'a ed25519::PublicKey, &'a External<NBytes<U64>>> for Context<F, IS> {
     fn ed25519(&mut self, pk: &'a ed25519::PublicKey, hash: &'a External<NBytes<U64>>) -> Result<&mut Self> {
-        let context = "IOTAStreams".as_bytes();
-        let mut prehashed = Prehashed::default();
-        prehashed.0.as_mut_slice().copy_from_slice((hash.0).as_slice());
-        let mut bytes = [0_u8; ed25519::SIGNATURE_LENGTH];
+        let mut signature = NBytes::<U64>::default();
         let slice = self.stream.try_advance(ed25519::SIGNATURE_LENGTH)?;
-        bytes.copy_from_slice(slice);
-        let signature = ed25519::Signature::new(bytes);
-        match pk.verify_prehashed(prehashed, Some(context), &signature) {
-            Ok(()) => Ok(self),
-            Err(e) => Err(wrapped_err!(SignatureMismatch, WrappedError(e))),
-        }
+        signature.as_mut_slice().copy_from_slice(slice);
+        verify(pk, &hash.0, &signature)?;
+        Ok(self)
     }
 }
 
@@ -47,3 +46,59 @@ impl<'a, F: PRP, IS: io::IStream> Ed25519<&'a ed25519::PublicKey, HashSig> for C
         self.commit()?.squeeze(&mut hash)?.ed25519(pk, &hash)
     }
 }
+
+/// Decode signature and keep it for later verification.
+impl<'a, F: PRP, IS: io::IStream> Ed25519<&'a ed25519::PublicKey, &'a mut DeferredSig> for Context<F, IS> {
+    fn ed25519(&mut self, _pk: &'a ed25519::PublicKey, deferred: &'a mut DeferredSig) -> Result<&mut Self> {
+        let mut hash = External(NBytes::<U64>::default());
+        self.commit()?.squeeze(&mut hash)?;
+        let slice = self.stream.try_advance(ed25519::SIGNATURE_LENGTH)?;
+        deferred.hash = hash.0;
+        deferred.signature.as_mut_slice().copy_from_slice(slice);
+        Ok(self)
+    }
+}
+
+fn verify(pk: &ed25519::PublicKey, hash: &NBytes<U64>, signature: &NBytes<U64>) -> Result<()> {
+    let mut prehashed = Prehashed::default();
+    prehashed.0.as_mut_slice().copy_from_slice(hash.as_slice());
+    let mut bytes = [0_u8; ed25519::SIGNATURE_LENGTH];
+    bytes.copy_from_slice(signature.as_slice());
+    let signature = ed25519::Signature::new(bytes);
+    let verified = metrics_time!(
+        Verify,
+        pk.verify_prehashed(prehashed, Some(SIGNATURE_CONTEXT), &signature)
+    );
+    match verified {
+        Ok(()) => Ok(()),
+        Err(e) => Err(wrapped_err!(SignatureMismatch, WrappedError(e))),
+    }
+}
+
+impl DeferredSig {
+    /// Verify the signature against the public key of the signer.
+    pub fn verify(&self, pk: &ed25519::PublicKey) -> Result<()> {
+        verify(pk, &self.hash, &self.signature)
+    }
+
+    /// Verify a batch of deferred signatures at once. Returns `true` if all of them are valid,
+    /// otherwise the signatures need to be verified one by one to find the invalid ones.
+    pub fn verify_batch(batch: &[(&ed25519::PublicKey, &DeferredSig)]) -> bool {
+        let mut hashes = Vec::with_capacity(batch.len());
+        let mut signatures = Vec::with_capacity(batch.len());
+        for (_, deferred) in batch {
+            let mut hash = [0_u8; 64];
+            let mut signature = [0_u8; ed25519::SIGNATURE_LENGTH];
+            hash.copy_from_slice(deferred.hash.as_slice());
+            signature.copy_from_slice(deferred.signature.as_slice());
+            hashes.push(hash);
+            signatures.push(ed25519::Signature::new(signature));
+        }
+        let items: Vec<_> = batch
+            .iter()
+            .zip(hashes.iter().zip(signatures.iter()))
+            .map(|((pk, _), (hash, signature))| (*pk, hash, signature))
+            .collect();
+        metrics_time!(Verify, ed25519::verify_prehashed_batch(SIGNATURE_CONTEXT, &items))
+    }
+}
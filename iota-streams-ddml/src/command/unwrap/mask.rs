@@ -11,6 +11,7 @@ use crate::{
     types::{
         ArrayLength,
         Bytes,
+        BytesBuf,
         NBytes,
         Size,
         Uint16,
@@ -21,8 +22,12 @@ use crate::{
 };
 use iota_streams_core::{
     sponge::prp::PRP,
+    try_or,
     wrapped_err,
-    Errors::PublicKeyGenerationFailure,
+    Errors::{
+        MaxSizeExceeded,
+        PublicKeyGenerationFailure,
+    },
     WrappedError,
 };
 use iota_streams_core_edsig::{
@@ -141,6 +146,17 @@ impl<'a, F: PRP, IS: io::IStream> Mask<&'a mut Bytes> for Context<F, IS> {
     }
 }
 
+impl<'a, 'b, F: PRP, IS: io::IStream> Mask<&'a mut BytesBuf<'b>> for Context<F, IS> {
+    fn mask(&mut self, bytes: &'a mut BytesBuf<'b>) -> Result<&mut Self> {
+        let mut size = Size(0);
+        self.mask(&mut size)?;
+        try_or!(size.0 <= bytes.buf.len(), MaxSizeExceeded(bytes.buf.len(), size.0))?;
+        unwrap_mask_bytes(self.as_mut(), &mut bytes.buf[..size.0])?;
+        bytes.len = size.0;
+        Ok(self)
+    }
+}
+
 impl<'a, F: PRP, IS: io::IStream> Mask<&'a mut x25519::PublicKey> for Context<F, IS> {
     fn mask(&mut self, pk: &'a mut x25519::PublicKey) -> Result<&mut Self> {
         let mut bytes = [0_u8; 32];
@@ -17,6 +17,7 @@ use crate::{
     },
 };
 use iota_streams_core::{
+    metrics_time,
     sponge::prp::PRP,
     wrapped_err,
     Errors::SignatureFailure,
@@ -30,7 +31,7 @@ impl<F: PRP, OS: io::OStream> Ed25519<&ed25519::Keypair, &External<NBytes<U64>>>
         let context = "IOTAStreams".as_bytes();
         let mut prehashed = Prehashed::default();
         prehashed.0.as_mut_slice().copy_from_slice((hash.0).as_slice());
-        match kp.sign_prehashed(prehashed, Some(&context[..])) {
+        match metrics_time!(Sign, kp.sign_prehashed(prehashed, Some(&context[..]))) {
             Ok(signature) => {
                 self.stream
                     .try_advance(ed25519::SIGNATURE_LENGTH)?
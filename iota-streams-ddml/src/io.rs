@@ -5,9 +5,11 @@ use iota_streams_core::{
     prelude::{
         hex,
         String,
+        Vec,
     },
     try_or,
     Errors::{
+        InputStreamNotFullyConsumed,
         StreamAllocationExceededIn,
         StreamAllocationExceededOut,
     },
@@ -71,6 +73,19 @@ impl<'b> OStream for &'b mut [u8] {
     }
 }
 
+/// Growable stream appending to the vector, lets a message be wrapped without sizing it first.
+impl OStream for Vec<u8> {
+    fn try_advance<'a>(&'a mut self, n: usize) -> Result<&'a mut [u8]> {
+        let len = self.len();
+        self.resize(len + n, 0);
+        Ok(&mut self[len..])
+    }
+    fn commit(&mut self) {}
+    fn dump(&self) -> String {
+        format!("{}", hex::encode(self))
+    }
+}
+
 impl<'b> IStream for &'b [u8] {
     fn try_advance<'a>(&'a mut self, n: usize) -> Result<&'a [u8]> {
         try_or!(n <= self.len(), StreamAllocationExceededIn(n, self.len()))?;
@@ -85,3 +100,124 @@ impl<'b> IStream for &'b [u8] {
         format!("{}", hex::encode(self))
     }
 }
+
+/// Output stream handing its bytes over to a sink in chunks of about `chunk_size` bytes, so that a
+/// large message is never held in memory as a whole. Call `finish` to hand over the last chunk.
+pub struct ChunkedOStream<W> {
+    sink: W,
+    buf: Vec<u8>,
+    chunk_size: usize,
+}
+
+impl<W> ChunkedOStream<W>
+where
+    W: FnMut(&[u8]) -> Result<()>,
+{
+    pub fn new(chunk_size: usize, sink: W) -> Self {
+        Self {
+            sink,
+            buf: Vec::with_capacity(chunk_size),
+            chunk_size,
+        }
+    }
+
+    fn flush(&mut self) -> Result<()> {
+        if !self.buf.is_empty() {
+            (self.sink)(&self.buf)?;
+            self.buf.clear();
+        }
+        Ok(())
+    }
+
+    /// Hand the buffered bytes over to the sink.
+    pub fn finish(mut self) -> Result<()> {
+        self.flush()
+    }
+}
+
+impl<W> OStream for ChunkedOStream<W>
+where
+    W: FnMut(&[u8]) -> Result<()>,
+{
+    fn try_advance<'a>(&'a mut self, n: usize) -> Result<&'a mut [u8]> {
+        // Chunks only grow beyond `chunk_size` for a single larger advance
+        if self.buf.len() + n > self.chunk_size {
+            self.flush()?;
+        }
+        let len = self.buf.len();
+        self.buf.resize(len + n, 0);
+        Ok(&mut self.buf[len..])
+    }
+    fn commit(&mut self) {}
+    fn dump(&self) -> String {
+        format!("{}", hex::encode(&self.buf))
+    }
+}
+
+/// Input stream pulling its bytes from a source in chunks of about `chunk_size` bytes. The source
+/// fills the buffer it is given and returns the number of bytes written, 0 once it is exhausted.
+pub struct ChunkedIStream<R> {
+    source: R,
+    buf: Vec<u8>,
+    pos: usize,
+    chunk_size: usize,
+    eof: bool,
+}
+
+impl<R> ChunkedIStream<R>
+where
+    R: FnMut(&mut [u8]) -> Result<usize>,
+{
+    pub fn new(chunk_size: usize, source: R) -> Self {
+        Self {
+            source,
+            buf: Vec::with_capacity(chunk_size),
+            pos: 0,
+            chunk_size: chunk_size.max(1),
+            eof: false,
+        }
+    }
+
+    /// Pull from the source until `n` bytes are buffered or the source is exhausted.
+    fn fill(&mut self, n: usize) -> Result<()> {
+        if self.buf.len() - self.pos >= n {
+            return Ok(());
+        }
+        self.buf.drain(..self.pos);
+        self.pos = 0;
+        while self.buf.len() < n && !self.eof {
+            let len = self.buf.len();
+            self.buf.resize(len + self.chunk_size.max(n - len), 0);
+            let read = (self.source)(&mut self.buf[len..])?;
+            self.buf.truncate(len + read);
+            self.eof = read == 0;
+        }
+        Ok(())
+    }
+
+    /// Check that the source holds no more bytes.
+    pub fn finish(mut self) -> Result<()> {
+        self.fill(1)?;
+        try_or!(
+            self.buf.len() == self.pos,
+            InputStreamNotFullyConsumed(self.buf.len() - self.pos)
+        )
+    }
+}
+
+impl<R> IStream for ChunkedIStream<R>
+where
+    R: FnMut(&mut [u8]) -> Result<usize>,
+{
+    fn try_advance<'a>(&'a mut self, n: usize) -> Result<&'a [u8]> {
+        self.fill(n)?;
+        let available = self.buf.len() - self.pos;
+        try_or!(n <= available, StreamAllocationExceededIn(n, available))?;
+        self.pos += n;
+        Ok(&self.buf[self.pos - n..self.pos])
+    }
+    fn commit(&mut self) {}
+    fn dump(&self) -> String {
+        format!("{}", hex::encode(&self.buf[self.pos..]))
+    }
+}
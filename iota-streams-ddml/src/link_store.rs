@@ -37,6 +37,16 @@ pub trait LinkStore<F, Link> {
         err!(GenericLinkNotFound)
     }
 
+    /// Lookup link in the store and return inner spongos state and associated info, as kept by
+    /// stores holding inner states without going through a `Spongos`.
+    fn lookup_inner(&self, link: &Link) -> Result<(Inner<F>, Self::Info)>
+    where
+        F: PRP,
+    {
+        let (spongos, info) = self.lookup(link)?;
+        Ok((spongos.to_inner()?, info))
+    }
+
     /// Put link into the store together with spongos state and associated info.
     ///
     /// Implementations should handle the case where link is already in the store,
@@ -58,6 +68,24 @@ pub trait LinkStore<F, Link> {
     fn iter(&self) -> Vec<(&Link, &(Inner<F>, Self::Info))>
     where
         F: PRP;
+
+    /// Number of links in the store.
+    fn len(&self) -> usize
+    where
+        F: PRP,
+    {
+        self.iter().len()
+    }
+
+    /// Check whether spongos state for the link is in the store.
+    fn contains(&self, link: &Link) -> bool {
+        self.lookup(link).is_ok()
+    }
+
+    /// Evict all links except the `window` most recently inserted ones and those selected by `retain`.
+    ///
+    /// Stores that can't tell insertion order keep all the links.
+    fn evict(&mut self, _window: usize, _retain: &dyn Fn(&Link) -> bool) {}
 }
 
 /// Empty "dummy" link store that stores no links.
@@ -96,6 +124,9 @@ impl<F, Link, Info> LinkStore<F, Link> for EmptyLinkStore<F, Link, Info> {
 pub struct SingleLinkStore<F: PRP, Link, Info>(Link, (Inner<F>, Info));
 
 impl<F: PRP, Link, Info> SingleLinkStore<F, Link, Info> {
+    pub fn new(link: Link, spongos: Inner<F>, info: Info) -> Self {
+        Self(link, (spongos, info))
+    }
     pub fn link(&self) -> &Link {
         &self.0
     }
@@ -117,6 +148,10 @@ where
         try_or!(self.link() == link, MessageLinkNotFoundInTangle(link.to_string()))?;
         Ok((self.spongos().into(), self.info().clone()))
     }
+    fn lookup_inner(&self, link: &Link) -> Result<(Inner<F>, Self::Info)> {
+        try_or!(self.link() == link, MessageLinkNotFoundInTangle(link.to_string()))?;
+        Ok((self.spongos().clone(), self.info().clone()))
+    }
     fn update(&mut self, link: &Link, spongos: Spongos<F>, info: Self::Info) -> Result<()> {
         self.0 = link.clone();
         self.1 = (spongos.into(), info);
@@ -133,13 +168,42 @@ where
     fn iter(&self) -> Vec<(&Link, &(Inner<F>, Self::Info))> {
         vec![(&self.0, &self.1)]
     }
+    fn len(&self) -> usize {
+        1
+    }
+    fn contains(&self, link: &Link) -> bool {
+        self.link() == link
+    }
 }
 
 pub struct DefaultLinkStore<F: PRP, Link, Info> {
     map: HashMap<Link, (Inner<F>, Info)>,
+    /// Links in insertion order along with their insertion number, oldest first.
+    order: Vec<(u64, Link)>,
+    /// Number of links inserted so far.
+    inserted: u64,
     _phantom: core::marker::PhantomData<F>,
 }
 
+impl<F: PRP, Link, Info> DefaultLinkStore<F, Link, Info>
+where
+    Link: Eq + hash::Hash,
+{
+    /// Number of links inserted into the store so far, including evicted and erased ones.
+    pub fn inserted(&self) -> u64 {
+        self.inserted
+    }
+
+    /// Links still in the store out of those inserted after the first `since` ones, oldest first.
+    pub fn inserted_since(&self, since: u64) -> Vec<(&Link, &(Inner<F>, Info))> {
+        let start = self.order.partition_point(|(n, _)| *n < since);
+        self.order[start..]
+            .iter()
+            .filter_map(|(_, link)| self.map.get_key_value(link))
+            .collect()
+    }
+}
+
 impl<F: PRP, Link, Info> Default for DefaultLinkStore<F, Link, Info>
 where
     Link: Eq + hash::Hash,
@@ -147,6 +211,8 @@ where
     fn default() -> Self {
         Self {
             map: HashMap::new(),
+            order: Vec::new(),
+            inserted: 0,
             _phantom: core::marker::PhantomData,
         }
     }
@@ -167,24 +233,68 @@ where
         }
     }
 
+    fn lookup_inner(&self, link: &Link) -> Result<(Inner<F>, Info)> {
+        match self.map.get(link) {
+            Some((inner, info)) => Ok((inner.clone(), info.clone())),
+            None => err!(MessageLinkNotFoundInTangle(link.to_string())),
+        }
+    }
+
     /// Try to retrieve info for the link.
     fn update(&mut self, link: &Link, spongos: Spongos<F>, info: Info) -> Result<()> {
         let inner = spongos.to_inner()?;
-        self.map.insert(link.clone(), (inner, info));
-        Ok(())
+        self.insert(link, inner, info)
     }
 
     fn insert(&mut self, link: &Link, inner: Inner<F>, info: Self::Info) -> Result<()> {
-        self.map.insert(link.clone(), (inner, info));
+        if self.map.insert(link.clone(), (inner, info)).is_none() {
+            self.order.push((self.inserted, link.clone()));
+            self.inserted += 1;
+        }
         Ok(())
     }
 
     /// Remove info for the link.
     fn erase(&mut self, link: &Link) {
-        self.map.remove(link);
+        if self.map.remove(link).is_some() {
+            self.order.retain(|(_, l)| l != link);
+        }
     }
 
+    /// Links in insertion order, oldest first, so that a store rebuilt from them evicts the same
+    /// links.
     fn iter(&self) -> Vec<(&Link, &(Inner<F>, Self::Info))> {
-        self.map.iter().collect()
+        self.order
+            .iter()
+            .filter_map(|(_, link)| self.map.get_key_value(link))
+            .collect()
+    }
+
+    fn len(&self) -> usize {
+        self.map.len()
+    }
+
+    fn contains(&self, link: &Link) -> bool {
+        self.map.contains_key(link)
+    }
+
+    fn evict(&mut self, window: usize, retain: &dyn Fn(&Link) -> bool) {
+        let mut kept = Vec::with_capacity(self.map.len());
+        let mut recent = 0;
+        while let Some((n, link)) = self.order.pop() {
+            if !self.map.contains_key(&link) {
+                continue;
+            }
+            if retain(&link) {
+                kept.push((n, link));
+            } else if recent < window {
+                recent += 1;
+                kept.push((n, link));
+            } else {
+                self.map.remove(&link);
+            }
+        }
+        kept.reverse();
+        self.order = kept;
     }
 }
@@ -47,3 +47,23 @@ impl<'a> From<&'a mut Vec<u8>> for &'a mut Bytes {
         unsafe { &mut *(v as *mut Vec<u8> as *mut Bytes) }
     }
 }
+
+/// Variable-size array of bytes unwrapped into a caller-provided buffer.
+///
+/// Unwrapping fails with `MaxSizeExceeded` if the encoded size does not fit into `buf`;
+/// on success `len` holds the number of bytes written to the front of `buf`.
+#[derive(Debug)]
+pub struct BytesBuf<'a> {
+    pub buf: &'a mut [u8],
+    pub len: usize,
+}
+
+impl<'a> BytesBuf<'a> {
+    pub fn new(buf: &'a mut [u8]) -> Self {
+        Self { buf, len: 0 }
+    }
+
+    pub fn as_slice(&self) -> &[u8] {
+        &self.buf[..self.len]
+    }
+}
@@ -1,4 +1,18 @@
+use super::{
+    NBytes,
+    U64,
+};
+
 /// Mssig command modifier, it instructs Context to squeeze external hash value, commit
 /// spongos state, sign squeezed hash and encode (without absorbing!) signature.
 #[derive(PartialEq, Eq, Copy, Clone, Debug)]
 pub struct HashSig;
+
+/// Ed25519 command modifier for unwrapping, it instructs Context to squeeze external hash value,
+/// commit spongos state and decode the signature without verifying it. The squeezed hash and
+/// the signature are kept so that they can be verified later, possibly in a batch.
+#[derive(PartialEq, Eq, Clone, Debug, Default)]
+pub struct DeferredSig {
+    pub hash: NBytes<U64>,
+    pub signature: NBytes<U64>,
+}